@@ -0,0 +1,283 @@
+/** @file bitHistogram.h
+ *  @brief Sample histogram from which bit occurrence probabilities of a
+ *         random source are derived.
+ *
+ *  @author Aashish Sheshadri
+ *  @author Rohit Harchandani
+ *
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2015, 2016, 2017 PayPal
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef BITHISTOGRAM_H
+#define BITHISTOGRAM_H
+
+// -----------------
+// standard includes
+// -----------------
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+// ------------
+// BitHistogram
+// ------------
+
+/**
+ * @class BitHistogram counts occurrences of each sample value of type T
+ *        (uint8_t or uint16_t); bit occurrence probabilities are derived
+ *        from the counts when queried.
+ */
+template <typename T>
+class BitHistogram {
+public:
+
+	// -----------
+	// Constructor
+	// -----------
+
+	/**
+	 * Constructor
+	 * @brief Creates BitHistogram object with a zeroed bin per sample value.
+	 */
+	BitHistogram();
+
+	// ---
+	// add
+	// ---
+
+	/**
+	 * @brief Records a single sample.
+	 *
+	 * @param sample T with the sample value.
+	 *
+	 * @return void
+	 */
+	void add(T sample) {
+		++_counts[sample];
+		++_samples;
+	}
+
+	/**
+	 * @brief Records a stream of samples.
+	 *
+	 * @param begin input iterator to the beginning of the sample stream.
+	 * @param end input iterator to the end of the sample stream.
+	 *
+	 * @return void
+	 */
+	template <typename II>
+	void add(II begin, II end);
+
+	// -----
+	// merge
+	// -----
+
+	/**
+	 * @brief Adds the counts of another histogram, e.g. one kept by a
+	 *        worker thread.
+	 *
+	 * @param other const reference to a BitHistogram of the same type.
+	 *
+	 * @return void
+	 */
+	void merge(const BitHistogram& other);
+
+	// -------
+	// samples
+	// -------
+
+	/**
+	 * @brief Returns number of samples recorded.
+	 *
+	 * @return uint64_t with number of samples.
+	 */
+	uint64_t samples() const {
+		return _samples;
+	}
+
+	// --------
+	// maxCount
+	// --------
+
+	/**
+	 * @brief Returns occurrences of the most common sample value.
+	 *
+	 * @return uint64_t with count of the most common value.
+	 */
+	uint64_t maxCount() const {
+		return *std::max_element(_counts.begin(), _counts.end());
+	}
+
+	// ----------------
+	// bitProbabilities
+	// ----------------
+
+	/**
+	 * @brief Computes bit occurrence probabilities of recorded samples.
+	 *
+	 * @return double vector with the probability of each bit of a sample
+	 *         being set; zeros if no samples were recorded.
+	 */
+	std::vector<double> bitProbabilities() const;
+
+	// -----
+	// reset
+	// -----
+
+	/**
+	 * @brief Discards recorded samples.
+	 *
+	 * @return void
+	 */
+	void reset();
+
+private:
+
+	// ----
+	// data
+	// ----
+	std::vector<uint64_t> _counts; // Occurrences per sample value.
+	uint64_t _samples; // Number of samples recorded.
+};
+
+// -----------
+// Constructor
+// -----------
+
+/**
+ * Constructor
+ * @brief Creates BitHistogram object with a zeroed bin per sample value.
+ */
+template <typename T>
+BitHistogram<T>::BitHistogram():
+	_counts(size_t(1) << (8 * sizeof(T)), 0),
+	_samples(0) {
+
+}
+
+// ---
+// add
+// ---
+
+/**
+ * @brief Records a stream of samples.
+ *
+ * @param begin input iterator to the beginning of the sample stream.
+ * @param end input iterator to the end of the sample stream.
+ *
+ * @return void
+ */
+template <typename T>
+template <typename II>
+void BitHistogram<T>::add(II begin, II end) {
+	uint64_t count = 0;
+
+	// Single increment per sample.
+	for (; begin != end; ++begin) {
+		++_counts[static_cast<T>(*begin)];
+		++count;
+	}
+
+	_samples += count;
+}
+
+// -----
+// merge
+// -----
+
+/**
+ * @brief Adds the counts of another histogram, e.g. one kept by a
+ *        worker thread.
+ *
+ * @param other const reference to a BitHistogram of the same type.
+ *
+ * @return void
+ */
+template <typename T>
+void BitHistogram<T>::merge(const BitHistogram& other) {
+	for (size_t value = 0; value < _counts.size(); ++value) {
+		_counts[value] += other._counts[value];
+	}
+
+	_samples += other._samples;
+}
+
+// ----------------
+// bitProbabilities
+// ----------------
+
+/**
+ * @brief Computes bit occurrence probabilities of recorded samples.
+ *
+ * @return double vector with the probability of each bit of a sample
+ *         being set; zeros if no samples were recorded.
+ */
+template <typename T>
+std::vector<double> BitHistogram<T>::bitProbabilities() const {
+	std::vector<uint64_t> bitCounts(8 * sizeof(T), 0);
+
+	// Credit the count of each observed value to its set bits.
+	for (size_t value = 0; value < _counts.size(); ++value) {
+		if (_counts[value] == 0) {
+			continue;
+		}
+
+		for (size_t bit = 0; bit < bitCounts.size(); ++bit) {
+			if ((value >> bit) & 1) {
+				bitCounts[bit] += _counts[value];
+			}
+		}
+	}
+
+	std::vector<double> probabilities(bitCounts.size(), 0.0);
+
+	if (_samples == 0) {
+		return probabilities;
+	}
+
+	// Normalize bit occurrence over samples recorded.
+	for (size_t bit = 0; bit < bitCounts.size(); ++bit) {
+		probabilities[bit] = static_cast<double>(bitCounts[bit])
+			/ static_cast<double>(_samples);
+	}
+
+	return probabilities;
+}
+
+// -----
+// reset
+// -----
+
+/**
+ * @brief Discards recorded samples.
+ *
+ * @return void
+ */
+template <typename T>
+void BitHistogram<T>::reset() {
+	std::fill(_counts.begin(), _counts.end(), 0);
+	_samples = 0;
+}
+
+#endif
@@ -0,0 +1,178 @@
+/** @file boundedQueue.h
+ *  @brief Blocking queue of bounded depth handing items between pipeline
+ *         stages with backpressure.
+ *
+ *  @author Aashish Sheshadri
+ *  @author Rohit Harchandani
+ *
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2015, 2016, 2017 PayPal
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef BOUNDEDQUEUE_H
+#define BOUNDEDQUEUE_H
+
+// -----------------
+// standard includes
+// -----------------
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <cstddef>
+#include <utility>
+
+// ------------
+// BoundedQueue
+// ------------
+
+/**
+ * @class BoundedQueue holds up to depth items of type T handed from
+ *        producer threads to consumer threads. A producer blocks while the
+ *        queue is full and a consumer while it is empty, until the queue
+ *        is closed.
+ */
+template <typename T>
+class BoundedQueue {
+public:
+
+	// -----------
+	// Constructor
+	// -----------
+
+	/**
+	 * Constructor
+	 * @brief Creates an open BoundedQueue object holding up to depth items.
+	 *
+	 * @param depth size_t with maximum number of items held (at least 1).
+	 */
+	explicit BoundedQueue(size_t depth):
+		_depth(depth > 0 ? depth : 1),
+		_closed(false) {
+
+	}
+
+	// ----
+	// push
+	// ----
+
+	/**
+	 * @brief Moves an item into the queue, waiting while it is full.
+	 *
+	 * @param item rvalue reference to the item.
+	 *
+	 * @return true, if the item was queued; false if the queue is closed.
+	 */
+	bool push(T&& item) {
+		std::unique_lock<std::mutex> lock(_mutex);
+		_notFull.wait(lock, [this] () {
+			return _closed || _items.size() < _depth;
+		});
+
+		if (_closed) {
+			return false;
+		}
+
+		_items.push_back(std::move(item));
+		lock.unlock();
+		_notEmpty.notify_one();
+
+		return true;
+	}
+
+	// ---
+	// pop
+	// ---
+
+	/**
+	 * @brief Moves the oldest item out of the queue, waiting while it is
+	 *        empty and open.
+	 *
+	 * @param item reference to hold the item.
+	 *
+	 * @return true, if an item was taken; false if the queue is closed and
+	 *         empty.
+	 */
+	bool pop(T& item) {
+		std::unique_lock<std::mutex> lock(_mutex);
+		_notEmpty.wait(lock, [this] () {
+			return _closed || !_items.empty();
+		});
+
+		if (_items.empty()) {
+			return false;
+		}
+
+		item = std::move(_items.front());
+		_items.pop_front();
+		lock.unlock();
+		_notFull.notify_one();
+
+		return true;
+	}
+
+	// -----
+	// close
+	// -----
+
+	/**
+	 * @brief Closes the queue; waiting producers fail and consumers take
+	 *        the items left before failing.
+	 *
+	 * @return void
+	 */
+	void close() {
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_closed = true;
+		}
+
+		_notFull.notify_all();
+		_notEmpty.notify_all();
+	}
+
+	// -----
+	// depth
+	// -----
+
+	/**
+	 * @brief Returns maximum number of items held.
+	 *
+	 * @return size_t with depth of the queue.
+	 */
+	size_t depth() const {
+		return _depth;
+	}
+
+private:
+
+	// ----
+	// data
+	// ----
+	const size_t _depth; // Maximum number of items held.
+	bool _closed; // Status of the queue.
+	std::deque<T> _items; // Queued items, oldest first.
+	std::mutex _mutex; // Guards _items and _closed.
+	std::condition_variable _notFull; // Signals room for an item.
+	std::condition_variable _notEmpty; // Signals an item or closing.
+};
+
+#endif
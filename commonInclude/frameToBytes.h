@@ -0,0 +1,273 @@
+/** @file frameToBytes.h
+ *  @brief Conversion of decoded frames to bytes and to noise bits of frame
+ *         differences, shared by frame sources so that captured and
+ *         replayed frames take the same path.
+ *
+ *  @author Aashish Sheshadri
+ *  @author Rohit Harchandani
+ *
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2015, 2016, 2017 PayPal
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef FRAMETOBYTES_H
+#define FRAMETOBYTES_H
+
+// -----------------
+// standard includes
+// -----------------
+#include <vector>
+#include <new>
+#include <iostream>
+#include <cstdint>
+
+// --------------------
+// third party includes
+// --------------------
+#include <opencv2/opencv.hpp>
+
+// ----------------
+// library includes
+// ----------------
+#include "bitHistogram.h"
+#include "noiseBits.h"
+
+// ----------------
+// frameBytesToData
+// ----------------
+
+/**
+ * @brief Copies consecutive sample bytes of a frame and counts each pair
+ *        of bytes as a 16bit sample, in one pass over the bytes.
+ *
+ * @param in const pointer to the first byte of the samples.
+ * @param numBytes size_t with number of bytes; a trailing odd byte is
+ *        copied but not counted.
+ * @param wideSamples bool; true if the frame holds 16bit samples, which
+ *        are then written low byte first on any host.
+ * @param out pointer to numBytes bytes to be written.
+ * @param histogram reference to a BitHistogram counting the samples.
+ *
+ * @return void
+ */
+inline void frameBytesToData(
+	const uint8_t* in,
+	size_t numBytes,
+	bool wideSamples,
+	uint8_t* out,
+	BitHistogram<uint16_t>& histogram
+) {
+	const size_t numSamples = numBytes / 2;
+
+	if (wideSamples) {
+		const uint16_t* samples = reinterpret_cast<const uint16_t*>(in);
+
+		for (size_t i = 0; i < numSamples; ++i) {
+			uint16_t sample = samples[i];
+			histogram.add(sample);
+			out[2 * i] = static_cast<uint8_t>(sample & uint16_t(0x00FF));
+			out[2 * i + 1] = static_cast<uint8_t>(sample >> 8);
+		}
+	} else {
+		for (size_t i = 0; i < numSamples; ++i) {
+			uint8_t low = in[2 * i];
+			uint8_t high = in[2 * i + 1];
+			histogram.add(static_cast<uint16_t>(low | (high << 8)));
+			out[2 * i] = low;
+			out[2 * i + 1] = high;
+		}
+	}
+
+	if (numBytes % 2 != 0) {
+		out[numBytes - 1] = in[numBytes - 1];
+	}
+}
+
+// ------------
+// frameToBytes
+// ------------
+
+/**
+ * @brief Records the samples of all channels of a decoded frame as bytes
+ *        of 16bit samples and counts them in a sample histogram. The
+ *        storage is grown once and a continuous frame is converted in a
+ *        single pass; other frames row by row.
+ *
+ * @param frame const reference to a decoded frame.
+ * @param data reference to a byte vector to be appended with the samples.
+ * @param histogram reference to a BitHistogram counting the samples.
+ *
+ * @return true, if the frame was recorded; false if it cannot be held.
+ */
+inline bool frameToBytes(
+	const cv::Mat& frame,
+	std::vector<uint8_t>& data,
+	BitHistogram<uint16_t>& histogram
+) {
+	// Compute storage required for image (all channels of all pixels).
+	const size_t rowBytes = static_cast<size_t>(frame.cols) * frame.elemSize();
+	const size_t frameBytes = rowBytes * static_cast<size_t>(frame.rows);
+
+	if (frameBytes == 0) {
+		return true;
+	}
+
+	// Check if data can be held.
+	if (data.max_size() - data.size() < frameBytes) {
+		std::cerr << "[Max Capacity] Samples discarded: " << std::endl;
+		return false;
+	}
+
+	try {
+		data.resize(data.size() + frameBytes);
+	} catch (const std::bad_alloc& ba) {
+		std::cerr << "[Memory Error] Samples discarded: " << std::endl;
+		return false;
+	}
+
+	uint8_t* out = data.data() + data.size() - frameBytes;
+	const bool wideSamples = (frame.elemSize1() == 2);
+
+	if (frame.isContinuous()) {
+		// Whole frame in one pass.
+		frameBytesToData(
+			frame.ptr<uint8_t>(0),
+			frameBytes,
+			wideSamples,
+			out,
+			histogram
+		);
+	} else {
+		for (int row = 0; row < frame.rows; ++row) {
+			frameBytesToData(
+				frame.ptr<uint8_t>(row),
+				rowBytes,
+				wideSamples,
+				out + row * rowBytes,
+				histogram
+			);
+		}
+	}
+
+	return true;
+}
+
+// -------------------
+// frameDifferenceBits
+// -------------------
+
+/**
+ * @brief Packs the low order bits of the residuals of a frame minus the
+ *        previous frame, for all channels of the pixels on a grid within
+ *        a region, and counts the packed bytes. Static scene content
+ *        cancels out; sensor noise remains in the low order bits.
+ *
+ * @param previous const reference to the previous frame.
+ * @param frame const reference to a frame of the same size and type.
+ * @param gridStep size_t; every gridStep-th row and column is used.
+ * @param region const reference to a Rect limiting the pixels used; an
+ *        empty Rect selects the whole frame.
+ * @param residuals reference to an int16 vector used as scratch space.
+ * @param packer reference to a NoiseBitPacker selecting the bits kept.
+ * @param data reference to a byte vector to be appended with packed bits.
+ * @param histogram reference to a BitHistogram counting the packed bytes.
+ *
+ * @return true, if residuals were recorded; false if the frames differ in
+ *         size or type, the region is outside the frame or the bits
+ *         cannot be held.
+ */
+inline bool frameDifferenceBits(
+	const cv::Mat& previous,
+	const cv::Mat& frame,
+	size_t gridStep,
+	const cv::Rect& region,
+	std::vector<int16_t>& residuals,
+	NoiseBitPacker& packer,
+	std::vector<uint8_t>& data,
+	BitHistogram<uint8_t>& histogram
+) {
+	if (gridStep == 0
+		|| previous.size() != frame.size()
+		|| previous.type() != frame.type()) {
+		return false;
+	}
+
+	// Limit the region to the frame.
+	const cv::Rect bounds(0, 0, frame.cols, frame.rows);
+	const cv::Rect area = (region.area() > 0) ? (region & bounds) : bounds;
+
+	if (area.area() <= 0) {
+		return false;
+	}
+
+	const int step = static_cast<int>(gridStep);
+	const size_t channels = frame.channels();
+	const size_t elemSize = frame.elemSize();
+	const bool wideSamples = (frame.elemSize1() == 2);
+
+	try {
+		residuals.clear();
+		residuals.reserve(
+			((area.height + step - 1) / step)
+			* ((area.width + step - 1) / step)
+			* channels
+		);
+
+		for (int row = area.y; row < area.y + area.height; row += step) {
+			const uint8_t* previousRow = previous.ptr<uint8_t>(row);
+			const uint8_t* frameRow = frame.ptr<uint8_t>(row);
+
+			for (int col = area.x; col < area.x + area.width; col += step) {
+				const size_t offset = col * elemSize;
+
+				if (wideSamples) {
+					const uint16_t* a =
+						reinterpret_cast<const uint16_t*>(frameRow + offset);
+					const uint16_t* b =
+						reinterpret_cast<const uint16_t*>(previousRow + offset);
+
+					for (size_t ch = 0; ch < channels; ++ch) {
+						// Residual modulo 2^16; the low order bits are kept.
+						uint16_t residual = static_cast<uint16_t>(a[ch] - b[ch]);
+						residuals.push_back(static_cast<int16_t>(residual));
+					}
+				} else {
+					for (size_t ch = 0; ch < channels; ++ch) {
+						residuals.push_back(static_cast<int16_t>(
+							frameRow[offset + ch] - previousRow[offset + ch]
+						));
+					}
+				}
+			}
+		}
+
+		// Pack noise bits of the residuals (SSE2 for 4 and 8 bits).
+		packer.pack(residuals.data(), residuals.size(), data, histogram);
+	} catch (const std::bad_alloc& ba) {
+		std::cerr << "[Memory Error] Samples discarded: " << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+#endif
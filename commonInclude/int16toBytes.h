@@ -0,0 +1,80 @@
+/** @file int16toBytes.h
+ *  @brief Conversion of 16bit audio samples to bytes, shared by audio
+ *         sources so that live and replayed samples take the same path.
+ *
+ *  @author Aashish Sheshadri
+ *  @author Rohit Harchandani
+ *
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2015, 2016, 2017 PayPal
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef INT16TOBYTES_H
+#define INT16TOBYTES_H
+
+// -----------------
+// standard includes
+// -----------------
+#include <cstdint>
+
+// ----------------
+// library includes
+// ----------------
+#include "bitHistogram.h"
+
+// ------------
+// int16toBytes
+// ------------
+
+/**
+ * @brief Copies 16bit samples to a byte stream, low byte first, and
+ *        counts them in a sample histogram.
+ *
+ * @param begin input iterator to the beginning of the int16 stream.
+ * @param end input iterator to the end of the int16 stream.
+ * @param out output iterator to record bytes from the int16 stream.
+ * @param histogram reference to a BitHistogram counting the samples.
+ *
+ * @return output iterator pointing to 1 + last byte written.
+ */
+template <typename II, typename OI>
+OI int16toBytes(II begin, II end, OI out, BitHistogram<uint16_t>& histogram) {
+
+	// Loop through int16 stream.
+	while (begin != end) {
+		uint16_t sample = static_cast<uint16_t>(*begin);
+
+		// Count sample for the bit occurrence estimate.
+		histogram.add(sample);
+
+		// Convert int16 to bytes and load them into out.
+		*out = static_cast<uint8_t>(sample & uint16_t(0x00FF));
+		++out;
+		*out = static_cast<uint8_t>((sample & uint16_t(0xFF00)) >> 8);
+		++out;
+		++begin;
+	}
+
+	return out;
+}
+
+#endif
@@ -0,0 +1,266 @@
+/** @file mappedFile.h
+ *  @brief Read-only memory mapping of a file (POSIX mmap or Windows file
+ *         mapping).
+ *
+ *  @author Aashish Sheshadri
+ *  @author Rohit Harchandani
+ *
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2015, 2016, 2017 PayPal
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+// -----------------
+// standard includes
+// -----------------
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+#if defined(_WIN32)
+	#include <windows.h>
+#else
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+// ----------
+// MappedFile
+// ----------
+
+/**
+ * @class MappedFile maps a whole file read-only into memory; the mapping
+ *        lives until close or destruction. Not copyable.
+ */
+class MappedFile {
+public:
+
+	// -----------
+	// Constructor
+	// -----------
+
+	/**
+	 * Constructor
+	 * @brief Creates MappedFile object without a mapping.
+	 */
+	MappedFile(): _data(NULL), _size(0) {}
+
+	// ----------
+	// Destructor
+	// ----------
+
+	/**
+	 * Destructor
+	 * @brief Releases the mapping, if any.
+	 */
+	~MappedFile() {
+		close();
+	}
+
+	// ----
+	// open
+	// ----
+
+	/**
+	 * @brief Maps the file at path read-only, replacing any previous
+	 *        mapping. An empty file is opened without a mapping.
+	 *
+	 * @param path const reference to a string with the file path.
+	 *
+	 * @return true, if the file was mapped.
+	 */
+	bool open(const std::string& path);
+
+	// -----
+	// close
+	// -----
+
+	/**
+	 * @brief Releases the mapping, if any.
+	 *
+	 * @return void
+	 */
+	void close();
+
+	// ----
+	// data
+	// ----
+
+	/**
+	 * @brief Returns the first byte of the mapping.
+	 *
+	 * @return const pointer to the mapped bytes; NULL if nothing is mapped.
+	 */
+	const uint8_t* data() const {
+		return _data;
+	}
+
+	// ----
+	// size
+	// ----
+
+	/**
+	 * @brief Returns the size of the mapping.
+	 *
+	 * @return size_t with number of mapped bytes.
+	 */
+	size_t size() const {
+		return _size;
+	}
+
+private:
+
+	MappedFile(const MappedFile&);
+	MappedFile& operator=(const MappedFile&);
+
+	// ----
+	// data
+	// ----
+	const uint8_t* _data; // Mapped bytes.
+	size_t _size; // Number of mapped bytes.
+};
+
+// ----
+// open
+// ----
+
+/**
+ * @brief Maps the file at path read-only, replacing any previous
+ *        mapping. An empty file is opened without a mapping.
+ *
+ * @param path const reference to a string with the file path.
+ *
+ * @return true, if the file was mapped.
+ */
+inline bool MappedFile::open(const std::string& path) {
+	close();
+
+#if defined(_WIN32)
+	HANDLE file = CreateFileA(
+		path.c_str(),
+		GENERIC_READ,
+		FILE_SHARE_READ,
+		NULL,
+		OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL,
+		NULL
+	);
+
+	if (file == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize)) {
+		CloseHandle(file);
+		return false;
+	}
+
+	if (fileSize.QuadPart == 0) {
+		CloseHandle(file);
+		return true;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	CloseHandle(file); // Mapping keeps the file open.
+
+	if (mapping == NULL) {
+		return false;
+	}
+
+	void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping); // View keeps the mapping alive.
+
+	if (view == NULL) {
+		return false;
+	}
+
+	_data = static_cast<const uint8_t*>(view);
+	_size = static_cast<size_t>(fileSize.QuadPart);
+#else
+	int fd = ::open(path.c_str(), O_RDONLY);
+
+	if (fd < 0) {
+		return false;
+	}
+
+	struct stat status;
+	if (fstat(fd, &status) != 0) {
+		::close(fd);
+		return false;
+	}
+
+	if (status.st_size == 0) {
+		::close(fd);
+		return true;
+	}
+
+	void* view = mmap(
+		NULL,
+		static_cast<size_t>(status.st_size),
+		PROT_READ,
+		MAP_PRIVATE,
+		fd,
+		0
+	);
+	::close(fd); // Mapping keeps the file open.
+
+	if (view == MAP_FAILED) {
+		return false;
+	}
+
+	_data = static_cast<const uint8_t*>(view);
+	_size = static_cast<size_t>(status.st_size);
+#endif
+
+	return true;
+}
+
+// -----
+// close
+// -----
+
+/**
+ * @brief Releases the mapping, if any.
+ *
+ * @return void
+ */
+inline void MappedFile::close() {
+	if (_data == NULL) {
+		return;
+	}
+
+#if defined(_WIN32)
+	UnmapViewOfFile(_data);
+#else
+	munmap(const_cast<uint8_t*>(_data), _size);
+#endif
+
+	_data = NULL;
+	_size = 0;
+}
+
+#endif
@@ -0,0 +1,315 @@
+/** @file noiseBits.h
+ *  @brief Extraction of low order noise bits from 16bit samples (audio
+ *         samples or frame residuals), packed densely into bytes.
+ *
+ *  @author Aashish Sheshadri
+ *  @author Rohit Harchandani
+ *
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2015, 2016, 2017 PayPal
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef NOISEBITS_H
+#define NOISEBITS_H
+
+// -----------------
+// standard includes
+// -----------------
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+	(defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define NOISEBITS_SSE2 1
+#else
+	#define NOISEBITS_SSE2 0
+#endif
+
+// ----------------
+// library includes
+// ----------------
+#include "bitHistogram.h"
+
+// --------------
+// NoiseBitPacker
+// --------------
+
+/**
+ * @class NoiseBitPacker keeps the noiseBits low order bits of each 16bit
+ *        sample (optionally of the difference of left and right channel of
+ *        each stereo frame) and packs them, least significant first, into
+ *        bytes. Bits of a partial byte are carried over to the next call.
+ */
+class NoiseBitPacker {
+public:
+
+	// ---------
+	// constants
+	// ---------
+
+	// Maximum number of low order bits kept per sample.
+	static const unsigned MAX_NOISE_BITS = 8;
+
+	// -----------
+	// Constructor
+	// -----------
+
+	/**
+	 * Constructor
+	 * @brief Creates NoiseBitPacker object.
+	 *
+	 * @param noiseBits unsigned with low order bits kept per sample,
+	 *        clamped to [1, MAX_NOISE_BITS] (default 4).
+	 * @param decorrelate bool; if true, samples are stereo frames and the
+	 *        bits of left minus right are kept, one value per frame
+	 *        (default false).
+	 */
+	explicit NoiseBitPacker(unsigned noiseBits = 4, bool decorrelate = false):
+		_noiseBits(noiseBits < 1 ? 1 : (noiseBits > 8 ? 8 : noiseBits)),
+		_decorrelate(decorrelate) {
+		reset();
+	}
+
+	// -----
+	// reset
+	// -----
+
+	/**
+	 * @brief Discards carried over bits and a pending left sample.
+	 *
+	 * @return void
+	 */
+	void reset() {
+		_accumulator = 0;
+		_pendingBits = 0;
+		_hasLeft = false;
+		_left = 0;
+	}
+
+	// ----
+	// pack
+	// ----
+
+	/**
+	 * @brief Appends the packed noise bits of numSamples samples to out and
+	 *        counts the appended bytes.
+	 *
+	 * @param samples const pointer to 16bit samples.
+	 * @param numSamples size_t with number of samples.
+	 * @param out reference to a byte vector to be appended.
+	 * @param histogram reference to a BitHistogram counting the bytes.
+	 *
+	 * @return void
+	 */
+	void pack(
+		const int16_t* samples,
+		size_t numSamples,
+		std::vector<uint8_t>& out,
+		BitHistogram<uint8_t>& histogram
+	);
+
+private:
+
+	// ----------
+	// packBlocks
+	// ----------
+
+	/**
+	 * @brief Packs whole blocks of 16 samples with SSE2 for 4 or 8 noise
+	 *        bits, if nothing is carried over.
+	 *
+	 * @param samples const pointer to 16bit samples.
+	 * @param numSamples size_t with number of samples.
+	 * @param output pointer to memory to hold the packed bytes.
+	 *
+	 * @return size_t with number of samples packed.
+	 */
+	size_t packBlocks(
+		const int16_t* samples,
+		size_t numSamples,
+		uint8_t* output
+	);
+
+	// ----
+	// data
+	// ----
+	unsigned _noiseBits; // Low order bits kept per sample.
+	bool _decorrelate; // Keep left minus right per stereo frame.
+	uint32_t _accumulator; // Bits not yet forming a byte.
+	unsigned _pendingBits; // Number of bits in _accumulator.
+	bool _hasLeft; // A left sample waits for its right sample.
+	uint16_t _left; // Pending left sample.
+};
+
+// ----
+// pack
+// ----
+
+/**
+ * @brief Appends the packed noise bits of numSamples samples to out and
+ *        counts the appended bytes.
+ *
+ * @param samples const pointer to 16bit samples.
+ * @param numSamples size_t with number of samples.
+ * @param out reference to a byte vector to be appended.
+ * @param histogram reference to a BitHistogram counting the bytes.
+ *
+ * @return void
+ */
+inline void NoiseBitPacker::pack(
+	const int16_t* samples,
+	size_t numSamples,
+	std::vector<uint8_t>& out,
+	BitHistogram<uint8_t>& histogram
+) {
+	// Room for all packed bits, including carried over ones.
+	size_t offset = out.size();
+	out.resize(offset + (numSamples * _noiseBits + _pendingBits) / 8);
+	uint8_t* output = out.data() + offset;
+
+	// Fast path for whole blocks.
+	size_t packed = packBlocks(samples, numSamples, output);
+	output += packed * _noiseBits / 8;
+
+	uint16_t mask = static_cast<uint16_t>((1u << _noiseBits) - 1);
+
+	for (size_t i = packed; i < numSamples; ++i) {
+		uint16_t value = static_cast<uint16_t>(samples[i]);
+
+		// Pair left and right sample of a frame.
+		if (_decorrelate) {
+			if (!_hasLeft) {
+				_left = value;
+				_hasLeft = true;
+				continue;
+			}
+
+			value = static_cast<uint16_t>(_left - value);
+			_hasLeft = false;
+		}
+
+		_accumulator |= static_cast<uint32_t>(value & mask) << _pendingBits;
+		_pendingBits += _noiseBits;
+
+		if (_pendingBits >= 8) {
+			*output = static_cast<uint8_t>(_accumulator & 0xFF);
+			++output;
+			_accumulator >>= 8;
+			_pendingBits -= 8;
+		}
+	}
+
+	// Drop room reserved for bits of frames still pending.
+	out.resize(output - out.data());
+
+	histogram.add(out.begin() + offset, out.end());
+}
+
+// ----------
+// packBlocks
+// ----------
+
+/**
+ * @brief Packs whole blocks of 16 samples with SSE2 for 4 or 8 noise
+ *        bits, if nothing is carried over.
+ *
+ * @param samples const pointer to 16bit samples.
+ * @param numSamples size_t with number of samples.
+ * @param output pointer to memory to hold the packed bytes.
+ *
+ * @return size_t with number of samples packed.
+ */
+inline size_t NoiseBitPacker::packBlocks(
+	const int16_t* samples,
+	size_t numSamples,
+	uint8_t* output
+) {
+#if NOISEBITS_SSE2
+	if (_decorrelate || _pendingBits != 0) {
+		return 0;
+	}
+
+	size_t numBlocks = numSamples / 16;
+
+	if (_noiseBits == 8) {
+		// Low byte of each sample.
+		const __m128i mask = _mm_set1_epi16(0x00FF);
+
+		for (size_t block = 0; block < numBlocks; ++block) {
+			const __m128i* in = reinterpret_cast<const __m128i*>(
+				samples + 16 * block
+			);
+			__m128i low = _mm_and_si128(_mm_loadu_si128(in), mask);
+			__m128i high = _mm_and_si128(_mm_loadu_si128(in + 1), mask);
+
+			_mm_storeu_si128(
+				reinterpret_cast<__m128i*>(output + 16 * block),
+				_mm_packus_epi16(low, high)
+			);
+		}
+
+		return 16 * numBlocks;
+	}
+
+	if (_noiseBits == 4) {
+		// Low nibble of each sample, even samples in the low nibble.
+		const __m128i mask = _mm_set1_epi16(0x000F);
+		const __m128i byteMask = _mm_set1_epi32(0x000000FF);
+
+		for (size_t block = 0; block < numBlocks; ++block) {
+			const __m128i* in = reinterpret_cast<const __m128i*>(
+				samples + 16 * block
+			);
+			__m128i low = _mm_and_si128(_mm_loadu_si128(in), mask);
+			__m128i high = _mm_and_si128(_mm_loadu_si128(in + 1), mask);
+
+			// Odd sample (upper half of a 32bit lane) moves to bits 4-7.
+			low = _mm_and_si128(
+				_mm_or_si128(low, _mm_srli_epi32(low, 12)),
+				byteMask
+			);
+			high = _mm_and_si128(
+				_mm_or_si128(high, _mm_srli_epi32(high, 12)),
+				byteMask
+			);
+
+			__m128i words = _mm_packs_epi32(low, high);
+			_mm_storel_epi64(
+				reinterpret_cast<__m128i*>(output + 8 * block),
+				_mm_packus_epi16(words, words)
+			);
+		}
+
+		return 16 * numBlocks;
+	}
+#else
+	(void)samples;
+	(void)numSamples;
+	(void)output;
+#endif
+
+	return 0;
+}
+
+#endif
@@ -66,6 +66,18 @@ public:
 	 *         random source. The vector holds bit occurrence probabilities.
 	 */
 	virtual std::vector<double> bitEntropy() = 0;
+
+	/**
+	 * @brief Appends entropic data to the vector byte stream, transferring
+	 *        ownership of the recorded buffer when entropicData is empty
+	 *        instead of copying it. Defaults to appendData.
+	 *
+	 * @param entropicData reference to a byte vector to be populated
+	 *        with entropic data from the random source.
+	 */
+	virtual void moveData(std::vector<uint8_t>& entropicData) {
+		appendData(entropicData);
+	}
 };
 
 #endif
\ No newline at end of file
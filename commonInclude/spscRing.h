@@ -0,0 +1,229 @@
+/** @file spscRing.h
+ *  @brief Fixed capacity, lock-free single producer single consumer ring
+ *         of samples, safe to fill from a real-time callback.
+ *
+ *  @author Aashish Sheshadri
+ *  @author Rohit Harchandani
+ *
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2015, 2016, 2017 PayPal
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SPSCRING_H
+#define SPSCRING_H
+
+// -----------------
+// standard includes
+// -----------------
+#include <vector>
+#include <atomic>
+#include <cstddef>
+#include <algorithm>
+
+// --------
+// SpscRing
+// --------
+
+/**
+ * @class SpscRing holds samples of type T handed from one producer thread
+ *        to one consumer thread. Storage is allocated once on construction;
+ *        push and pop never allocate, lock or block.
+ */
+template <typename T>
+class SpscRing {
+public:
+
+	// -----------
+	// Constructor
+	// -----------
+
+	/**
+	 * Constructor
+	 * @brief Creates SpscRing object holding at least capacity samples
+	 *        (rounded up to a power of 2).
+	 *
+	 * @param capacity size_t with minimum number of samples held.
+	 */
+	explicit SpscRing(size_t capacity);
+
+	// ----
+	// push
+	// ----
+
+	/**
+	 * @brief Copies up to count samples into the ring; samples that do not
+	 *        fit are not copied. Producer thread only.
+	 *
+	 * @param items const pointer to the samples.
+	 * @param count size_t with number of samples.
+	 *
+	 * @return size_t with number of samples copied.
+	 */
+	size_t push(const T* items, size_t count);
+
+	// ---
+	// pop
+	// ---
+
+	/**
+	 * @brief Copies up to count samples out of the ring, oldest first.
+	 *        Consumer thread only.
+	 *
+	 * @param items pointer to memory to hold count samples.
+	 * @param count size_t with maximum number of samples.
+	 *
+	 * @return size_t with number of samples copied.
+	 */
+	size_t pop(T* items, size_t count);
+
+	// ----
+	// size
+	// ----
+
+	/**
+	 * @brief Returns number of samples held; exact only if neither thread
+	 *        is active.
+	 *
+	 * @return size_t with number of samples held.
+	 */
+	size_t size() const {
+		return _head.load(std::memory_order_acquire)
+			- _tail.load(std::memory_order_acquire);
+	}
+
+	// --------
+	// capacity
+	// --------
+
+	/**
+	 * @brief Returns maximum number of samples held.
+	 *
+	 * @return size_t with capacity of the ring.
+	 */
+	size_t capacity() const {
+		return _buffer.size();
+	}
+
+private:
+
+	// ----
+	// data
+	// ----
+	std::vector<T> _buffer; // Sample storage, size a power of 2.
+	size_t _mask; // Index mask, capacity - 1.
+	std::atomic<size_t> _head; // Samples written, advanced by producer.
+	char _padding[64]; // Keeps head and tail on separate cache lines.
+	std::atomic<size_t> _tail; // Samples read, advanced by consumer.
+};
+
+// -----------
+// Constructor
+// -----------
+
+/**
+ * Constructor
+ * @brief Creates SpscRing object holding at least capacity samples
+ *        (rounded up to a power of 2).
+ *
+ * @param capacity size_t with minimum number of samples held.
+ */
+template <typename T>
+SpscRing<T>::SpscRing(size_t capacity):
+	_head(0),
+	_tail(0) {
+
+	size_t size = 1;
+	while (size < capacity) {
+		size = size << 1;
+	}
+
+	_buffer.resize(size);
+	_mask = size - 1;
+}
+
+// ----
+// push
+// ----
+
+/**
+ * @brief Copies up to count samples into the ring; samples that do not
+ *        fit are not copied. Producer thread only.
+ *
+ * @param items const pointer to the samples.
+ * @param count size_t with number of samples.
+ *
+ * @return size_t with number of samples copied.
+ */
+template <typename T>
+size_t SpscRing<T>::push(const T* items, size_t count) {
+	size_t head = _head.load(std::memory_order_relaxed);
+	size_t tail = _tail.load(std::memory_order_acquire);
+
+	// Copy only what fits into free slots.
+	count = std::min(count, _buffer.size() - (head - tail));
+
+	// Copy in up to two segments, wrapping at the end of storage.
+	size_t start = head & _mask;
+	size_t first = std::min(count, _buffer.size() - start);
+	std::copy(items, items + first, _buffer.begin() + start);
+	std::copy(items + first, items + count, _buffer.begin());
+
+	// Publish samples to the consumer.
+	_head.store(head + count, std::memory_order_release);
+
+	return count;
+}
+
+// ---
+// pop
+// ---
+
+/**
+ * @brief Copies up to count samples out of the ring, oldest first.
+ *        Consumer thread only.
+ *
+ * @param items pointer to memory to hold count samples.
+ * @param count size_t with maximum number of samples.
+ *
+ * @return size_t with number of samples copied.
+ */
+template <typename T>
+size_t SpscRing<T>::pop(T* items, size_t count) {
+	size_t tail = _tail.load(std::memory_order_relaxed);
+	size_t head = _head.load(std::memory_order_acquire);
+
+	// Copy only samples published by the producer.
+	count = std::min(count, head - tail);
+
+	// Copy out in up to two segments, wrapping at the end of storage.
+	size_t start = tail & _mask;
+	size_t first = std::min(count, _buffer.size() - start);
+	std::copy(_buffer.begin() + start, _buffer.begin() + start + first, items);
+	std::copy(_buffer.begin(), _buffer.begin() + (count - first), items + first);
+
+	// Release slots to the producer.
+	_tail.store(tail + count, std::memory_order_release);
+
+	return count;
+}
+
+#endif
@@ -38,11 +38,18 @@
 // -----------------
 #include <iterator>
 #include <sstream>
+#include <istream>
+#include <ostream>
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include <future>
 
 // --------------------
 // third party includes
 // --------------------
 #include <aes.h>
+#include <gcm.h>
 
 
 using namespace CryptoPP;
@@ -50,6 +57,19 @@ using namespace CryptoPP;
 /**
  * @class FileCryptopp tasked with encryption/decryption of data to be written
  *        or read from the filesystem.
+ *
+ *        Encrypted files are written in a versioned chunked format (STREAM
+ *        construction over AES-GCM): a header of magic "FCPP", version,
+ *        chunk size (big endian), 16 byte salt and 7 byte nonce prefix,
+ *        followed by chunks of ciphertext and tag. Chunks are encrypted with
+ *        a per file key, SHA3-256 of key and salt, under the nonce prefix,
+ *        a big endian chunk counter and a final chunk flag; the header is
+ *        authenticated with every chunk. Reordered, truncated or extended
+ *        files fail authentication. Files of the original single message
+ *        format are still read.
+ *
+ *        Chunks are independent, so with setThreads they are sealed and
+ *        opened on worker threads; output keeps file order.
  */
 class FileCryptopp {
 public:
@@ -58,6 +78,14 @@ public:
 	// constants
 	// ---------
 	static const uint8_t AESNODE_DEFAULT_KEY_LENGTH_BYTES = 32;
+	static const size_t FILECRYPTO_CHUNK_BYTES = 65536; // Plain text per chunk.
+	static const size_t FILECRYPTO_MAX_CHUNK_BYTES = 16777216; // Read bound.
+	static const size_t FILECRYPTO_TAG_BYTES = 16;
+	static const size_t FILECRYPTO_HEADER_BYTES = 32;
+	static const size_t FILECRYPTO_NONCE_BYTES = 12;
+	static const uint8_t FILECRYPTO_FORMAT_VERSION = 1;
+	static const size_t FILECRYPTO_THREAD_MIN_CHUNKS = 16; // Per worker.
+	static const std::string FILECRYPTO_MAGIC; // Leading bytes of the header.
 
 	// -----------
 	// Constructor
@@ -92,10 +120,46 @@ public:
 	 * @param ss stringstream taken by reference to be appended with data.
 	 * @param key const reference to a byte vector with the decryption key.
 	 *
-	 * @return true, if file was read sucessfully.
+	 * @return true, if file was read sucessfully; ss is appended only once
+	 *         all data is verified and is left untouched on failure.
 	 */
 	bool readFile(std::stringstream& ss, const std::vector<uint8_t>& key);
 
+	/**
+	 * @brief Maps file associated with the calling object and reads it into
+	 *        a caller buffer; if a valid decryption key is available, data
+	 *        is decrypted from the mapping straight into the buffer.
+	 *
+	 * @param data pointer to a buffer of capacity bytes.
+	 * @param capacity size_t with number of bytes available at data.
+	 * @param size reference to a size_t set to the number of bytes the
+	 *        file holds, also when capacity is too small.
+	 * @param key const reference to a byte vector with the decryption key.
+	 *
+	 * @return true, if file was read sucessfully; if decryption or
+	 *         verification fails, data[0, size) is zeroed.
+	 */
+	bool readFile(
+		uint8_t* data,
+		size_t capacity,
+		size_t& size,
+		const std::vector<uint8_t>& key
+	);
+
+	/**
+	 * @brief Maps file associated with the calling object and reads it into
+	 *        a byte vector sized to the data; if a valid decryption key is
+	 *        available, data is decrypted from the mapping straight into
+	 *        the vector.
+	 *
+	 * @param data reference to a byte vector to hold the data.
+	 * @param key const reference to a byte vector with the decryption key.
+	 *
+	 * @return true, if file was read sucessfully; if decryption or
+	 *         verification fails, data is wiped and left empty.
+	 */
+	bool readFile(std::vector<uint8_t>& data, const std::vector<uint8_t>& key);
+
 	// ---------
 	// writeFile
 	// ---------
@@ -114,51 +178,419 @@ public:
 		const std::vector<uint8_t>& key
 	);
 
+	/**
+	 * @brief Writes a buffer to file associated with the calling object. If
+	 *        a valid key is available, data is encrypted into one
+	 *        contiguous buffer, written with a single write.
+	 *
+	 * @param data const pointer to the bytes to write.
+	 * @param size size_t with number of bytes at data.
+	 * @param key const reference to a byte vector with the encryption key.
+	 *
+	 * @return true, if data was sucessfully written to file.
+	 */
+	bool writeFile(
+		const uint8_t* data,
+		size_t size,
+		const std::vector<uint8_t>& key
+	);
+
+	// ----------
+	// readStream
+	// ----------
+
+	/**
+	 * @brief Reads file associated with the calling object into a stream. If
+	 *        a valid decryption key is available, chunks are decrypted and
+	 *        verified one at a time, holding at most one chunk in memory.
+	 *        Data is written to out only once its chunk is verified; on
+	 *        failure out may hold a verified prefix of the file, which
+	 *        must be discarded.
+	 *
+	 * @param out reference to an output stream to be appended with data.
+	 * @param key const reference to a byte vector with the decryption key.
+	 *
+	 * @return true, if the whole file was read and verified.
+	 */
+	bool readStream(std::ostream& out, const std::vector<uint8_t>& key);
+
+	// -----------
+	// writeStream
+	// -----------
+
+	/**
+	 * @brief Writes a stream to file associated with the calling object. If
+	 *        a valid key is available, data is encrypted in chunks of
+	 *        FILECRYPTO_CHUNK_BYTES as it is read, holding at most one chunk
+	 *        in memory.
+	 *
+	 * @param in reference to an input stream read until its end.
+	 * @param key const reference to a byte vector with the encryption key.
+	 *
+	 * @return true, if data was sucessfully written to file.
+	 */
+	bool writeStream(std::istream& in, const std::vector<uint8_t>& key);
+
+	// ----------
+	// setThreads
+	// ----------
+
+	/**
+	 * @brief Sets the number of threads encrypting and decrypting chunks.
+	 *        Buffers are split into ranges of chunks, at least
+	 *        FILECRYPTO_THREAD_MIN_CHUNKS per thread; streams are read
+	 *        ahead by the calling thread while workers process chunks and
+	 *        a writer thread emits them in order, holding about two chunks
+	 *        per thread in memory.
+	 *
+	 * @param numThreads size_t with number of threads; 0 uses the hardware
+	 *        concurrency (default 1, no worker threads).
+	 *
+	 * @return void
+	 */
+	void setThreads(size_t numThreads);
+
 private:
 
-	// -------
-	// encrypt
-	// -------
+	// --------
+	// ChunkJob
+	// --------
+
+	// Chunk handed from the reader to a worker and, in order, to the writer.
+	struct ChunkJob {
+		uint32_t counter;
+		bool final;
+		bool valid;
+		std::vector<uint8_t> input;
+		std::vector<uint8_t> output;
+		std::promise<void> processed;
+		std::future<void> ready;
+	};
+
+	// -----------
+	// workerCount
+	// -----------
+
+	/**
+	 * @brief Resolves the number of threads for a number of chunks.
+	 *
+	 * @param chunks size_t with number of chunks to process.
+	 *
+	 * @return size_t with number of threads, at least 1.
+	 */
+	size_t workerCount(size_t chunks) const;
+
+	// ---------
+	// runChunks
+	// ---------
+
+	/**
+	 * @brief Splits chunk indices [0, chunks) into ranges processed on
+	 *        worker threads and the calling thread.
+	 *
+	 * @param chunks size_t with number of chunks.
+	 * @param process const reference to a function processing chunks
+	 *        [begin, end); returns false on failure.
+	 *
+	 * @return true, if every range was processed.
+	 */
+	bool runChunks(
+		size_t chunks,
+		const std::function<bool(size_t, size_t)>& process
+	) const;
+
+	// ----------
+	// pipeChunks
+	// ----------
+
+	/**
+	 * @brief Streams chunks from in to out through worker threads: the
+	 *        calling thread reads ahead, workers seal or open chunks and a
+	 *        writer thread writes them in order, stopping at the first
+	 *        chunk that fails.
+	 *
+	 * @param in reference to an input stream positioned at the first chunk.
+	 * @param out reference to an output stream.
+	 * @param header const pointer to FILECRYPTO_HEADER_BYTES header bytes.
+	 * @param fileKey const reference to a byte vector with the file key.
+	 * @param encrypting bool, true to seal plain text, false to open chunks.
+	 * @param numThreads size_t with number of worker threads.
+	 *
+	 * @return int with value 1 if every chunk was processed, 0 on failure
+	 *         and -1 if no threads could be started (nothing was read).
+	 */
+	int pipeChunks(
+		std::istream& in,
+		std::ostream& out,
+		const uint8_t* header,
+		const std::vector<uint8_t>& fileKey,
+		bool encrypting,
+		size_t numThreads
+	);
+
+	// -------------
+	// encryptChunks
+	// -------------
+
+	/**
+	 * @brief Encrypts data in the chunked format into one buffer.
+	 *
+	 * @param data const pointer to the plain text.
+	 * @param size size_t with number of plain text bytes.
+	 * @param sealed pointer to sealedSize(size) bytes to fill.
+	 * @param key const reference to a byte vector with an encryption key.
+	 *
+	 * @return true, if encryption is successful.
+	 */
+	bool encryptChunks(
+		const uint8_t* data,
+		size_t size,
+		uint8_t* sealed,
+		const std::vector<uint8_t>& key
+	);
 
 	/**
-	 * @brief Encrypts input string stream using AES in GCM mode for
-	 *        confidentiality and authenticity.
+	 * @brief Writes a stream encrypted in the chunked format to out.
 	 *
-	 * @param message const reference to a string stream with data.
-	 * @param cipherData reference to a byte vector to hold encrypted data.
+	 * @param in reference to an input stream read until its end.
+	 * @param out reference to an output stream to hold encrypted data.
 	 * @param key const reference to a byte vector with an encryption key.
 	 *
 	 * @return true, if encryption is successful.
 	 */
-	bool encrypt(
-		const std::stringstream& message,
-		std::vector<uint8_t>& cipherData,
+	bool encryptChunks(
+		std::istream& in,
+		std::ostream& out,
+		const std::vector<uint8_t>& key
+	);
+
+	// -------------
+	// decryptChunks
+	// -------------
+
+	/**
+	 * @brief Decrypts and verifies chunks following a header already read
+	 *        from in, writing each verified chunk to out.
+	 *
+	 * @param in reference to an input stream positioned after the header.
+	 * @param header const pointer to FILECRYPTO_HEADER_BYTES header bytes.
+	 * @param out reference to an output stream to hold decrypted data.
+	 * @param key const reference to a byte vector with the decryption key.
+	 *
+	 * @return true, if every chunk up to the final chunk is verified.
+	 */
+	bool decryptChunks(
+		std::istream& in,
+		const uint8_t* header,
+		std::ostream& out,
 		const std::vector<uint8_t>& key
 	);
 
+	/**
+	 * @brief Decrypts and verifies a whole chunked file held in memory into
+	 *        one buffer.
+	 *
+	 * @param file const pointer to the file bytes, starting with the header.
+	 * @param fileSize size_t with number of file bytes.
+	 * @param data pointer to the plain text size of the file bytes to fill.
+	 * @param key const reference to a byte vector with the decryption key.
+	 *
+	 * @return true, if every chunk is verified; otherwise data is zeroed.
+	 */
+	bool decryptChunks(
+		const uint8_t* file,
+		size_t fileSize,
+		uint8_t* data,
+		const std::vector<uint8_t>& key
+	);
+
+	// ----------
+	// sealedSize
+	// ----------
+
+	/**
+	 * @brief Returns the size of a chunked file holding size bytes.
+	 *
+	 * @param size size_t with number of plain text bytes.
+	 *
+	 * @return size_t with number of file bytes, header and tags included.
+	 */
+	static size_t sealedSize(size_t size);
+
+	// -----------
+	// chunkLayout
+	// -----------
+
+	/**
+	 * @brief Splits a chunked file of fileSize bytes into chunks as written.
+	 *
+	 * @param header const pointer to FILECRYPTO_HEADER_BYTES header bytes.
+	 * @param fileSize size_t with number of file bytes, header included.
+	 * @param chunks reference to a size_t set to the number of chunks.
+	 * @param size reference to a size_t set to the plain text bytes.
+	 *
+	 * @return true, if the header is supported and fileSize is a possible
+	 *         size of a file in its format.
+	 */
+	static bool chunkLayout(
+		const uint8_t* header,
+		size_t fileSize,
+		size_t& chunks,
+		size_t& size
+	);
+
+	// -----------
+	// chunkHeader
+	// -----------
+
+	/**
+	 * @brief Fills a header for a new file with a fresh random salt and
+	 *        nonce prefix.
+	 *
+	 * @param header pointer to FILECRYPTO_HEADER_BYTES bytes to fill.
+	 * @param chunkBytes size_t with plain text bytes per chunk.
+	 *
+	 * @return void
+	 */
+	static void chunkHeader(uint8_t* header, size_t chunkBytes);
+
+	// ----------
+	// chunkBytes
+	// ----------
+
+	/**
+	 * @brief Parses and validates the chunk size of a header.
+	 *
+	 * @param header const pointer to FILECRYPTO_HEADER_BYTES header bytes.
+	 *
+	 * @return size_t with plain text bytes per chunk; 0 if the header is not
+	 *         of a supported version or the chunk size is out of range.
+	 */
+	static size_t chunkBytes(const uint8_t* header);
+
+	// --------
+	// chunkKey
+	// --------
+
+	/**
+	 * @brief Derives the per file key, SHA3-256 of key and header salt.
+	 *
+	 * @param key const reference to a byte vector with the file key.
+	 * @param header const pointer to FILECRYPTO_HEADER_BYTES header bytes.
+	 * @param fileKey reference to a byte vector to hold the derived key.
+	 *
+	 * @return void
+	 */
+	static void chunkKey(
+		const std::vector<uint8_t>& key,
+		const uint8_t* header,
+		std::vector<uint8_t>& fileKey
+	);
+
+	// ----------
+	// chunkNonce
+	// ----------
+
+	/**
+	 * @brief Builds the nonce of a chunk: header nonce prefix, big endian
+	 *        counter and final chunk flag.
+	 *
+	 * @param header const pointer to FILECRYPTO_HEADER_BYTES header bytes.
+	 * @param counter uint32_t with index of the chunk.
+	 * @param final bool, true for the last chunk of the file.
+	 * @param nonce pointer to FILECRYPTO_NONCE_BYTES bytes to fill.
+	 *
+	 * @return void
+	 */
+	static void chunkNonce(
+		const uint8_t* header,
+		uint32_t counter,
+		bool final,
+		uint8_t* nonce
+	);
+
+	// ---------
+	// sealChunk
+	// ---------
+
+	/**
+	 * @brief Encrypts one chunk; writes ciphertext followed by its tag.
+	 *
+	 * @param e reference to a keyed AES-GCM encryption object.
+	 * @param header const pointer to FILECRYPTO_HEADER_BYTES header bytes.
+	 * @param counter uint32_t with index of the chunk.
+	 * @param final bool, true for the last chunk of the file.
+	 * @param plain const pointer to the chunk's plain text.
+	 * @param size size_t with number of plain text bytes.
+	 * @param sealed pointer to size + FILECRYPTO_TAG_BYTES bytes to fill.
+	 *
+	 * @return void
+	 */
+	static void sealChunk(
+		CryptoPP::GCM<AES>::Encryption& e,
+		const uint8_t* header,
+		uint32_t counter,
+		bool final,
+		const uint8_t* plain,
+		size_t size,
+		uint8_t* sealed
+	);
+
+	// ---------
+	// openChunk
+	// ---------
+
+	/**
+	 * @brief Decrypts and verifies one chunk of ciphertext followed by its
+	 *        tag.
+	 *
+	 * @param d reference to a keyed AES-GCM decryption object.
+	 * @param header const pointer to FILECRYPTO_HEADER_BYTES header bytes.
+	 * @param counter uint32_t with index of the chunk.
+	 * @param final bool, true for the last chunk of the file.
+	 * @param sealed const pointer to the chunk's ciphertext and tag.
+	 * @param size size_t with number of sealed bytes, including the tag.
+	 * @param plain pointer to size - FILECRYPTO_TAG_BYTES bytes to fill.
+	 *
+	 * @return true, if the chunk is authentic.
+	 */
+	static bool openChunk(
+		CryptoPP::GCM<AES>::Decryption& d,
+		const uint8_t* header,
+		uint32_t counter,
+		bool final,
+		const uint8_t* sealed,
+		size_t size,
+		uint8_t* plain
+	);
+
 	// -------
 	// decrypt
 	// -------
 
 	/**
-	 * @brief Decrypts input string stream using AES in GCM mode for
-	 *        confidentiality and authenticity.
+	 * @brief Decrypts a file of the original single message format using
+	 *        AES in GCM mode for confidentiality and authenticity.
 	 *
-	 * @param cipher const reference to a byte vector with encrypted data.
-	 * @param messageData reference to a byte vector to hold decrypted data.
+	 * @param cipher const pointer to the encrypted data followed by its tag.
+	 * @param size size_t with number of bytes at cipher, tag included.
+	 * @param message pointer to size - FILECRYPTO_TAG_BYTES bytes to fill.
 	 * @param key const reference to a byte vector with the decryption key.
 	 *
 	 * @return true, if decryption is successful.
 	 */
 	bool decrypt(
-		const std::vector<uint8_t>& cipher,
-		std::vector<uint8_t>& messageData,
+		const uint8_t* cipher,
+		size_t size,
+		uint8_t* message,
 		const std::vector<uint8_t>& key
 	);
+
 	// ----
 	// data
 	// ----
 	std::string _filename;
+	size_t _threads; // Threads processing chunks; 0 for hardware concurrency.
 
 };
 
@@ -34,6 +34,12 @@
 #include <cmath>
 #include <fstream>
 #include <vector>
+#include <algorithm>
+#include <limits>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <system_error>
 
 // --------------------
 // third party includes
@@ -44,11 +50,16 @@
 #include <filters.h>
 #include <hex.h>
 #include <gcm.h>
+#include <osrng.h>
 
 // ----------------
 // library includes
 // ----------------
 #include "fileCryptopp.h"
+#include "mappedFile.h"
+#include "boundedQueue.h"
+
+const std::string FileCryptopp::FILECRYPTO_MAGIC = "FCPP";
 
 // -----------
 // Constructor
@@ -59,7 +70,9 @@
  *
  * @param filename const reference to a string with the file name.
  */
-FileCryptopp::FileCryptopp(const std::string& filename): _filename(filename) {
+FileCryptopp::FileCryptopp(const std::string& filename):
+    _filename(filename),
+    _threads(1) {
 
 }
 
@@ -98,12 +111,267 @@ bool FileCryptopp::fileExists() {
  * @param ss stringstream taken by reference to be appended with data.
  * @param key const reference to a byte vector with the decryption key.
  *
- * @return true, if file was read sucessfully.
+ * @return true, if file was read sucessfully; ss is appended only once
+ *         all data is verified and is left untouched on failure.
  */
 bool FileCryptopp::readFile(
     std::stringstream& ss,
     const std::vector<uint8_t>& key
 ) {
+    std::vector<uint8_t> data;
+
+    // Decrypt and verify everything before any of it reaches ss.
+    if (!readFile(data, key)) {
+        return false;
+    }
+
+    ss.write(reinterpret_cast<const char*>(data.data()), data.size());
+
+    // Wipe the plaintext copy.
+    std::fill(data.begin(), data.end(), 0);
+
+    return static_cast<bool>(ss);
+}
+
+/**
+ * @brief Maps file associated with the calling object and reads it into
+ *        a caller buffer; if a valid decryption key is available, data
+ *        is decrypted from the mapping straight into the buffer.
+ *
+ * @param data pointer to a buffer of capacity bytes.
+ * @param capacity size_t with number of bytes available at data.
+ * @param size reference to a size_t set to the number of bytes the
+ *        file holds, also when capacity is too small.
+ * @param key const reference to a byte vector with the decryption key.
+ *
+ * @return true, if file was read sucessfully; if decryption or
+ *         verification fails, data[0, size) is zeroed.
+ */
+bool FileCryptopp::readFile(
+    uint8_t* data,
+    size_t capacity,
+    size_t& size,
+    const std::vector<uint8_t>& key
+) {
+
+    // Check if decryption key has length equal to default AES key length.
+    if (!key.empty() && key.size() != AESNODE_DEFAULT_KEY_LENGTH_BYTES) {
+        // Invalid key.
+        std::cout << "Invalid key length";
+        return false;
+    }
+
+    MappedFile file;
+
+    if (!file.open(_filename)) {
+        return false;
+    }
+
+    const uint8_t* bytes = file.data();
+    size_t fileSize = file.size();
+
+    // Copy file as is without a decryption key.
+    if (key.empty()) {
+        size = fileSize;
+
+        if (capacity < size) {
+            return false;
+        }
+
+        std::copy(bytes, bytes + fileSize, data);
+        return true;
+    }
+
+    // Decrypt chunked format.
+    if (fileSize >= FILECRYPTO_HEADER_BYTES
+        && std::equal(
+            FILECRYPTO_MAGIC.begin(),
+            FILECRYPTO_MAGIC.end(),
+            reinterpret_cast<const char*>(bytes)
+        )
+    ) {
+        size_t chunks = 0;
+
+        if (!chunkLayout(bytes, fileSize, chunks, size)) {
+            std::cerr << "Error decrypting file: truncated or unsupported"
+                << std::endl;
+            return false;
+        }
+
+        if (capacity < size) {
+            return false;
+        }
+
+        // Chunks are decrypted before they are verified; wipe on failure.
+        if (!decryptChunks(bytes, fileSize, data, key)) {
+            std::fill(data, data + size, 0);
+            return false;
+        }
+
+        return true;
+    }
+
+    // Decrypt original single message format.
+    if (fileSize < FILECRYPTO_TAG_BYTES) {
+        std::cerr << "Error decrypting file: truncated" << std::endl;
+        return false;
+    }
+
+    size = fileSize - FILECRYPTO_TAG_BYTES;
+
+    if (capacity < size) {
+        return false;
+    }
+
+    // Message is decrypted before it is verified; wipe on failure.
+    if (!decrypt(bytes, fileSize, data, key)) {
+        std::fill(data, data + size, 0);
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Maps file associated with the calling object and reads it into
+ *        a byte vector sized to the data; if a valid decryption key is
+ *        available, data is decrypted from the mapping straight into
+ *        the vector.
+ *
+ * @param data reference to a byte vector to hold the data.
+ * @param key const reference to a byte vector with the decryption key.
+ *
+ * @return true, if file was read sucessfully; if decryption or
+ *         verification fails, data is wiped and left empty.
+ */
+bool FileCryptopp::readFile(
+    std::vector<uint8_t>& data,
+    const std::vector<uint8_t>& key
+) {
+    size_t size = 0;
+
+    // Learn the size, then read into storage of that size.
+    if (readFile(data.data(), 0, size, key)) {
+        data.clear();
+        return true;
+    }
+
+    if (size == 0) {
+        return false;
+    }
+
+    data.resize(size);
+
+    if (!readFile(data.data(), data.size(), size, key)) {
+        std::fill(data.begin(), data.end(), 0);
+        data.clear();
+        return false;
+    }
+
+    data.resize(size);
+    return true;
+}
+
+// ---------
+// writeFile
+// ---------
+
+/**
+ * @brief Writes to file associated with the calling object. If a valid key
+ *        is available, data is encrypted (AES-GCM) prior to writing.
+ *
+ * @param ss const reference to a string stream with data.
+ * @param key const reference to a byte vector with the encryption key.
+ *
+ * @return true, if data was sucessfully written to file.
+ */
+bool FileCryptopp::writeFile(
+    const std::stringstream& ss,
+    const std::vector<uint8_t>& key
+) {
+    std::string message = ss.str(); // store message
+
+    return writeFile(
+        reinterpret_cast<const uint8_t*>(message.data()),
+        message.size(),
+        key
+    );
+}
+
+/**
+ * @brief Writes a buffer to file associated with the calling object. If
+ *        a valid key is available, data is encrypted into one
+ *        contiguous buffer, written with a single write.
+ *
+ * @param data const pointer to the bytes to write.
+ * @param size size_t with number of bytes at data.
+ * @param key const reference to a byte vector with the encryption key.
+ *
+ * @return true, if data was sucessfully written to file.
+ */
+bool FileCryptopp::writeFile(
+    const uint8_t* data,
+    size_t size,
+    const std::vector<uint8_t>& key
+) {
+
+    // Check if encryption key has length equal to default AES key length.
+    if (!key.empty() && key.size() != AESNODE_DEFAULT_KEY_LENGTH_BYTES) {
+        // Invalid key.
+        std::cout << "Invalid key length";
+        return false;
+    }
+
+    std::vector<uint8_t> sealed; // encrypted file, header and tags included
+
+    if (!key.empty()) {
+        sealed.resize(sealedSize(size));
+
+        // Attempt to encrypt data into sealed.
+        if (!encryptChunks(data, size, sealed.data(), key)) {
+            // Failed encryption.
+            return false;
+        }
+
+        data = sealed.data();
+        size = sealed.size();
+    }
+
+    // Start a file stream.
+    std::ofstream fileStream(_filename, std::ios::binary);
+
+    // Check if file stream is open.
+    if (!fileStream.is_open()) {
+        return false;
+    }
+
+    fileStream.write(reinterpret_cast<const char*>(data), size);
+
+    fileStream.close();
+    return !fileStream.fail();
+}
+
+// ----------
+// readStream
+// ----------
+
+/**
+ * @brief Reads file associated with the calling object into a stream. If
+ *        a valid decryption key is available, chunks are decrypted and
+ *        verified one at a time, holding at most one chunk in memory.
+ *        Data is written to out only once its chunk is verified; on
+ *        failure out may hold a verified prefix of the file, which
+ *        must be discarded.
+ *
+ * @param out reference to an output stream to be appended with data.
+ * @param key const reference to a byte vector with the decryption key.
+ *
+ * @return true, if the whole file was read and verified.
+ */
+bool FileCryptopp::readStream(
+    std::ostream& out,
+    const std::vector<uint8_t>& key
+) {
 
     // Start a file stream.
     std::ifstream fileStream(_filename, std::ios::binary);
@@ -116,11 +384,11 @@ bool FileCryptopp::readFile(
 
     // Check if decryption key is provided.
     if (key.empty()) {
-        // Copy file stream as is to string stream ss.
+        // Copy file stream as is to out.
         std::copy(
             std::istreambuf_iterator<char>(fileStream),
             std::istreambuf_iterator<char>(),
-            std::ostreambuf_iterator<char>(ss)
+            std::ostreambuf_iterator<char>(out)
         );
         return true;
     }
@@ -132,58 +400,72 @@ bool FileCryptopp::readFile(
         return false;
     }
 
-    // Get size of file.
-    fileStream.seekg(0, std::ios::end);
-    size_t fileSize = fileStream.tellg();
-    fileStream.seekg(0, std::ios::beg);
+    // Read the header of the chunked format.
+    uint8_t header[FILECRYPTO_HEADER_BYTES];
+    fileStream.read(reinterpret_cast<char*>(header), FILECRYPTO_HEADER_BYTES);
 
-    std::vector<uint8_t> encryptedBytes;
-    encryptedBytes.reserve(fileSize);
+    if (fileStream.gcount() == FILECRYPTO_HEADER_BYTES
+        && std::equal(
+            FILECRYPTO_MAGIC.begin(),
+            FILECRYPTO_MAGIC.end(),
+            reinterpret_cast<const char*>(header)
+        )
+    ) {
+        return decryptChunks(fileStream, header, out, key);
+    }
 
-    std::copy(
-        std::istream_iterator<uint8_t>(fileStream),
-        std::istream_iterator<uint8_t>(),
-        std::back_inserter(encryptedBytes)
-    );
+    // Not chunked; map and read the original single message format.
+    fileStream.close();
 
-    std::vector<uint8_t> messageData; // vector to hold plain text as bytes
+    MappedFile file;
 
-    // Attempt to decrypt and load decrypted bytes into cipherData.
-	if (!decrypt(encryptedBytes, messageData, key)) {
-        // Failed decryption.
+    if (!file.open(_filename) || file.size() < FILECRYPTO_TAG_BYTES) {
         return false;
     }
 
-    // Loop through cipherData bytes and convert to chars for ss.
-    for (auto it = messageData.begin(); it != messageData.end(); ++it) {
-        // Load char bytes into string stream ss.
-        ss << static_cast<char>(*it);
+    std::vector<uint8_t> messageData(file.size() - FILECRYPTO_TAG_BYTES);
+
+    // Attempt to decrypt and load decrypted bytes into messageData.
+    if (!decrypt(file.data(), file.size(), messageData.data(), key)) {
+        // Failed decryption.
+        return false;
     }
 
-    // Close file stream.
-    fileStream.close();
+    out.write(
+        reinterpret_cast<const char*>(messageData.data()),
+        messageData.size()
+    );
 
-	return true;
+    return out.good();
 }
 
-// ---------
-// writeFile
-// ---------
+// -----------
+// writeStream
+// -----------
 
 /**
- * @brief Writes to file associated with the calling object. If a valid key
- *        is available, data is encrypted (AES-GCM) prior to writing.
+ * @brief Writes a stream to file associated with the calling object. If
+ *        a valid key is available, data is encrypted in chunks of
+ *        FILECRYPTO_CHUNK_BYTES as it is read, holding at most one chunk
+ *        in memory.
  *
- * @param ss const reference to a string stream with data.
+ * @param in reference to an input stream read until its end.
  * @param key const reference to a byte vector with the encryption key.
  *
  * @return true, if data was sucessfully written to file.
  */
-bool FileCryptopp::writeFile(
-    const std::stringstream& ss,
+bool FileCryptopp::writeStream(
+    std::istream& in,
     const std::vector<uint8_t>& key
 ) {
 
+    // Check if encryption key has length equal to default AES key length.
+    if (!key.empty() && key.size() != AESNODE_DEFAULT_KEY_LENGTH_BYTES) {
+        // Invalid key.
+        std::cout << "Invalid key length";
+        return false;
+    }
+
     // Start a file stream.
     std::ofstream fileStream(_filename, std::ios::binary);
 
@@ -192,82 +474,195 @@ bool FileCryptopp::writeFile(
         return false;
     }
 
-    // Initialize an ostream_iterator to write to the file stream.
-    std::ostream_iterator<uint8_t> oit(fileStream);
+    if (key.empty()) {
+        // Copy stream as is to file.
+        std::copy(
+            std::istreambuf_iterator<char>(in),
+            std::istreambuf_iterator<char>(),
+            std::ostreambuf_iterator<char>(fileStream)
+        );
+    } else if (!encryptChunks(in, fileStream, key)) {
+        // Failed encryption.
+        return false;
+    }
 
-    // Check if encyption key is provided.
-    if (!key.empty()) {
-        // Check if encryption key has length equal to default AES key length.
-        if (key.size() != FileCryptopp::AESNODE_DEFAULT_KEY_LENGTH_BYTES) {
-            // Invalid key.
-            std::cout << "Invalid key length";
-            return false;
-        }
+    fileStream.close();
+    return !fileStream.fail();
+}
 
-        // Vector to store encrypted bytes of data.
-        std::vector<uint8_t> cipherData;
+// ----------
+// setThreads
+// ----------
 
-        // Attempt to encrypt input stream ss and load bytes into cipherData.
-        if (!encrypt(ss, cipherData, key)) {
-            // Failed encryption.
+/**
+ * @brief Sets the number of threads encrypting and decrypting chunks.
+ *        Buffers are split into ranges of chunks, at least
+ *        FILECRYPTO_THREAD_MIN_CHUNKS per thread; streams are read
+ *        ahead by the calling thread while workers process chunks and
+ *        a writer thread emits them in order, holding about two chunks
+ *        per thread in memory.
+ *
+ * @param numThreads size_t with number of threads; 0 uses the hardware
+ *        concurrency (default 1, no worker threads).
+ *
+ * @return void
+ */
+void FileCryptopp::setThreads(size_t numThreads) {
+    _threads = numThreads;
+}
+
+// -------------
+// encryptChunks
+// -------------
+
+/**
+ * @brief Encrypts data in the chunked format into one buffer.
+ *
+ * @param data const pointer to the plain text.
+ * @param size size_t with number of plain text bytes.
+ * @param sealed pointer to sealedSize(size) bytes to fill.
+ * @param key const reference to a byte vector with an encryption key.
+ *
+ * @return true, if encryption is successful.
+ */
+bool FileCryptopp::encryptChunks(
+    const uint8_t* data,
+    size_t size,
+    uint8_t* sealed,
+    const std::vector<uint8_t>& key
+) {
+
+    size_t chunk = FILECRYPTO_CHUNK_BYTES;
+    size_t tagBytes = FILECRYPTO_TAG_BYTES;
+
+    // Check that the chunk counter cannot wrap.
+    if (size / chunk >= std::numeric_limits<uint32_t>::max()) {
+        std::cerr << "Error encrypting file: too large" << std::endl;
+        return false;
+    }
+
+    std::vector<uint8_t> fileKey;
+
+    try {
+        chunkHeader(sealed, chunk);
+        chunkKey(key, sealed, fileKey);
+    } catch (const CryptoPP::Exception& e) {
+        // Failed Encryption.
+        std::cerr << "Error encrypting file: " << e.what() << std::endl;
+        return false;
+    }
+
+    // An empty message is one empty final chunk.
+    size_t chunks = size == 0 ? 1 : (size + chunk - 1) / chunk;
+
+    // Seal ranges of chunks, each thread with its own cipher.
+    return runChunks(chunks, [&] (size_t begin, size_t end) {
+        try {
+            CryptoPP::GCM<AES>::Encryption e;
+            e.SetKey(fileKey.data(), fileKey.size());
+
+            for (size_t i = begin; i < end; ++i) {
+                size_t offset = i * chunk;
+                size_t length = std::min(chunk, size - offset);
+                uint8_t* next = sealed + FILECRYPTO_HEADER_BYTES
+                    + i * (chunk + tagBytes);
+
+                sealChunk(
+                    e,
+                    sealed,
+                    static_cast<uint32_t>(i),
+                    i + 1 == chunks,
+                    data + offset,
+                    length,
+                    next
+                );
+            }
+        } catch (const CryptoPP::Exception& e) {
+            // Failed Encryption.
+            std::cerr << "Error encrypting file: " << e.what() << std::endl;
             return false;
         }
-        // Write encrypted bytes from cipherData to file as chars.
-        std::copy(cipherData.begin(), cipherData.end(), oit);
-    } else {
-        // Write to file without encryption.
-        fileStream << ss.str();
-    }
 
-    fileStream.close();
-	return true;
+        return true;
+    });
 }
 
-// -------
-// encrypt
-// -------
-
 /**
- * @brief Encrypts input string stream using AES in GCM mode for
- *        confidentiality and authenticity.
+ * @brief Writes a stream encrypted in the chunked format to out.
  *
- * @param message const reference to a string stream with data.
- * @param cipherData reference to a byte vector to hold encrypted data.
+ * @param in reference to an input stream read until its end.
+ * @param out reference to an output stream to hold encrypted data.
  * @param key const reference to a byte vector with an encryption key.
  *
  * @return true, if encryption is successful.
  */
-bool FileCryptopp::encrypt(
-    const std::stringstream& message,
-    std::vector<uint8_t>& cipherData,
+bool FileCryptopp::encryptChunks(
+    std::istream& in,
+    std::ostream& out,
     const std::vector<uint8_t>& key
 ) {
 
-    // Initial Vector (IV) for AES to XOR.
-    std::vector<uint8_t> iv(CryptoPP::AES::BLOCKSIZE);
-
-    std::string plaintext = message.str(); // store message
-    std::string ciphertext; // store encrypted message
+    size_t chunk = FILECRYPTO_CHUNK_BYTES;
 
+    uint8_t header[FILECRYPTO_HEADER_BYTES];
+    std::vector<uint8_t> fileKey;
+    std::vector<uint8_t> plain(chunk);
+    std::vector<uint8_t> sealed(chunk + FILECRYPTO_TAG_BYTES);
 
     try {
-        // Initialize AES.
+        chunkHeader(header, chunk);
+        chunkKey(key, header, fileKey);
+
         CryptoPP::GCM<AES>::Encryption e;
+        e.SetKey(fileKey.data(), fileKey.size());
 
-        // Set AES Key and load IV.
-        e.SetKeyWithIV(key.data(), key.size(), iv.data());
+        out.write(reinterpret_cast<const char*>(header), sizeof(header));
 
-        /* Load plain text into string source, then encrypt stream using
-         * a transformation filter. Dump the transformation using a
-         * string sink into ciphertext.
+        // Hand chunks to worker threads, if set.
+        size_t numThreads = workerCount(std::numeric_limits<size_t>::max());
+        if (numThreads > 1) {
+            int piped = pipeChunks(in, out, header, fileKey, true, numThreads);
+            if (piped >= 0) {
+                return piped == 1;
+            }
+        }
+
+        /* Seal chunks as they are read; a short read or nothing left to
+         * peek marks the final chunk.
          */
-        StringSource ss1(plaintext,
-            true,
-            new CryptoPP::AuthenticatedEncryptionFilter(
-                e,
-                new StringSink(ciphertext)
-            ) // StreamTransformationFilter
-        ); // StringSource
+        uint32_t counter = 0;
+        bool final = false;
+        while (!final) {
+            in.read(reinterpret_cast<char*>(plain.data()), chunk);
+            size_t length = in.gcount();
+
+            if (in.bad()) {
+                std::cerr << "Error encrypting file: read failed" << std::endl;
+                return false;
+            }
+
+            final = length < chunk
+                || in.peek() == std::istream::traits_type::eof();
+
+            if (!final && counter == std::numeric_limits<uint32_t>::max()) {
+                std::cerr << "Error encrypting file: too large" << std::endl;
+                return false;
+            }
+
+            sealChunk(
+                e, header, counter, final, plain.data(), length, sealed.data()
+            );
+            out.write(
+                reinterpret_cast<const char*>(sealed.data()),
+                length + FILECRYPTO_TAG_BYTES
+            );
+
+            if (!out.good()) {
+                return false;
+            }
+
+            ++counter;
+        }
 
     } catch (const CryptoPP::Exception& e) {
         // Failed Encryption.
@@ -275,62 +670,792 @@ bool FileCryptopp::encrypt(
         return false;
     }
 
-    // Append cipherData with bytes from ciphertext.
-    for (int i = 0; i < ciphertext.size(); i++) {
-        cipherData.push_back(
-            0xFF & static_cast<uint8_t>(ciphertext[i])
-        );
+    return true;
+}
+
+// -------------
+// decryptChunks
+// -------------
+
+/**
+ * @brief Decrypts and verifies chunks following a header already read
+ *        from in, writing each verified chunk to out.
+ *
+ * @param in reference to an input stream positioned after the header.
+ * @param header const pointer to FILECRYPTO_HEADER_BYTES header bytes.
+ * @param out reference to an output stream to hold decrypted data.
+ * @param key const reference to a byte vector with the decryption key.
+ *
+ * @return true, if every chunk up to the final chunk is verified.
+ */
+bool FileCryptopp::decryptChunks(
+    std::istream& in,
+    const uint8_t* header,
+    std::ostream& out,
+    const std::vector<uint8_t>& key
+) {
+
+    size_t chunk = chunkBytes(header);
+
+    if (chunk == 0) {
+        std::cerr << "Error decrypting file: unsupported format" << std::endl;
+        return false;
+    }
+
+    size_t tagBytes = FILECRYPTO_TAG_BYTES;
+    std::vector<uint8_t> fileKey;
+    std::vector<uint8_t> sealed(chunk + tagBytes);
+    std::vector<uint8_t> plain(chunk);
+
+    try {
+        chunkKey(key, header, fileKey);
+
+        // Hand chunks to worker threads, if set.
+        size_t numThreads = workerCount(std::numeric_limits<size_t>::max());
+        if (numThreads > 1) {
+            int piped = pipeChunks(in, out, header, fileKey, false, numThreads);
+            if (piped >= 0) {
+                return piped == 1 && out.good();
+            }
+        }
+
+        CryptoPP::GCM<AES>::Decryption d;
+        d.SetKey(fileKey.data(), fileKey.size());
+
+        /* Open chunks in order; the chunk followed by the end of the file
+         * must carry the final flag, so a file cut at a chunk boundary or
+         * extended past its final chunk fails verification.
+         */
+        uint32_t counter = 0;
+        bool final = false;
+        while (!final) {
+            in.read(reinterpret_cast<char*>(sealed.data()), sealed.size());
+            size_t length = in.gcount();
+
+            if (length < tagBytes) {
+                std::cerr << "Error decrypting file: truncated" << std::endl;
+                return false;
+            }
+
+            final = length < sealed.size()
+                || in.peek() == std::istream::traits_type::eof();
+
+            if (!openChunk(
+                d, header, counter, final, sealed.data(), length, plain.data()
+            )) {
+                std::cerr << "Error decrypting file: chunk " << counter
+                    << " failed verification" << std::endl;
+                return false;
+            }
+
+            out.write(
+                reinterpret_cast<const char*>(plain.data()),
+                length - tagBytes
+            );
+
+            if (!final && counter == std::numeric_limits<uint32_t>::max()) {
+                std::cerr << "Error decrypting file: too large" << std::endl;
+                return false;
+            }
+
+            ++counter;
+        }
+
+    } catch (const CryptoPP::Exception& e) {
+        // Failed decryption.
+        std::cerr << "Error decrypting file: " << e.what() << std::endl;
+        return false;
+    }
+
+    return out.good();
+}
+
+/**
+ * @brief Decrypts and verifies a whole chunked file held in memory into
+ *        one buffer.
+ *
+ * @param file const pointer to the file bytes, starting with the header.
+ * @param fileSize size_t with number of file bytes.
+ * @param data pointer to the plain text size of the file bytes to fill.
+ * @param key const reference to a byte vector with the decryption key.
+ *
+ * @return true, if every chunk is verified; otherwise data is zeroed.
+ */
+bool FileCryptopp::decryptChunks(
+    const uint8_t* file,
+    size_t fileSize,
+    uint8_t* data,
+    const std::vector<uint8_t>& key
+) {
+
+    size_t chunks = 0;
+    size_t size = 0;
+
+    if (!chunkLayout(file, fileSize, chunks, size)) {
+        std::cerr << "Error decrypting file: truncated or unsupported"
+            << std::endl;
+        return false;
+    }
+
+    size_t chunk = chunkBytes(file);
+    size_t segment = chunk + FILECRYPTO_TAG_BYTES;
+    std::vector<uint8_t> fileKey;
+
+    try {
+        chunkKey(key, file, fileKey);
+    } catch (const CryptoPP::Exception& e) {
+        // Failed decryption.
+        std::cerr << "Error decrypting file: " << e.what() << std::endl;
+        return false;
+    }
+
+    // Set by the first failing range; the others stop early.
+    std::atomic<bool> failed(false);
+
+    /* Open ranges of chunks in place, each thread with its own cipher; the
+     * last chunk of the file must be final.
+     */
+    bool verified = runChunks(chunks, [&] (size_t begin, size_t end) {
+        try {
+            CryptoPP::GCM<AES>::Decryption d;
+            d.SetKey(fileKey.data(), fileKey.size());
+
+            for (size_t i = begin; i < end && !failed; ++i) {
+                size_t offset = FILECRYPTO_HEADER_BYTES + i * segment;
+                size_t length = std::min(segment, fileSize - offset);
+
+                if (!openChunk(
+                    d,
+                    file,
+                    static_cast<uint32_t>(i),
+                    i + 1 == chunks,
+                    file + offset,
+                    length,
+                    data + i * chunk
+                )) {
+                    std::cerr << "Error decrypting file: chunk " << i
+                        << " failed verification" << std::endl;
+                    failed = true;
+                    return false;
+                }
+            }
+        } catch (const CryptoPP::Exception& e) {
+            // Failed decryption.
+            std::cerr << "Error decrypting file: " << e.what() << std::endl;
+            failed = true;
+            return false;
+        }
+
+        return true;
+    });
+
+    /* Other ranges kept decrypting while one failed; none of the output
+     * may be released, so wipe all of it.
+     */
+    if (!verified) {
+        std::fill(data, data + size, 0);
+    }
+
+    return verified;
+}
+
+// -----------
+// workerCount
+// -----------
+
+/**
+ * @brief Resolves the number of threads for a number of chunks.
+ *
+ * @param chunks size_t with number of chunks to process.
+ *
+ * @return size_t with number of threads, at least 1.
+ */
+size_t FileCryptopp::workerCount(size_t chunks) const {
+    size_t numThreads = _threads;
+
+    // Use hardware concurrency if requested.
+    if (numThreads == 0) {
+        numThreads = std::thread::hardware_concurrency();
+    }
+
+    // Limit threads so that each takes at least FILECRYPTO_THREAD_MIN_CHUNKS.
+    size_t maxThreads = chunks / FILECRYPTO_THREAD_MIN_CHUNKS;
+    if (numThreads > maxThreads) {
+        numThreads = maxThreads;
+    }
+    if (numThreads == 0) {
+        numThreads = 1;
+    }
+
+    return numThreads;
+}
+
+// ---------
+// runChunks
+// ---------
+
+/**
+ * @brief Splits chunk indices [0, chunks) into ranges processed on
+ *        worker threads and the calling thread.
+ *
+ * @param chunks size_t with number of chunks.
+ * @param process const reference to a function processing chunks
+ *        [begin, end); returns false on failure.
+ *
+ * @return true, if every range was processed.
+ */
+bool FileCryptopp::runChunks(
+    size_t chunks,
+    const std::function<bool(size_t, size_t)>& process
+) const {
+
+    size_t numThreads = workerCount(chunks);
+    size_t rangeSize = chunks / numThreads;
+    std::vector<char> processed(numThreads, 0);
+
+    auto processRange = [&] (size_t range) {
+        size_t begin = range * rangeSize;
+        size_t end = (range == numThreads - 1) ? chunks : begin + rangeSize;
+
+        processed[range] = process(begin, end) ? 1 : 0;
+    };
+
+    // Range 0 is processed by the calling thread.
+    std::vector<std::thread> workers;
+    for (size_t range = 1; range < numThreads; ++range) {
+        try {
+            workers.push_back(std::thread(processRange, range));
+        } catch (const std::system_error& e) {
+            processRange(range); // Thread unavailable; process inline.
+        }
+    }
+
+    processRange(0);
+
+    for (auto it = workers.begin(); it != workers.end(); ++it) {
+        it->join();
     }
 
+    return std::find(processed.begin(), processed.end(), 0)
+        == processed.end();
+}
+
+// ----------
+// pipeChunks
+// ----------
+
+/**
+ * @brief Streams chunks from in to out through worker threads: the
+ *        calling thread reads ahead, workers seal or open chunks and a
+ *        writer thread writes them in order, stopping at the first
+ *        chunk that fails.
+ *
+ * @param in reference to an input stream positioned at the first chunk.
+ * @param out reference to an output stream.
+ * @param header const pointer to FILECRYPTO_HEADER_BYTES header bytes.
+ * @param fileKey const reference to a byte vector with the file key.
+ * @param encrypting bool, true to seal plain text, false to open chunks.
+ * @param numThreads size_t with number of worker threads.
+ *
+ * @return int with value 1 if every chunk was processed, 0 on failure
+ *         and -1 if no threads could be started (nothing was read).
+ */
+int FileCryptopp::pipeChunks(
+    std::istream& in,
+    std::ostream& out,
+    const uint8_t* header,
+    const std::vector<uint8_t>& fileKey,
+    bool encrypting,
+    size_t numThreads
+) {
+
+    typedef std::shared_ptr<ChunkJob> Job;
+
+    size_t tagBytes = FILECRYPTO_TAG_BYTES;
+    size_t readBytes = encrypting
+        ? chunkBytes(header)
+        : chunkBytes(header) + tagBytes;
+
+    /* Jobs enter the work queue in any order of completion and the
+     * ordered queue in file order; both bound read ahead.
+     */
+    BoundedQueue<Job> work(2 * numThreads);
+    BoundedQueue<Job> ordered(2 * numThreads);
+    std::atomic<bool> failed(false);
+
+    auto stop = [&] () {
+        failed = true;
+        work.close();
+        ordered.close();
+    };
+
+    // Workers seal or open chunks, each with its own cipher.
+    auto processJobs = [&] () {
+        CryptoPP::GCM<AES>::Encryption e;
+        CryptoPP::GCM<AES>::Decryption d;
+        bool keyed = true;
+
+        try {
+            if (encrypting) {
+                e.SetKey(fileKey.data(), fileKey.size());
+            } else {
+                d.SetKey(fileKey.data(), fileKey.size());
+            }
+        } catch (const CryptoPP::Exception& ex) {
+            keyed = false;
+        }
+
+        Job job;
+        while (work.pop(job)) {
+            job->valid = keyed;
+
+            try {
+                if (keyed && encrypting) {
+                    job->output.resize(job->input.size() + tagBytes);
+                    sealChunk(
+                        e,
+                        header,
+                        job->counter,
+                        job->final,
+                        job->input.data(),
+                        job->input.size(),
+                        job->output.data()
+                    );
+                } else if (keyed) {
+                    job->output.resize(job->input.size() - tagBytes);
+                    job->valid = openChunk(
+                        d,
+                        header,
+                        job->counter,
+                        job->final,
+                        job->input.data(),
+                        job->input.size(),
+                        job->output.data()
+                    );
+                }
+            } catch (const CryptoPP::Exception& ex) {
+                job->valid = false;
+            }
+
+            job->processed.set_value();
+        }
+    };
+
+    // Writer emits processed chunks in file order.
+    auto writeJobs = [&] () {
+        Job job;
+        while (ordered.pop(job)) {
+            if (failed) {
+                continue; // Drain.
+            }
+
+            job->ready.wait();
+
+            if (!job->valid) {
+                std::cerr << (encrypting
+                    ? "Error encrypting file: chunk "
+                    : "Error decrypting file: chunk ")
+                    << job->counter << " failed verification" << std::endl;
+                stop();
+                continue;
+            }
+
+            out.write(
+                reinterpret_cast<const char*>(job->output.data()),
+                job->output.size()
+            );
+
+            if (!out.good()) {
+                stop();
+            }
+        }
+    };
+
+    // Start the writer and workers; without them nothing is read.
+    std::vector<std::thread> threads;
+    try {
+        threads.push_back(std::thread(writeJobs));
+        for (size_t i = 0; i < numThreads; ++i) {
+            threads.push_back(std::thread(processJobs));
+        }
+    } catch (const std::system_error& e) {
+        if (threads.size() < 2) {
+            work.close();
+            ordered.close();
+
+            for (auto it = threads.begin(); it != threads.end(); ++it) {
+                it->join();
+            }
+
+            return -1;
+        }
+    }
+
+    /* Read ahead on the calling thread; a short read or nothing left to
+     * peek marks the final chunk.
+     */
+    uint32_t counter = 0;
+    bool final = false;
+    while (!final && !failed) {
+        Job job = std::make_shared<ChunkJob>();
+        job->input.resize(readBytes);
+
+        in.read(reinterpret_cast<char*>(job->input.data()), readBytes);
+        size_t length = in.gcount();
+
+        if (in.bad() || (!encrypting && length < tagBytes)) {
+            std::cerr << (encrypting
+                ? "Error encrypting file: read failed"
+                : "Error decrypting file: truncated") << std::endl;
+            stop();
+            break;
+        }
+
+        final = length < readBytes
+            || in.peek() == std::istream::traits_type::eof();
+
+        if (!final && counter == std::numeric_limits<uint32_t>::max()) {
+            std::cerr << "Error processing file: too large" << std::endl;
+            stop();
+            break;
+        }
+
+        job->input.resize(length);
+        job->counter = counter++;
+        job->final = final;
+        job->valid = false;
+        job->ready = job->processed.get_future();
+
+        Job queued = job;
+        if (!work.push(std::move(queued)) || !ordered.push(std::move(job))) {
+            break; // Stopped by the writer.
+        }
+    }
+
+    // Let workers and the writer drain the queues.
+    work.close();
+    ordered.close();
+
+    for (auto it = threads.begin(); it != threads.end(); ++it) {
+        it->join();
+    }
+
+    return failed ? 0 : 1;
+}
+
+// ----------
+// sealedSize
+// ----------
+
+/**
+ * @brief Returns the size of a chunked file holding size bytes.
+ *
+ * @param size size_t with number of plain text bytes.
+ *
+ * @return size_t with number of file bytes, header and tags included.
+ */
+size_t FileCryptopp::sealedSize(size_t size) {
+    size_t chunk = FILECRYPTO_CHUNK_BYTES;
+    size_t chunks = size == 0 ? 1 : (size + chunk - 1) / chunk;
+
+    return FILECRYPTO_HEADER_BYTES + size + chunks * FILECRYPTO_TAG_BYTES;
+}
+
+// -----------
+// chunkLayout
+// -----------
+
+/**
+ * @brief Splits a chunked file of fileSize bytes into chunks as written.
+ *
+ * @param header const pointer to FILECRYPTO_HEADER_BYTES header bytes.
+ * @param fileSize size_t with number of file bytes, header included.
+ * @param chunks reference to a size_t set to the number of chunks.
+ * @param size reference to a size_t set to the plain text bytes.
+ *
+ * @return true, if the header is supported and fileSize is a possible
+ *         size of a file in its format.
+ */
+bool FileCryptopp::chunkLayout(
+    const uint8_t* header,
+    size_t fileSize,
+    size_t& chunks,
+    size_t& size
+) {
+    size_t chunk = chunkBytes(header);
+    size_t tagBytes = FILECRYPTO_TAG_BYTES;
+
+    if (chunk == 0 || fileSize <= FILECRYPTO_HEADER_BYTES) {
+        return false;
+    }
+
+    // Every chunk but the last is full.
+    size_t body = fileSize - FILECRYPTO_HEADER_BYTES;
+    size_t segment = chunk + tagBytes;
+
+    chunks = (body + segment - 1) / segment;
+
+    if (body - (chunks - 1) * segment < tagBytes
+        || chunks - 1 > std::numeric_limits<uint32_t>::max()
+    ) {
+        return false;
+    }
+
+    size = body - chunks * tagBytes;
     return true;
 }
 
+// -----------
+// chunkHeader
+// -----------
+
+/**
+ * @brief Fills a header for a new file with a fresh random salt and
+ *        nonce prefix.
+ *
+ * @param header pointer to FILECRYPTO_HEADER_BYTES bytes to fill.
+ * @param chunkBytes size_t with plain text bytes per chunk.
+ *
+ * @return void
+ */
+void FileCryptopp::chunkHeader(uint8_t* header, size_t chunkBytes) {
+
+    // Magic and version.
+    std::copy(FILECRYPTO_MAGIC.begin(), FILECRYPTO_MAGIC.end(), header);
+    header[4] = FILECRYPTO_FORMAT_VERSION;
+
+    // Chunk size, big endian.
+    header[5] = static_cast<uint8_t>(chunkBytes >> 24);
+    header[6] = static_cast<uint8_t>(chunkBytes >> 16);
+    header[7] = static_cast<uint8_t>(chunkBytes >> 8);
+    header[8] = static_cast<uint8_t>(chunkBytes);
+
+    // Salt (16 bytes) and nonce prefix (7 bytes).
+    CryptoPP::AutoSeededRandomPool generator;
+    generator.GenerateBlock(header + 9, FILECRYPTO_HEADER_BYTES - 9);
+}
+
+// ----------
+// chunkBytes
+// ----------
+
+/**
+ * @brief Parses and validates the chunk size of a header.
+ *
+ * @param header const pointer to FILECRYPTO_HEADER_BYTES header bytes.
+ *
+ * @return size_t with plain text bytes per chunk; 0 if the header is not
+ *         of a supported version or the chunk size is out of range.
+ */
+size_t FileCryptopp::chunkBytes(const uint8_t* header) {
+
+    if (header[4] != FILECRYPTO_FORMAT_VERSION) {
+        return 0;
+    }
+
+    size_t chunkBytes = (static_cast<size_t>(header[5]) << 24)
+        | (static_cast<size_t>(header[6]) << 16)
+        | (static_cast<size_t>(header[7]) << 8)
+        | static_cast<size_t>(header[8]);
+
+    if (chunkBytes > FILECRYPTO_MAX_CHUNK_BYTES) {
+        return 0;
+    }
+
+    return chunkBytes;
+}
+
+// --------
+// chunkKey
+// --------
+
+/**
+ * @brief Derives the per file key, SHA3-256 of key and header salt.
+ *
+ * @param key const reference to a byte vector with the file key.
+ * @param header const pointer to FILECRYPTO_HEADER_BYTES header bytes.
+ * @param fileKey reference to a byte vector to hold the derived key.
+ *
+ * @return void
+ */
+void FileCryptopp::chunkKey(
+    const std::vector<uint8_t>& key,
+    const uint8_t* header,
+    std::vector<uint8_t>& fileKey
+) {
+    CryptoPP::SHA3_256 hash;
+    fileKey.resize(CryptoPP::SHA3_256::DIGESTSIZE);
+
+    hash.Update(key.data(), key.size());
+    hash.Update(header + 9, 16); // salt
+    hash.Final(fileKey.data());
+}
+
+// ----------
+// chunkNonce
+// ----------
+
+/**
+ * @brief Builds the nonce of a chunk: header nonce prefix, big endian
+ *        counter and final chunk flag.
+ *
+ * @param header const pointer to FILECRYPTO_HEADER_BYTES header bytes.
+ * @param counter uint32_t with index of the chunk.
+ * @param final bool, true for the last chunk of the file.
+ * @param nonce pointer to FILECRYPTO_NONCE_BYTES bytes to fill.
+ *
+ * @return void
+ */
+void FileCryptopp::chunkNonce(
+    const uint8_t* header,
+    uint32_t counter,
+    bool final,
+    uint8_t* nonce
+) {
+    std::copy(header + 25, header + 32, nonce); // nonce prefix
+
+    nonce[7] = static_cast<uint8_t>(counter >> 24);
+    nonce[8] = static_cast<uint8_t>(counter >> 16);
+    nonce[9] = static_cast<uint8_t>(counter >> 8);
+    nonce[10] = static_cast<uint8_t>(counter);
+    nonce[11] = final ? 1 : 0;
+}
+
+// ---------
+// sealChunk
+// ---------
+
+/**
+ * @brief Encrypts one chunk; writes ciphertext followed by its tag.
+ *
+ * @param e reference to a keyed AES-GCM encryption object.
+ * @param header const pointer to FILECRYPTO_HEADER_BYTES header bytes.
+ * @param counter uint32_t with index of the chunk.
+ * @param final bool, true for the last chunk of the file.
+ * @param plain const pointer to the chunk's plain text.
+ * @param size size_t with number of plain text bytes.
+ * @param sealed pointer to size + FILECRYPTO_TAG_BYTES bytes to fill.
+ *
+ * @return void
+ */
+void FileCryptopp::sealChunk(
+    CryptoPP::GCM<AES>::Encryption& e,
+    const uint8_t* header,
+    uint32_t counter,
+    bool final,
+    const uint8_t* plain,
+    size_t size,
+    uint8_t* sealed
+) {
+    uint8_t nonce[FILECRYPTO_NONCE_BYTES];
+    chunkNonce(header, counter, final, nonce);
+
+    // Header is associated data of every chunk.
+    e.EncryptAndAuthenticate(
+        sealed,
+        sealed + size,
+        FILECRYPTO_TAG_BYTES,
+        nonce,
+        FILECRYPTO_NONCE_BYTES,
+        header,
+        FILECRYPTO_HEADER_BYTES,
+        plain,
+        size
+    );
+}
+
+// ---------
+// openChunk
+// ---------
+
+/**
+ * @brief Decrypts and verifies one chunk of ciphertext followed by its
+ *        tag.
+ *
+ * @param d reference to a keyed AES-GCM decryption object.
+ * @param header const pointer to FILECRYPTO_HEADER_BYTES header bytes.
+ * @param counter uint32_t with index of the chunk.
+ * @param final bool, true for the last chunk of the file.
+ * @param sealed const pointer to the chunk's ciphertext and tag.
+ * @param size size_t with number of sealed bytes, including the tag.
+ * @param plain pointer to size - FILECRYPTO_TAG_BYTES bytes to fill.
+ *
+ * @return true, if the chunk is authentic.
+ */
+bool FileCryptopp::openChunk(
+    CryptoPP::GCM<AES>::Decryption& d,
+    const uint8_t* header,
+    uint32_t counter,
+    bool final,
+    const uint8_t* sealed,
+    size_t size,
+    uint8_t* plain
+) {
+    uint8_t nonce[FILECRYPTO_NONCE_BYTES];
+    chunkNonce(header, counter, final, nonce);
+
+    size_t length = size - FILECRYPTO_TAG_BYTES;
+
+    return d.DecryptAndVerify(
+        plain,
+        sealed + length,
+        FILECRYPTO_TAG_BYTES,
+        nonce,
+        FILECRYPTO_NONCE_BYTES,
+        header,
+        FILECRYPTO_HEADER_BYTES,
+        sealed,
+        length
+    );
+}
+
 // -------
 // decrypt
 // -------
 
 /**
- * @brief Decrypts input string stream using AES in GCM mode for
- *        confidentiality and authenticity.
+ * @brief Decrypts a file of the original single message format using
+ *        AES in GCM mode for confidentiality and authenticity.
  *
- * @param cipher const reference to a byte vector with encrypted data.
- * @param messageData reference to a byte vector to hold decrypted data.
+ * @param cipher const pointer to the encrypted data followed by its tag.
+ * @param size size_t with number of bytes at cipher, tag included.
+ * @param message pointer to size - FILECRYPTO_TAG_BYTES bytes to fill.
  * @param key const reference to a byte vector with the decryption key.
  *
  * @return true, if decryption is successful.
  */
 bool FileCryptopp::decrypt(
-    const std::vector<uint8_t>& cipher,
-    std::vector<uint8_t>& messageData,
+    const uint8_t* cipher,
+    size_t size,
+    uint8_t* message,
     const std::vector<uint8_t>& key
 ) {
 
     // Initial Vector (IV) for AES to XOR.
     std::vector<uint8_t> iv(CryptoPP::AES::BLOCKSIZE);
 
-    std::string decryptedtext; // store decrypted message
-
+    size_t length = size - FILECRYPTO_TAG_BYTES;
+    bool verified = false;
 
     try {
         // Initialize AES.
-        CryptoPP::GCM< AES >::Decryption e;
+        CryptoPP::GCM< AES >::Decryption d;
 
-        // Set AES Key and load IV.
-        e.SetKeyWithIV(key.data(), key.size(), iv.data());
+        // Set AES Key.
+        d.SetKey(key.data(), key.size());
 
-        /* Load encrypted data into an array source, then decrypt data using
-         * a transformation filter. Dump the transformation using a string
-         * sink into decryptedtext.
-         */
-        ArraySource ss2(
-            cipher.data(),
-            cipher.size(),
-            true,
-            new CryptoPP::AuthenticatedDecryptionFilter(
-                e,
-                new StringSink(decryptedtext)
-            ) // StreamTransformationFilter
-        ); // StringSource
+        // Decrypt straight into message; the tag follows the ciphertext.
+        verified = d.DecryptAndVerify(
+            message,
+            cipher + length,
+            FILECRYPTO_TAG_BYTES,
+            iv.data(),
+            iv.size(),
+            NULL,
+            0,
+            cipher,
+            length
+        );
 
     } catch (const CryptoPP::Exception& e) {
         // Failed decryption.
@@ -338,13 +1463,9 @@ bool FileCryptopp::decrypt(
         return false;
     }
 
-    // Append messageData with bytes from decryptedtext.
-    for (int i = 0; i < decryptedtext.size(); i++) {
-        messageData.push_back(
-            0xFF & static_cast<uint8_t>(decryptedtext[i])
-        );
+    if (!verified) {
+        std::cerr << "Error decrypting file: failed verification" << std::endl;
     }
 
-    return true;
+    return verified;
 }
-
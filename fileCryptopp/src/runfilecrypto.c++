@@ -35,6 +35,14 @@
 #include <vector>
 #include <cassert>
 #include <algorithm>
+#include <fstream>
+#include <iterator>
+
+// --------------------
+// third party includes
+// --------------------
+#include <aes.h>
+#include <gcm.h>
 
 // ----------------
 // library includes
@@ -143,6 +151,377 @@ int readFile () {
 	return retVal;
 }
 
+// -----------
+// writeStream
+// -----------
+
+/**
+ * @brief Attempt to encrypt and write streams of several sizes in the
+ *        chunked format, then read and verify each one.
+ *
+ * @return true, if test passed.
+ */
+int writeStream () {
+	std::cerr << "**Running test writeStream**" << std::endl;
+	std::vector<uint8_t> key;
+	key.reserve(32);
+	for (int i = 0; i < 32; ++i) {
+		key.push_back(i);
+	}
+
+	FileCryptopp fc("./testStream");
+
+	size_t chunk = FileCryptopp::FILECRYPTO_CHUNK_BYTES;
+
+	// Empty, partial, exact multiple and several chunks with a remainder.
+	std::vector<size_t> sizes = {0, 100, 2 * chunk, 3 * chunk + 123};
+
+	bool retVal = true;
+	for (auto it = sizes.begin(); it != sizes.end() && retVal; ++it) {
+		std::string clearText(*it, 0);
+		for (size_t i = 0; i < clearText.size(); ++i) {
+			clearText[i] = static_cast<char>((i * 131) ^ (i >> 8));
+		}
+
+		std::istringstream in(clearText);
+		std::stringstream out;
+
+		retVal = fc.writeStream(in, key)
+			&& fc.readStream(out, key)
+			&& out.str() == clearText;
+	}
+
+	if (!retVal) {
+		std::cerr << "!!Failed writeStream test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return retVal;
+}
+
+// ---------------
+// truncatedStream
+// ---------------
+
+/**
+ * @brief Attempt to read a chunked file cut at a chunk boundary and a file
+ *        with a modified byte; both must fail verification.
+ *
+ * @return true, if test passed.
+ */
+int truncatedStream () {
+	std::cerr << "**Running test truncatedStream**" << std::endl;
+	std::vector<uint8_t> key;
+	key.reserve(32);
+	for (int i = 0; i < 32; ++i) {
+		key.push_back(i);
+	}
+
+	FileCryptopp fc("./testStream");
+
+	size_t chunk = FileCryptopp::FILECRYPTO_CHUNK_BYTES;
+	size_t header = FileCryptopp::FILECRYPTO_HEADER_BYTES;
+	size_t tag = FileCryptopp::FILECRYPTO_TAG_BYTES;
+
+	std::stringstream ss;
+	ss << std::string(3 * chunk, 'x');
+
+	bool retVal = fc.writeFile(ss, key);
+
+	// Load encrypted file.
+	std::ifstream encryptedStream("./testStream", std::ios::binary);
+	std::string encrypted(
+		(std::istreambuf_iterator<char>(encryptedStream)),
+		std::istreambuf_iterator<char>()
+	);
+	encryptedStream.close();
+
+	retVal = retVal && encrypted.size() == header + 3 * (chunk + tag);
+
+	// Drop the final chunk.
+	std::ofstream truncatedStream("./testStream", std::ios::binary);
+	truncatedStream << encrypted.substr(0, header + 2 * (chunk + tag));
+	truncatedStream.close();
+
+	std::stringstream out;
+	std::vector<uint8_t> data;
+	retVal = retVal && !fc.readFile(out, key) && !fc.readFile(data, key);
+
+	// Flip one ciphertext bit of the last chunk.
+	encrypted[encrypted.size() - tag - 1] ^= 1;
+	std::ofstream modifiedStream("./testStream", std::ios::binary);
+	modifiedStream << encrypted;
+	modifiedStream.close();
+
+	out.str("");
+	retVal = retVal && !fc.readFile(out, key) && out.str().empty()
+		&& !fc.readFile(data, key) && data.empty();
+
+	// Buffer holds no unverified plain text after a failed read.
+	std::vector<uint8_t> buffer(3 * chunk, 0xFF);
+	size_t size = 0;
+	retVal = retVal
+		&& !fc.readFile(buffer.data(), buffer.size(), size, key)
+		&& size == buffer.size()
+		&& std::count(buffer.begin(), buffer.end(), 0) == buffer.size();
+
+	if (!retVal) {
+		std::cerr << "!!Failed truncatedStream test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return retVal;
+}
+
+// --------
+// spanFile
+// --------
+
+/**
+ * @brief Attempt to encrypt a buffer and read it back through the mapped
+ *        buffer and stream paths, including a buffer that is too small.
+ *
+ * @return true, if test passed.
+ */
+int spanFile () {
+	std::cerr << "**Running test spanFile**" << std::endl;
+	std::vector<uint8_t> key;
+	key.reserve(32);
+	for (int i = 0; i < 32; ++i) {
+		key.push_back(i);
+	}
+
+	FileCryptopp fc("./testSpan");
+
+	size_t chunk = FileCryptopp::FILECRYPTO_CHUNK_BYTES;
+
+	std::vector<uint8_t> clearText(2 * chunk + 7);
+	for (size_t i = 0; i < clearText.size(); ++i) {
+		clearText[i] = static_cast<uint8_t>(i * 7 + (i >> 10));
+	}
+
+	bool retVal = fc.writeFile(clearText.data(), clearText.size(), key);
+
+	// Read into a vector sized by readFile.
+	std::vector<uint8_t> data;
+	retVal = retVal && fc.readFile(data, key) && data == clearText;
+
+	// A short buffer is refused and the needed size reported.
+	std::vector<uint8_t> shortBuffer(chunk);
+	size_t size = 0;
+	retVal = retVal
+		&& !fc.readFile(shortBuffer.data(), shortBuffer.size(), size, key)
+		&& size == clearText.size();
+
+	// Stream read of the same file.
+	std::stringstream out;
+	retVal = retVal && fc.readStream(out, key)
+		&& out.str() == std::string(clearText.begin(), clearText.end());
+
+	// Unencrypted buffer.
+	retVal = retVal && fc.writeFile(clearText.data(), clearText.size(), {})
+		&& fc.readFile(data, {}) && data == clearText;
+
+	if (!retVal) {
+		std::cerr << "!!Failed spanFile test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return retVal;
+}
+
+// --------------
+// parallelChunks
+// --------------
+
+/**
+ * @brief Attempt to encrypt and decrypt on worker threads, checking the
+ *        files against the single threaded paths, then read a file with a
+ *        dropped and a file with reordered chunks; both must fail.
+ *
+ * @return true, if test passed.
+ */
+int parallelChunks () {
+	std::cerr << "**Running test parallelChunks**" << std::endl;
+	std::vector<uint8_t> key;
+	key.reserve(32);
+	for (int i = 0; i < 32; ++i) {
+		key.push_back(i);
+	}
+
+	FileCryptopp parallel("./testParallel");
+	parallel.setThreads(4);
+	FileCryptopp sequential("./testParallel");
+
+	size_t chunk = FileCryptopp::FILECRYPTO_CHUNK_BYTES;
+	size_t header = FileCryptopp::FILECRYPTO_HEADER_BYTES;
+	size_t tag = FileCryptopp::FILECRYPTO_TAG_BYTES;
+
+	// Enough chunks for four threads.
+	std::vector<uint8_t> clearText(
+		4 * FileCryptopp::FILECRYPTO_THREAD_MIN_CHUNKS * chunk + 5
+	);
+	for (size_t i = 0; i < clearText.size(); ++i) {
+		clearText[i] = static_cast<uint8_t>(i * 13 + (i >> 16));
+	}
+	std::string clearString(clearText.begin(), clearText.end());
+
+	// Buffer write on threads, read back single threaded and on threads.
+	std::vector<uint8_t> data;
+	std::stringstream out;
+	bool retVal = parallel.writeFile(clearText.data(), clearText.size(), key)
+		&& sequential.readStream(out, key) && out.str() == clearString
+		&& parallel.readFile(data, key) && data == clearText;
+
+	// Stream write on threads, read back single threaded and on threads.
+	std::istringstream in(clearString);
+	out.str("");
+	retVal = retVal && parallel.writeStream(in, key)
+		&& sequential.readFile(data, key) && data == clearText
+		&& parallel.readStream(out, key) && out.str() == clearString;
+
+	// Load encrypted file.
+	std::ifstream encryptedStream("./testParallel", std::ios::binary);
+	std::string encrypted(
+		(std::istreambuf_iterator<char>(encryptedStream)),
+		std::istreambuf_iterator<char>()
+	);
+	encryptedStream.close();
+
+	// Drop the final chunk.
+	std::ofstream truncatedStream("./testParallel", std::ios::binary);
+	truncatedStream << encrypted.substr(0, encrypted.size() - 5 - tag);
+	truncatedStream.close();
+
+	out.str("");
+	retVal = retVal && !parallel.readStream(out, key)
+		&& !parallel.readFile(data, key);
+
+	// Swap the first two chunks.
+	std::string reordered = encrypted;
+	std::copy(
+		encrypted.begin() + header,
+		encrypted.begin() + header + chunk + tag,
+		reordered.begin() + header + chunk + tag
+	);
+	std::copy(
+		encrypted.begin() + header + chunk + tag,
+		encrypted.begin() + header + 2 * (chunk + tag),
+		reordered.begin() + header
+	);
+	std::ofstream reorderedStream("./testParallel", std::ios::binary);
+	reorderedStream << reordered;
+	reorderedStream.close();
+
+	out.str("");
+	retVal = retVal && !parallel.readStream(out, key)
+		&& !parallel.readFile(data, key);
+
+	// Chunks verified by other threads are wiped as well.
+	std::vector<uint8_t> buffer(clearText.size(), 0xFF);
+	size_t size = 0;
+	retVal = retVal
+		&& !parallel.readFile(buffer.data(), buffer.size(), size, key)
+		&& std::count(buffer.begin(), buffer.end(), 0) == buffer.size();
+
+	if (!retVal) {
+		std::cerr << "!!Failed parallelChunks test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return retVal;
+}
+
+// ------------
+// legacyFormat
+// ------------
+
+/**
+ * @brief Attempt to read a file of the original single message format
+ *        (AES-GCM, zero IV, tag appended) through every reader, then the
+ *        same file with a modified byte; it must fail and leave no data.
+ *
+ * @return true, if test passed.
+ */
+int legacyFormat () {
+	std::cerr << "**Running test legacyFormat**" << std::endl;
+	std::vector<uint8_t> key;
+	key.reserve(32);
+	for (int i = 0; i < 32; ++i) {
+		key.push_back(i);
+	}
+
+	FileCryptopp fc("./testLegacy");
+
+	size_t tag = FileCryptopp::FILECRYPTO_TAG_BYTES;
+
+	std::vector<uint8_t> clearText(3000);
+	for (size_t i = 0; i < clearText.size(); ++i) {
+		clearText[i] = static_cast<uint8_t>(i * 11 + (i >> 8));
+	}
+	std::string clearString(clearText.begin(), clearText.end());
+
+	// Encrypt as the original writer did: zero IV, no AAD, tag appended.
+	std::vector<uint8_t> iv(CryptoPP::AES::BLOCKSIZE, 0);
+	std::string encrypted(clearText.size() + tag, 0);
+	CryptoPP::GCM<AES>::Encryption e;
+	e.SetKey(key.data(), key.size());
+	e.EncryptAndAuthenticate(
+		reinterpret_cast<uint8_t*>(&encrypted[0]),
+		reinterpret_cast<uint8_t*>(&encrypted[0]) + clearText.size(),
+		tag,
+		iv.data(),
+		iv.size(),
+		NULL,
+		0,
+		clearText.data(),
+		clearText.size()
+	);
+
+	std::ofstream legacyStream("./testLegacy", std::ios::binary);
+	legacyStream << encrypted;
+	legacyStream.close();
+
+	// Every reader decrypts the original format.
+	std::stringstream ss;
+	std::vector<uint8_t> data;
+	std::vector<uint8_t> buffer(clearText.size());
+	size_t size = 0;
+	std::stringstream out;
+	bool retVal = fc.readFile(ss, key) && ss.str() == clearString
+		&& fc.readFile(data, key) && data == clearText
+		&& fc.readFile(buffer.data(), buffer.size(), size, key)
+		&& size == clearText.size() && buffer == clearText
+		&& fc.readStream(out, key) && out.str() == clearString;
+
+	// Flip one ciphertext bit.
+	encrypted[clearText.size() / 2] ^= 1;
+	std::ofstream modifiedStream("./testLegacy", std::ios::binary);
+	modifiedStream << encrypted;
+	modifiedStream.close();
+
+	// Nothing is appended and no plain text is left behind.
+	ss.str("");
+	std::fill(buffer.begin(), buffer.end(), 0xFF);
+	retVal = retVal
+		&& !fc.readFile(ss, key) && ss.str().empty()
+		&& !fc.readFile(data, key) && data.empty()
+		&& !fc.readFile(buffer.data(), buffer.size(), size, key)
+		&& std::count(buffer.begin(), buffer.end(), 0) == buffer.size();
+
+	if (!retVal) {
+		std::cerr << "!!Failed legacyFormat test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return retVal;
+}
+
 int main(){
 	/* Run tests and count passed.
 	 * Order matters.
@@ -150,11 +529,16 @@ int main(){
 	int passed = 0;
 	passed += writeFile();
 	passed += readFile();
+	passed += writeStream();
+	passed += truncatedStream();
+	passed += spanFile();
+	passed += parallelChunks();
+	passed += legacyFormat();
 
 	std::cerr << std::endl;
-	std::cerr << "--Passed " << passed << "/2" << " tests--" << std::endl;
+	std::cerr << "--Passed " << passed << "/7" << " tests--" << std::endl;
 
 	// Assert passing all tests.
-	assert(passed == 2);
+	assert(passed == 7);
 	return 0;
 }
\ No newline at end of file
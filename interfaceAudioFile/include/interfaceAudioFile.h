@@ -0,0 +1,264 @@
+/** @file interfaceAudioFile.h
+ *  @brief Interface to replay 16bit PCM audio (WAV or raw) from a memory
+ *         mapped file as entropic bytes, through the microphone's sample path.
+ *
+ *  @author Aashish Sheshadri
+ *  @author Rohit Harchandani
+ *
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2015, 2016, 2017 PayPal
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef INTERFACEAUDIOFILE_H
+#define INTERFACEAUDIOFILE_H
+
+// -----------------
+// standard includes
+// -----------------
+#include <string>
+#include <vector>
+#include <iterator>
+#include <iostream>
+
+// ----------------
+// library includes
+// ----------------
+#include "randomSource.h"
+#include "bitHistogram.h"
+#include "int16toBytes.h"
+#include "noiseBits.h"
+#include "mappedFile.h"
+
+/**
+ * @class InterfaceAudioFile tasked with replaying 16bit audio samples from
+ *        a WAV (PCM) or raw little endian int16 file and provide an entropy
+ *        estimate per sample. Samples are converted and counted exactly as
+ *        InterfaceMicrophone does, enabling capture free benchmarks.
+ *        Inherits the abstract class RandomSource.
+ */
+class InterfaceAudioFile: public RandomSource {
+public:
+
+	// ---------
+	// constants
+	// ---------
+
+	// Samples converted per step (and per pacing step).
+	static const size_t AUDIO_CHUNK_SAMPLES = 64*1024;
+
+	// -----------
+	// Constructor
+	// -----------
+
+	/**
+	 * Constructor
+	 * @brief Creates InterfaceAudioFile object without an open file.
+	 */
+	InterfaceAudioFile();
+
+	// ----------
+	// appendData
+	// ----------
+
+	/**
+	 * @brief Appends available entropic data to the vector byte stream.
+	 *        Implementation of pure virtual function from RandomSource.
+	 *
+	 * @param data a reference to a byte vector to be appended with
+	 *        replayed audio samples.
+	 *
+	 * @return void
+	 */
+	void appendData(std::vector<uint8_t>& data);
+
+	// --------
+	// moveData
+	// --------
+
+	/**
+	 * @brief Appends available entropic data to the vector byte stream;
+	 *        the recorded buffer is handed over without a copy when data is
+	 *        empty. Override of virtual function from RandomSource.
+	 *
+	 * @param data a reference to a byte vector to be appended with
+	 *        replayed audio samples.
+	 *
+	 * @return void
+	 */
+	void moveData(std::vector<uint8_t>& data);
+
+	// ----------
+	// bitEntropy
+	// ----------
+
+	/**
+	 * @brief Returns entropy estimate of replayed samples as bit
+	 *        occurrence probabilities.
+	 *        Implementation of pure virtual function from RandomSource.
+	 *
+	 * @return double vector with bit occurrence probabilities.
+	 */
+	std::vector<double> bitEntropy();
+
+	// ------------
+	// setNoiseBits
+	// ------------
+
+	/**
+	 * @brief Selects how samples are recorded: whole 16bit samples (0) or
+	 *        only their noiseBits low order bits packed into bytes, which
+	 *        keeps the bits carrying most noise and shrinks the data.
+	 *        The bit estimate then covers the packed bytes.
+	 *
+	 * @param noiseBits unsigned with low order bits kept per sample, at
+	 *        most NoiseBitPacker::MAX_NOISE_BITS; 0 records whole samples.
+	 * @param decorrelate bool; if true, keep the bits of left minus right
+	 *        of each stereo frame, removing signal common to both channels
+	 *        (default false).
+	 *
+	 * @return true, if the mode was set.
+	 */
+	bool setNoiseBits(unsigned noiseBits, bool decorrelate = false);
+
+	// --------
+	// openFile
+	// --------
+
+	/**
+	 * @brief Maps an audio file for replay. A file starting with a RIFF
+	 *        header must be a 16bit PCM WAV file; any other file is taken
+	 *        as raw little endian int16 samples.
+	 *
+	 * @param path const reference to a string with the file path.
+	 * @param rawSampleRate size_t with frames per second of a raw file
+	 *        (default 44100).
+	 * @param rawChannels size_t with channels of a raw file (default 2).
+	 *
+	 * @return true, if the file was mapped and holds 16bit samples.
+	 */
+	bool openFile(
+		const std::string& path,
+		size_t rawSampleRate = 44100,
+		size_t rawChannels = 2
+	);
+
+	// ---------
+	// closeFile
+	// ---------
+
+	/**
+	 * @brief Releases the mapped file; recorded bytes are kept.
+	 *
+	 * @return void
+	 */
+	void closeFile();
+
+	// -----------
+	// readSamples
+	// -----------
+
+	/**
+	 * @brief Replays up to numSamples samples (all channels) from the
+	 *        current position into the recorded bytes and sample counts.
+	 *
+	 * @param numSamples size_t with number of samples to replay.
+	 * @param paced bool; if true, replay no faster than the file's sample
+	 *        rate, as a live device would deliver (default false).
+	 *
+	 * @return size_t with number of samples replayed.
+	 */
+	size_t readSamples(size_t numSamples, bool paced = false);
+
+	// ------
+	// rewind
+	// ------
+
+	/**
+	 * @brief Restarts replay from the first sample.
+	 *
+	 * @return void
+	 */
+	void rewind();
+
+	// ----------------
+	// remainingSamples
+	// ----------------
+
+	/**
+	 * @brief Returns number of samples left to replay.
+	 *
+	 * @return size_t with samples after the current position.
+	 */
+	size_t remainingSamples() const;
+
+	// ----------
+	// sampleRate
+	// ----------
+
+	/**
+	 * @brief Returns frames per second of the open file.
+	 *
+	 * @return size_t with the sample rate.
+	 */
+	size_t sampleRate() const;
+
+	// --------
+	// channels
+	// --------
+
+	/**
+	 * @brief Returns number of interleaved channels of the open file.
+	 *
+	 * @return size_t with the channel count.
+	 */
+	size_t channels() const;
+
+private:
+
+	// --------
+	// parseWav
+	// --------
+
+	/**
+	 * @brief Locates format and samples of the mapped WAV file.
+	 *
+	 * @return true, if the file is 16bit PCM with a data chunk.
+	 */
+	bool parseWav();
+
+	// ----
+	// data
+	// ----
+	MappedFile _file; // Mapped audio file.
+	const uint8_t* _samples; // First byte of the samples in _file.
+	size_t _numSamples; // Number of samples (all channels) in _file.
+	size_t _position; // Samples replayed since open or rewind.
+	size_t _sampleRate; // Frames per second.
+	size_t _channels; // Interleaved channels per frame.
+	std::vector<uint8_t> _audioData; // Vector of replayed sample bytes.
+	BitHistogram<uint16_t> _histogram; // Sample counts for bit estimate.
+	unsigned _noiseBits; // Low order bits kept per sample, 0 for all.
+	NoiseBitPacker _packer; // Packs noise bits of samples.
+	BitHistogram<uint8_t> _packedHistogram; // Counts of packed bytes.
+};
+
+#endif
@@ -0,0 +1,459 @@
+/** @file interfaceAudioFile.cpp
+ *  @brief Interface to replay 16bit PCM audio (WAV or raw) from a memory
+ *         mapped file as entropic bytes, through the microphone's sample path.
+ *
+ *  @author Aashish Sheshadri
+ *  @author Rohit Harchandani
+ *
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2015, 2016, 2017 PayPal
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+// -----------------
+// standard includes
+// -----------------
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <cstring>
+
+// ----------------
+// library includes
+// ----------------
+#include "interfaceAudioFile.h"
+
+// ------
+// readLE
+// ------
+
+/**
+ * @brief Reads a little endian unsigned integer of numBytes bytes.
+ *
+ * @param bytes const pointer to the first byte.
+ * @param numBytes size_t with number of bytes (at most 4).
+ *
+ * @return uint32_t with the decoded value.
+ */
+static uint32_t readLE(const uint8_t* bytes, size_t numBytes) {
+	uint32_t value = 0;
+
+	for (size_t i = 0; i < numBytes; ++i) {
+		value |= static_cast<uint32_t>(bytes[i]) << (8 * i);
+	}
+
+	return value;
+}
+
+// -----------
+// Constructor
+// -----------
+
+/**
+ * Constructor
+ * @brief Creates InterfaceAudioFile object without an open file.
+ */
+InterfaceAudioFile::InterfaceAudioFile():
+	_samples(NULL),
+	_numSamples(0),
+	_position(0),
+	_sampleRate(0),
+	_channels(0),
+	_noiseBits(0) {
+
+}
+
+// ----------
+// appendData
+// ----------
+
+/**
+ * @brief Appends available entropic data to the vector byte stream.
+ *        Implementation of pure virtual function from RandomSource.
+ *
+ * @param data a reference to a byte vector to be appended with
+ *        replayed audio samples.
+ *
+ * @return void
+ */
+void InterfaceAudioFile::appendData(std::vector<uint8_t>& data) {
+	try {
+		// Reserve space for data to be appended.
+		data.reserve(data.size() + _audioData.size());
+	} catch (const std::bad_alloc& ba) {
+		std::cerr << "[Memory Error] Cannot Append: " << std::endl;
+		return;
+	}
+
+	// Append available replayed data.
+	std::copy(_audioData.begin(), _audioData.end(), std::back_inserter(data));
+
+	// Clear replayed data and reset sample counts for further replays.
+	_audioData.clear();
+	_histogram.reset();
+	_packedHistogram.reset();
+}
+
+// --------
+// moveData
+// --------
+
+/**
+ * @brief Appends available entropic data to the vector byte stream;
+ *        the recorded buffer is handed over without a copy when data is
+ *        empty. Override of virtual function from RandomSource.
+ *
+ * @param data a reference to a byte vector to be appended with
+ *        replayed audio samples.
+ *
+ * @return void
+ */
+void InterfaceAudioFile::moveData(std::vector<uint8_t>& data) {
+
+	// Append by copy if data already holds bytes.
+	if (!data.empty()) {
+		appendData(data);
+		return;
+	}
+
+	// Hand over replayed bytes and release the buffer previously held by data.
+	data.swap(_audioData);
+	std::vector<uint8_t>().swap(_audioData);
+
+	// Reset sample counts for further replays.
+	_histogram.reset();
+	_packedHistogram.reset();
+}
+
+// ----------
+// bitEntropy
+// ----------
+
+/**
+ * @brief Returns entropy estimate of replayed samples as bit
+ *        occurrence probabilities.
+ *        Implementation of pure virtual function from RandomSource.
+ *
+ * @return double vector with bit occurrence probabilities.
+ */
+std::vector<double> InterfaceAudioFile::bitEntropy() {
+	// Derive bit occurrence probabilities from counts of replayed samples.
+	if (_noiseBits != 0) {
+		return _packedHistogram.bitProbabilities();
+	}
+
+	return _histogram.bitProbabilities();
+}
+
+// ------------
+// setNoiseBits
+// ------------
+
+/**
+ * @brief Selects how samples are recorded: whole 16bit samples (0) or
+ *        only their noiseBits low order bits packed into bytes, which
+ *        keeps the bits carrying most noise and shrinks the data.
+ *        The bit estimate then covers the packed bytes.
+ *
+ * @param noiseBits unsigned with low order bits kept per sample, at
+ *        most NoiseBitPacker::MAX_NOISE_BITS; 0 records whole samples.
+ * @param decorrelate bool; if true, keep the bits of left minus right
+ *        of each stereo frame, removing signal common to both channels
+ *        (default false).
+ *
+ * @return true, if the mode was set.
+ */
+bool InterfaceAudioFile::setNoiseBits(unsigned noiseBits, bool decorrelate) {
+	if (noiseBits > NoiseBitPacker::MAX_NOISE_BITS) {
+		return false;
+	}
+
+	_noiseBits = noiseBits;
+	_packer = NoiseBitPacker(noiseBits, decorrelate);
+
+	return true;
+}
+
+// --------
+// openFile
+// --------
+
+/**
+ * @brief Maps an audio file for replay. A file starting with a RIFF
+ *        header must be a 16bit PCM WAV file; any other file is taken
+ *        as raw little endian int16 samples.
+ *
+ * @param path const reference to a string with the file path.
+ * @param rawSampleRate size_t with frames per second of a raw file
+ *        (default 44100).
+ * @param rawChannels size_t with channels of a raw file (default 2).
+ *
+ * @return true, if the file was mapped and holds 16bit samples.
+ */
+bool InterfaceAudioFile::openFile(
+	const std::string& path,
+	size_t rawSampleRate,
+	size_t rawChannels
+) {
+	closeFile();
+
+	if (!_file.open(path)) {
+		std::cerr << "Unable to map audio file: " << path << std::endl;
+		return false;
+	}
+
+	const uint8_t* bytes = _file.data();
+	size_t size = _file.size();
+
+	// WAV files are identified by their RIFF header.
+	if (size >= 12
+		&& std::memcmp(bytes, "RIFF", 4) == 0
+		&& std::memcmp(bytes + 8, "WAVE", 4) == 0) {
+
+		if (!parseWav()) {
+			std::cerr << "Not a 16bit PCM WAV file: " << path << std::endl;
+			closeFile();
+			return false;
+		}
+
+		return true;
+	}
+
+	// Raw little endian int16 samples.
+	_samples = bytes;
+	_numSamples = size / 2;
+	_sampleRate = rawSampleRate;
+	_channels = rawChannels;
+
+	return true;
+}
+
+// ---------
+// closeFile
+// ---------
+
+/**
+ * @brief Releases the mapped file; recorded bytes are kept.
+ *
+ * @return void
+ */
+void InterfaceAudioFile::closeFile() {
+	_file.close();
+	_packer.reset();
+	_samples = NULL;
+	_numSamples = 0;
+	_position = 0;
+	_sampleRate = 0;
+	_channels = 0;
+}
+
+// -----------
+// readSamples
+// -----------
+
+/**
+ * @brief Replays up to numSamples samples (all channels) from the
+ *        current position into the recorded bytes and sample counts.
+ *
+ * @param numSamples size_t with number of samples to replay.
+ * @param paced bool; if true, replay no faster than the file's sample
+ *        rate, as a live device would deliver (default false).
+ *
+ * @return size_t with number of samples replayed.
+ */
+size_t InterfaceAudioFile::readSamples(size_t numSamples, bool paced) {
+	numSamples = std::min(numSamples, remainingSamples());
+
+	if (numSamples == 0) {
+		return 0;
+	}
+
+	try {
+		// Reserve space for 2 bytes per int16 sample.
+		_audioData.reserve(_audioData.size() + 2 * numSamples);
+	} catch (const std::bad_alloc& ba) {
+		std::cerr << "[Memory Error] Samples discarded." << std::endl;
+		return 0;
+	}
+
+	size_t chunkSize = InterfaceAudioFile::AUDIO_CHUNK_SAMPLES;
+	if (numSamples < chunkSize) {
+		chunkSize = numSamples;
+	}
+
+	std::vector<int16_t> chunk(chunkSize);
+	double samplesPerSecond = static_cast<double>(_sampleRate * _channels);
+	auto start = std::chrono::steady_clock::now();
+	size_t replayed = 0;
+
+	while (replayed < numSamples) {
+		size_t count = std::min(chunkSize, numSamples - replayed);
+		const uint8_t* bytes = _samples + 2 * (_position + replayed);
+
+		// Decode little endian samples as a device buffer would hold them.
+		for (size_t i = 0; i < count; ++i) {
+			chunk[i] = static_cast<int16_t>(readLE(bytes + 2 * i, 2));
+		}
+
+		// Same conversion and counting as samples from the microphone.
+		if (_noiseBits != 0) {
+			_packer.pack(chunk.data(), count, _audioData, _packedHistogram);
+		} else {
+			int16toBytes(
+				chunk.begin(),
+				chunk.begin() + count,
+				std::back_inserter(_audioData),
+				_histogram
+			);
+		}
+
+		replayed += count;
+
+		// Hold back until the samples would have been recorded live.
+		if (paced && samplesPerSecond > 0) {
+			std::this_thread::sleep_until(
+				start + std::chrono::duration_cast<
+					std::chrono::steady_clock::duration
+				>(std::chrono::duration<double>(replayed / samplesPerSecond))
+			);
+		}
+	}
+
+	_position += numSamples;
+
+	return numSamples;
+}
+
+// ------
+// rewind
+// ------
+
+/**
+ * @brief Restarts replay from the first sample.
+ *
+ * @return void
+ */
+void InterfaceAudioFile::rewind() {
+	_position = 0;
+	_packer.reset();
+}
+
+// ----------------
+// remainingSamples
+// ----------------
+
+/**
+ * @brief Returns number of samples left to replay.
+ *
+ * @return size_t with samples after the current position.
+ */
+size_t InterfaceAudioFile::remainingSamples() const {
+	return _numSamples - _position;
+}
+
+// ----------
+// sampleRate
+// ----------
+
+/**
+ * @brief Returns frames per second of the open file.
+ *
+ * @return size_t with the sample rate.
+ */
+size_t InterfaceAudioFile::sampleRate() const {
+	return _sampleRate;
+}
+
+// --------
+// channels
+// --------
+
+/**
+ * @brief Returns number of interleaved channels of the open file.
+ *
+ * @return size_t with the channel count.
+ */
+size_t InterfaceAudioFile::channels() const {
+	return _channels;
+}
+
+// --------
+// parseWav
+// --------
+
+/**
+ * @brief Locates format and samples of the mapped WAV file.
+ *
+ * @return true, if the file is 16bit PCM with a data chunk.
+ */
+bool InterfaceAudioFile::parseWav() {
+	const uint8_t* bytes = _file.data();
+	size_t size = _file.size();
+	size_t offset = 12; // After "RIFF", size and "WAVE".
+	bool formatFound = false;
+
+	// Walk chunks: 4 byte id, 4 byte little endian size, body.
+	while (offset + 8 <= size) {
+		const uint8_t* id = bytes + offset;
+		size_t chunkSize = readLE(bytes + offset + 4, 4);
+		size_t body = offset + 8;
+
+		if (std::memcmp(id, "fmt ", 4) == 0) {
+			if (chunkSize < 16 || size - body < 16) {
+				return false;
+			}
+
+			uint32_t format = readLE(bytes + body, 2);
+			uint32_t bitsPerSample = readLE(bytes + body + 14, 2);
+
+			// WAVE_FORMAT_EXTENSIBLE carries the format in its sub format.
+			if (format == 0xFFFE && chunkSize >= 40 && size - body >= 26) {
+				format = readLE(bytes + body + 24, 2);
+			}
+
+			_channels = readLE(bytes + body + 2, 2);
+			_sampleRate = readLE(bytes + body + 4, 4);
+
+			if (format != 1 || bitsPerSample != 16 || _channels == 0) {
+				return false;
+			}
+
+			formatFound = true;
+		} else if (std::memcmp(id, "data", 4) == 0) {
+			if (!formatFound) {
+				return false;
+			}
+
+			// Tolerate a truncated data chunk; replay what is present.
+			_samples = bytes + body;
+			_numSamples = std::min(chunkSize, size - body) / 2;
+			return true;
+		}
+
+		// Chunks are padded to an even size.
+		if (chunkSize > size - body) {
+			break;
+		}
+		offset = body + chunkSize + (chunkSize & 1);
+	}
+
+	return false;
+}
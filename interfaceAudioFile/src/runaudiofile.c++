@@ -0,0 +1,371 @@
+/** @file runaudiofile.c++
+ *  @brief Test public functions from interfaceAudioFile.h
+ *
+ *  @author Aashish Sheshadri
+ *  @author Rohit Harchandani
+ *
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2015, 2016, 2017 PayPal
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+// -----------------
+// standard includes
+// -----------------
+#include <cassert>
+#include <numeric>
+#include <vector>
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <fstream>
+#include <cstdio>
+#include <algorithm>
+
+// ----------------
+// library includes
+// ----------------
+#include "interfaceAudioFile.h"
+
+// -------
+// writeLE
+// -------
+
+/**
+ * @brief Writes a little endian unsigned integer of numBytes bytes.
+ */
+static void writeLE(std::ofstream& file, uint32_t value, size_t numBytes) {
+	for (size_t i = 0; i < numBytes; ++i) {
+		file.put(static_cast<char>((value >> (8 * i)) & 0xFF));
+	}
+}
+
+// --------------
+// writeTestAudio
+// --------------
+
+/**
+ * @brief Writes samples as a WAV file (with an extra chunk before the
+ *        samples) or, if wav is false, as raw little endian int16.
+ */
+static void writeTestAudio(
+	const std::string& path,
+	const std::vector<int16_t>& samples,
+	bool wav,
+	uint32_t sampleRate = 44100,
+	uint32_t channels = 2,
+	uint32_t bitsPerSample = 16
+) {
+	std::ofstream file(path.c_str(), std::ios::binary);
+	uint32_t dataSize = static_cast<uint32_t>(samples.size() * 2);
+
+	if (wav) {
+		file.write("RIFF", 4);
+		writeLE(file, 4 + (8 + 16) + (8 + 3 + 1) + (8 + dataSize), 4);
+		file.write("WAVE", 4);
+
+		file.write("fmt ", 4);
+		writeLE(file, 16, 4);
+		writeLE(file, 1, 2); // PCM
+		writeLE(file, channels, 2);
+		writeLE(file, sampleRate, 4);
+		writeLE(file, sampleRate * channels * bitsPerSample / 8, 4);
+		writeLE(file, channels * bitsPerSample / 8, 2);
+		writeLE(file, bitsPerSample, 2);
+
+		// Odd sized chunk to be skipped, padded to an even size.
+		file.write("note", 4);
+		writeLE(file, 3, 4);
+		file.write("abc\0", 4);
+
+		file.write("data", 4);
+		writeLE(file, dataSize, 4);
+	}
+
+	for (auto it = samples.begin(); it != samples.end(); ++it) {
+		writeLE(file, static_cast<uint16_t>(*it), 2);
+	}
+}
+
+// -----------
+// testSamples
+// -----------
+
+/**
+ * @brief Generates numSamples pseudo random samples of small amplitude.
+ */
+static std::vector<int16_t> testSamples(size_t numSamples) {
+	std::mt19937 generator(7);
+	std::vector<int16_t> samples(numSamples);
+
+	for (auto it = samples.begin(); it != samples.end(); ++it) {
+		*it = static_cast<int16_t>(static_cast<int>(generator() % 2048) - 1024);
+	}
+
+	return samples;
+}
+
+// --------------
+// replayWavValid
+// --------------
+
+/**
+ * @brief Attempt to replay a WAV file; bytes must equal the samples,
+ *        low byte first, as recorded from a microphone.
+ *
+ * @return true, if test passed.
+ */
+int replayWavValid () {
+	std::cerr << "**Running test replayWavValid**" << std::endl;
+
+	std::vector<int16_t> samples = testSamples(100001);
+	writeTestAudio(".test.wav", samples, true);
+
+	InterfaceAudioFile audioFile;
+	bool retVal = audioFile.openFile(".test.wav");
+	retVal = retVal && (audioFile.sampleRate() == 44100);
+	retVal = retVal && (audioFile.channels() == 2);
+	retVal = retVal && (audioFile.remainingSamples() == samples.size());
+
+	// Replay more than available; all samples are replayed once.
+	retVal = retVal && (audioFile.readSamples(200000) == samples.size());
+	retVal = retVal && (audioFile.remainingSamples() == 0);
+
+	std::vector<double> entropy = audioFile.bitEntropy();
+	double meanEntropy = std::accumulate(entropy.begin(), entropy.end(), 0.0);
+	retVal = retVal && (entropy.size() == 16) && (meanEntropy > 0.0);
+
+	std::vector<uint8_t> data;
+	audioFile.moveData(data);
+	retVal = retVal && (data.size() == 2 * samples.size());
+
+	for (size_t i = 0; retVal && i < samples.size(); ++i) {
+		uint16_t sample = static_cast<uint16_t>(samples[i]);
+		retVal = (data[2 * i] == (sample & 0xFF))
+			&& (data[2 * i + 1] == (sample >> 8));
+	}
+
+	audioFile.closeFile();
+	std::remove(".test.wav");
+
+	if (!retVal) {
+		std::cerr << "!!Failed replayWavValid test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return retVal;
+}
+
+// --------------
+// replayRawValid
+// --------------
+
+/**
+ * @brief Attempt to replay raw int16 samples in parts and after a rewind.
+ *
+ * @return true, if test passed.
+ */
+int replayRawValid () {
+	std::cerr << "**Running test replayRawValid**" << std::endl;
+
+	std::vector<int16_t> samples = testSamples(5000);
+	writeTestAudio(".test.pcm", samples, false);
+
+	InterfaceAudioFile audioFile;
+	bool retVal = audioFile.openFile(".test.pcm", 8000, 1);
+	retVal = retVal && (audioFile.sampleRate() == 8000);
+	retVal = retVal && (audioFile.channels() == 1);
+
+	// Replay in two parts.
+	retVal = retVal && (audioFile.readSamples(1234) == 1234);
+	retVal = retVal && (audioFile.readSamples(5000) == 5000 - 1234);
+
+	std::vector<uint8_t> first;
+	audioFile.moveData(first);
+
+	// Replay again from the start.
+	audioFile.rewind();
+	retVal = retVal && (audioFile.readSamples(5000) == 5000);
+
+	std::vector<uint8_t> second;
+	audioFile.moveData(second);
+	retVal = retVal && (first.size() == 10000) && (first == second);
+
+	audioFile.closeFile();
+	std::remove(".test.pcm");
+
+	if (!retVal) {
+		std::cerr << "!!Failed replayRawValid test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return retVal;
+}
+
+// ---------------
+// openFileInvalid
+// ---------------
+
+/**
+ * @brief Attempt to open a missing file and an 8bit WAV file.
+ *
+ * @return true, if test passed.
+ */
+int openFileInvalid () {
+	std::cerr << "**Running test openFileInvalid**" << std::endl;
+
+	InterfaceAudioFile audioFile;
+	bool retVal = !audioFile.openFile("dummy_file_name");
+
+	writeTestAudio(".test.wav", testSamples(100), true, 44100, 2, 8);
+	retVal = retVal && !audioFile.openFile(".test.wav");
+	retVal = retVal && (audioFile.readSamples(100) == 0);
+	std::remove(".test.wav");
+
+	if (!retVal) {
+		std::cerr << "!!Failed openFileInvalid test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return retVal;
+}
+
+// ----------------
+// pacedReplayValid
+// ----------------
+
+/**
+ * @brief Attempt to replay at the file's sample rate; 1600 samples of
+ *        8kHz mono must take ~200ms.
+ *
+ * @return true, if test passed.
+ */
+int pacedReplayValid () {
+	std::cerr << "**Running test pacedReplayValid**" << std::endl;
+
+	writeTestAudio(".test.wav", testSamples(1600), true, 8000, 1);
+
+	InterfaceAudioFile audioFile;
+	bool retVal = audioFile.openFile(".test.wav");
+
+	auto start = std::chrono::steady_clock::now();
+	retVal = retVal && (audioFile.readSamples(1600, true) == 1600);
+	double seconds = std::chrono::duration<double>(
+		std::chrono::steady_clock::now() - start
+	).count();
+
+	retVal = retVal && (seconds > 0.19);
+
+	audioFile.closeFile();
+	std::remove(".test.wav");
+
+	if (!retVal) {
+		std::cerr << "!!Failed pacedReplayValid test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return retVal;
+}
+
+// --------------------
+// noiseBitsPackedValid
+// --------------------
+
+/**
+ * @brief Attempt to replay only the low order noise bits of samples;
+ *        nibbles must be packed two per byte, left minus right differences
+ *        one per frame.
+ *
+ * @return true, if test passed.
+ */
+int noiseBitsPackedValid () {
+	std::cerr << "**Running test noiseBitsPackedValid**" << std::endl;
+
+	std::vector<int16_t> samples = testSamples(10000);
+	writeTestAudio(".test.wav", samples, true);
+
+	InterfaceAudioFile audioFile;
+	bool retVal = audioFile.openFile(".test.wav");
+	retVal = retVal && !audioFile.setNoiseBits(9);
+
+	// 4 noise bits per sample, even sample in the low nibble.
+	retVal = retVal && audioFile.setNoiseBits(4);
+	retVal = retVal && (audioFile.readSamples(samples.size()) == samples.size());
+	retVal = retVal && (audioFile.bitEntropy().size() == 8);
+
+	std::vector<uint8_t> nibbles;
+	audioFile.moveData(nibbles);
+	retVal = retVal && (nibbles.size() == samples.size() / 2);
+
+	for (size_t i = 0; retVal && i < nibbles.size(); ++i) {
+		retVal = (nibbles[i] == ((samples[2 * i] & 0x0F)
+			| ((samples[2 * i + 1] & 0x0F) << 4)));
+	}
+
+	// 8 bits of left minus right per frame.
+	audioFile.rewind();
+	retVal = retVal && audioFile.setNoiseBits(8, true);
+	retVal = retVal && (audioFile.readSamples(samples.size()) == samples.size());
+
+	std::vector<uint8_t> differences;
+	audioFile.moveData(differences);
+	retVal = retVal && (differences.size() == samples.size() / 2);
+
+	for (size_t i = 0; retVal && i < differences.size(); ++i) {
+		retVal = (differences[i]
+			== static_cast<uint8_t>(samples[2 * i] - samples[2 * i + 1]));
+	}
+
+	audioFile.closeFile();
+	std::remove(".test.wav");
+
+	if (!retVal) {
+		std::cerr << "!!Failed noiseBitsPackedValid test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return retVal;
+}
+
+int main() {
+	/* Run tests and count passed.
+	 * Order matters.
+	 */
+	int passed = 0;
+	passed += replayWavValid();
+	passed += replayRawValid();
+	passed += openFileInvalid();
+	passed += pacedReplayValid();
+	passed += noiseBitsPackedValid();
+
+	std::cerr << std::endl;
+	std::cerr << "--Passed " << passed << "/5" << " tests--" << std::endl;
+
+	// Assert passing all tests.
+	assert(passed == 5);
+
+	return 0;
+}
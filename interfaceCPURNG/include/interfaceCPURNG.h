@@ -0,0 +1,172 @@
+/** @file interfaceCPURNG.h
+ *  @brief Interface to the CPU instruction random number generator
+ *         (RDSEED/RDRAND) to gather entropic bytes.
+ *
+ *  @author Aashish Sheshadri
+ *  @author Rohit Harchandani
+ *
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2015, 2016, 2017 PayPal
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef INTERFACECPURNG_H
+#define INTERFACECPURNG_H
+
+// -----------------
+// standard includes
+// -----------------
+#include <vector>
+#include <iterator>
+#include <iostream>
+
+// ----------------
+// library includes
+// ----------------
+#include "randomSource.h"
+#include "bitHistogram.h"
+
+/**
+ * @class InterfaceCPURNG tasked with recording entropic bytes from the CPU
+ *        instruction generator (RDSEED, falling back to RDRAND) and provide
+ *        an entropy estimate per byte. Unavailable on CPUs without the
+ *        instructions.
+ *        Inherits the abstract class RandomSource
+ */
+class InterfaceCPURNG: public RandomSource {
+public:
+
+	// ---------
+	// constants
+	// ---------
+
+	// Attempts per 64bit word before RDSEED is considered exhausted.
+	static const int RDSEED_RETRIES = 100;
+
+	// Attempts per 64bit word before RDRAND is considered failed.
+	static const int RDRAND_RETRIES = 10;
+
+	// -----------
+	// Constructor
+	// -----------
+
+	/**
+	 * Constructor
+	 * @brief Creates InterfaceCPURNG object and detects RDSEED/RDRAND
+	 *        support via CPUID.
+	 */
+	InterfaceCPURNG();
+
+	// ----------
+	// appendData
+	// ----------
+
+	/**
+	 * @brief Appends available entropic data to the vector byte stream.
+	 *        Implementation of pure virtual function from RandomSource.
+	 *
+	 * @param data a reference to a byte vector to be appended with
+	 *        entropic data from the CPU.
+	 *
+	 * @return void
+	 */
+	void appendData(std::vector<uint8_t>& data);
+
+	// --------
+	// moveData
+	// --------
+
+	/**
+	 * @brief Appends available entropic data to the vector byte stream;
+	 *        the recorded buffer is handed over without a copy when data is
+	 *        empty. Override of virtual function from RandomSource.
+	 *
+	 * @param data a reference to a byte vector to be appended with
+	 *        entropic data from the CPU.
+	 *
+	 * @return void
+	 */
+	void moveData(std::vector<uint8_t>& data);
+
+	// ----------
+	// bitEntropy
+	// ----------
+
+	/**
+	 * @brief Returns entropy estimate of CPU random samples as
+	 *        bit occurrence probabilities.
+	 *        Implementation of pure virtual function from RandomSource.
+	 *
+	 * @return double vector with bit occurrence probabilities.
+	 */
+	std::vector<double> bitEntropy();
+
+	// ---------
+	// available
+	// ---------
+
+	/**
+	 * @brief Checks if the CPU supports RDSEED or RDRAND.
+	 *
+	 * @return true, if random bytes can be generated.
+	 */
+	bool available() const;
+
+	// -------------------
+	// generateRandomBytes
+	// -------------------
+
+	/**
+	 * @brief Captures random bytes from the CPU as 64bit words.
+	 *
+	 * @param numBytes size_t with number of bytes to be recorded
+	 *        (default 1MB).
+	 *
+	 * @return true, if bytes were generated successfully.
+	 */
+	bool generateRandomBytes(size_t numBytes = 1024*1024);
+
+private:
+
+	// ----------
+	// randomWord
+	// ----------
+
+	/**
+	 * @brief Generates a 64bit word with bounded retries; RDSEED is tried
+	 *        first, RDRAND if RDSEED is exhausted or unsupported.
+	 *
+	 * @param word reference to a uint64_t to hold the generated word.
+	 *
+	 * @return true, if a word was generated.
+	 */
+	bool randomWord(uint64_t& word);
+
+	// ----
+	// data
+	// ----
+	std::vector<uint8_t> _cpurngData; // Vector of random bytes from CPU.
+	bool _hasRdseed; // CPU supports RDSEED.
+	bool _hasRdrand; // CPU supports RDRAND.
+	BitHistogram<uint8_t> _histogram; // Sample counts for bit estimate.
+};
+
+#endif
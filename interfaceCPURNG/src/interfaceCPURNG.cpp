@@ -0,0 +1,388 @@
+/** @file interfaceCPURNG.cpp
+ *  @brief Interface to the CPU instruction random number generator
+ *         (RDSEED/RDRAND) to gather entropic bytes.
+ *
+ *  @author Aashish Sheshadri
+ *  @author Rohit Harchandani
+ *
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2015, 2016, 2017 PayPal
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+// -----------------
+// standard includes
+// -----------------
+#include <cstring>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+	#include <intrin.h>
+	#include <immintrin.h>
+	#define CPURNG_X86_64 1
+#elif defined(__GNUC__) && defined(__x86_64__)
+	#include <cpuid.h>
+	#define CPURNG_X86_64 1
+#else
+	#define CPURNG_X86_64 0
+#endif
+
+// ----------------
+// library includes
+// ----------------
+#include "interfaceCPURNG.h"
+
+// ----------
+// cpuSupport
+// ----------
+
+/**
+ * @brief Queries CPUID for RDRAND (leaf 1, ECX bit 30) and RDSEED (leaf 7,
+ *        EBX bit 18) support.
+ *
+ * @param rdrand reference to a bool set if RDRAND is supported.
+ * @param rdseed reference to a bool set if RDSEED is supported.
+ *
+ * @return void
+ */
+static void cpuSupport(bool& rdrand, bool& rdseed) {
+	rdrand = false;
+	rdseed = false;
+
+#if CPURNG_X86_64
+#if defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 0);
+	int maxLeaf = info[0];
+
+	__cpuid(info, 1);
+	rdrand = (info[2] >> 30) & 1;
+
+	if (maxLeaf >= 7) {
+		__cpuidex(info, 7, 0);
+		rdseed = (info[1] >> 18) & 1;
+	}
+#else
+	unsigned int eax, ebx, ecx, edx;
+	unsigned int maxLeaf = __get_cpuid_max(0, 0);
+
+	if (__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+		rdrand = (ecx >> 30) & 1;
+	}
+
+	if (maxLeaf >= 7) {
+		__cpuid_count(7, 0, eax, ebx, ecx, edx);
+		rdseed = (ebx >> 18) & 1;
+	}
+#endif
+#endif
+}
+
+// ----------
+// rdseedStep
+// ----------
+
+/**
+ * @brief Executes RDSEED once.
+ *
+ * @param word pointer to a uint64_t to hold the generated word.
+ *
+ * @return true, if the instruction delivered a word.
+ */
+static bool rdseedStep(uint64_t* word) {
+#if CPURNG_X86_64
+#if defined(_MSC_VER)
+	unsigned __int64 value;
+	int ok = _rdseed64_step(&value);
+	*word = value;
+	return ok == 1;
+#else
+	unsigned char ok;
+	__asm__ volatile ("rdseed %0; setc %1" : "=r" (*word), "=qm" (ok) : : "cc");
+	return ok == 1;
+#endif
+#else
+	(void)word;
+	return false;
+#endif
+}
+
+// ----------
+// rdrandStep
+// ----------
+
+/**
+ * @brief Executes RDRAND once.
+ *
+ * @param word pointer to a uint64_t to hold the generated word.
+ *
+ * @return true, if the instruction delivered a word.
+ */
+static bool rdrandStep(uint64_t* word) {
+#if CPURNG_X86_64
+#if defined(_MSC_VER)
+	unsigned __int64 value;
+	int ok = _rdrand64_step(&value);
+	*word = value;
+	return ok == 1;
+#else
+	unsigned char ok;
+	__asm__ volatile ("rdrand %0; setc %1" : "=r" (*word), "=qm" (ok) : : "cc");
+	return ok == 1;
+#endif
+#else
+	(void)word;
+	return false;
+#endif
+}
+
+// -----------
+// Constructor
+// -----------
+
+/**
+ * Constructor
+ * @brief Creates InterfaceCPURNG object and detects RDSEED/RDRAND
+ *        support via CPUID.
+ */
+InterfaceCPURNG::InterfaceCPURNG():
+	_hasRdseed(false),
+	_hasRdrand(false) {
+
+	cpuSupport(_hasRdrand, _hasRdseed);
+
+	/* Some CPUs advertise the instructions but return a constant word (e.g.
+	 * after a faulty firmware resume); treat those as unavailable.
+	 */
+	uint64_t first = 0;
+	uint64_t second = 0;
+
+	/* Both instructions may transiently fail (RDSEED often does under load),
+	 * so each read gets the same bounded retry as randomWord.
+	 */
+	if (_hasRdrand) {
+		bool ok = false;
+		bool okSecond = false;
+		for (int i = 0; i < InterfaceCPURNG::RDRAND_RETRIES && !ok; ++i) {
+			ok = rdrandStep(&first);
+		}
+		for (int i = 0; i < InterfaceCPURNG::RDRAND_RETRIES && ok && !okSecond;
+			++i) {
+			okSecond = rdrandStep(&second);
+		}
+		_hasRdrand = ok && okSecond && (first != second);
+	}
+
+	if (_hasRdseed) {
+		bool ok = false;
+		bool okSecond = false;
+		for (int i = 0; i < InterfaceCPURNG::RDSEED_RETRIES && !ok; ++i) {
+			ok = rdseedStep(&first);
+		}
+		for (int i = 0; i < InterfaceCPURNG::RDSEED_RETRIES && ok && !okSecond;
+			++i) {
+			okSecond = rdseedStep(&second);
+		}
+		_hasRdseed = ok && okSecond && (first != second);
+	}
+}
+
+// ----------
+// appendData
+// ----------
+
+/**
+ * @brief Appends available entropic data to the vector byte stream.
+ *        Implementation of pure virtual function from RandomSource.
+ *
+ * @param data a reference to a byte vector to be appended with
+ *        entropic data from the CPU.
+ *
+ * @return void
+ */
+void InterfaceCPURNG::appendData(std::vector<uint8_t>& data) {
+	try {
+		// Reserve space for data to be appended.
+		data.reserve(data.size() + _cpurngData.size());
+	} catch (const std::bad_alloc& ba) {
+		std::cerr << "[Memory Error] Cannot Append: " << std::endl;
+		return;
+	}
+
+	// Append available entropic data.
+	std::copy(_cpurngData.begin(), _cpurngData.end(), std::back_inserter(data));
+
+	// Clear entropic data and reset sample counts for further captures.
+	_cpurngData.clear();
+	_histogram.reset();
+}
+
+// --------
+// moveData
+// --------
+
+/**
+ * @brief Appends available entropic data to the vector byte stream;
+ *        the recorded buffer is handed over without a copy when data is
+ *        empty. Override of virtual function from RandomSource.
+ *
+ * @param data a reference to a byte vector to be appended with
+ *        entropic data from the CPU.
+ *
+ * @return void
+ */
+void InterfaceCPURNG::moveData(std::vector<uint8_t>& data) {
+
+	// Append by copy if data already holds bytes.
+	if (!data.empty()) {
+		appendData(data);
+		return;
+	}
+
+	// Hand over recorded bytes and release the buffer previously held by data.
+	data.swap(_cpurngData);
+	std::vector<uint8_t>().swap(_cpurngData);
+
+	// Reset sample counts for further captures.
+	_histogram.reset();
+}
+
+// ----------
+// bitEntropy
+// ----------
+
+/**
+ * @brief Returns entropy estimate of CPU random samples as
+ *        bit occurrence probabilities.
+ *        Implementation of pure virtual function from RandomSource.
+ *
+ * @return double vector with bit occurrence probabilities.
+ */
+std::vector<double> InterfaceCPURNG::bitEntropy() {
+	// Derive bit occurrence probabilities from counts of recorded bytes.
+	return _histogram.bitProbabilities();
+}
+
+// ---------
+// available
+// ---------
+
+/**
+ * @brief Checks if the CPU supports RDSEED or RDRAND.
+ *
+ * @return true, if random bytes can be generated.
+ */
+bool InterfaceCPURNG::available() const {
+	return _hasRdseed || _hasRdrand;
+}
+
+// -------------------
+// generateRandomBytes
+// -------------------
+
+/**
+ * @brief Captures random bytes from the CPU as 64bit words.
+ *
+ * @param numBytes size_t with number of bytes to be recorded
+ *        (default 1MB).
+ *
+ * @return true, if bytes were generated successfully.
+ */
+bool InterfaceCPURNG::generateRandomBytes(size_t numBytes) {
+	if (!available()) {
+		return false;
+	}
+
+	// Bytes are written directly after data already recorded.
+	size_t offset = _cpurngData.size();
+
+	try {
+		// Check if data can be held.
+		if (_cpurngData.max_size() - offset < numBytes) {
+			// Update numBytes to max possible.
+			numBytes = _cpurngData.max_size() - offset;
+		}
+
+		_cpurngData.resize(offset + numBytes);
+	} catch (const std::bad_alloc& ba) {
+		std::cerr << "[Memory Error] Samples discarded." << std::endl;
+		return false;
+	}
+
+	uint8_t* output = _cpurngData.data() + offset;
+
+	// Write 64bit words; the last word is truncated to the bytes required.
+	for (size_t written = 0; written < numBytes; written += sizeof(uint64_t)) {
+		uint64_t word;
+
+		if (!randomWord(word)) {
+			std::cerr << "[Failed] CPU RNG failed to generate bytes" << std::endl;
+			_cpurngData.resize(offset);
+			return false;
+		}
+
+		size_t length = numBytes - written;
+		if (length > sizeof(uint64_t)) {
+			length = sizeof(uint64_t);
+		}
+
+		std::memcpy(output + written, &word, length);
+	}
+
+	// Count recorded bytes for the bit occurrence estimate.
+	_histogram.add(output, output + numBytes);
+
+	return true;
+}
+
+// ----------
+// randomWord
+// ----------
+
+/**
+ * @brief Generates a 64bit word with bounded retries; RDSEED is tried
+ *        first, RDRAND if RDSEED is exhausted or unsupported.
+ *
+ * @param word reference to a uint64_t to hold the generated word.
+ *
+ * @return true, if a word was generated.
+ */
+bool InterfaceCPURNG::randomWord(uint64_t& word) {
+
+	// RDSEED underflows when drawn faster than the entropy source refills.
+	if (_hasRdseed) {
+		for (int i = 0; i < InterfaceCPURNG::RDSEED_RETRIES; ++i) {
+			if (rdseedStep(&word)) {
+				return true;
+			}
+		}
+	}
+
+	// RDRAND fails only transiently; retry a few times.
+	if (_hasRdrand) {
+		for (int i = 0; i < InterfaceCPURNG::RDRAND_RETRIES; ++i) {
+			if (rdrandStep(&word)) {
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
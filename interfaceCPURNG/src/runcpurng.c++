@@ -0,0 +1,202 @@
+/** @file runcpurng.c++
+ *  @brief Test public functions from interfaceCPURNG.h
+ *
+ *  @author Aashish Sheshadri
+ *  @author Rohit Harchandani
+ *
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2015, 2016, 2017 PayPal
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+// -----------------
+// standard includes
+// -----------------
+#include <cassert>
+#include <numeric>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+// ----------------
+// library includes
+// ----------------
+#include "interfaceCPURNG.h"
+
+// ---------------
+// appendDataValid
+// ---------------
+
+/**
+ * @brief Attempt to get entropic bytes (recorded from the CPU); capture must
+ *        fail without bytes if RDSEED/RDRAND are unavailable.
+ *
+ * @return true, if test passed.
+ */
+int appendDataValid () {
+	std::cerr << "**Running test appendDataValid**" << std::endl;
+
+	InterfaceCPURNG cpurng;
+	std::vector<uint8_t> data;
+
+	// Attempt to record random bytes from CPU; 3 bytes short of a word.
+	bool status = cpurng.generateRandomBytes(1024*1024 - 3);
+	cpurng.appendData(data);
+
+	bool retVal;
+	if (cpurng.available()) {
+		// Append recorded bytes; sum should be non-zero.
+		size_t sum = std::accumulate(data.begin(), data.end(), 0);
+		retVal = status && (data.size() == 1024*1024 - 3) && (sum > 0);
+	} else {
+		std::cerr << "CPU RNG unavailable" << std::endl;
+		retVal = !status && data.empty();
+	}
+
+	if (!retVal) {
+		std::cerr << "!!Failed appendDataValid test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return retVal;
+}
+
+// -------------------
+// measureEntropyValid
+// -------------------
+
+/**
+ * @brief Attempt to measure bit occurrence probabilities (entropy estimate) on
+ *        recorded bytes from the CPU.
+ *
+ * @return true, if test passed.
+ */
+int measureEntropyValid () {
+	std::cerr << "**Running test measureEntropyValid**" << std::endl;
+
+	InterfaceCPURNG cpurng;
+	bool retVal = true;
+
+	// Record random bytes from CPU.
+	if (cpurng.generateRandomBytes(1024*1024)) {
+		std::vector<double> entropy = cpurng.bitEntropy();
+
+		// Each bit must occur with probability ~0.5.
+		for (auto it = entropy.begin(); it != entropy.end(); ++it) {
+			retVal = retVal && (std::fabs(*it - 0.5) < 0.01);
+		}
+	} else {
+		retVal = !cpurng.available();
+	}
+
+	if (!retVal) {
+		std::cerr << "!!Failed measureEntropyValid test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return retVal;
+}
+
+// -----------------
+// appendDataInvalid
+// -----------------
+
+/**
+ * @brief attempt to get entropic bytes before bytes are available from CPU.
+ *
+ * @return true, if test passed.
+ */
+int appendDataInvalid () {
+	std::cerr << "**Running test appendDataInvalid**" << std::endl;
+
+	InterfaceCPURNG cpurng;
+	std::vector<uint8_t> data;
+
+	// Attempt to get data from cpurng before recording bytes.
+	cpurng.appendData(data);
+	std::vector<double> entropy = cpurng.bitEntropy();
+	double meanEntropy = std::accumulate(entropy.begin(), entropy.end(), 0.0f);
+	bool retVal = data.empty() && (std::fabs(meanEntropy) < 0.01f);
+
+	if (!retVal) {
+		std::cerr << "!!Failed appendDataInvalid test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return retVal;
+}
+
+// -------------
+// moveDataValid
+// -------------
+
+/**
+ * @brief Attempt to take over entropic bytes without a copy; the source must
+ *        be emptied.
+ *
+ * @return true, if test passed.
+ */
+int moveDataValid () {
+	std::cerr << "**Running test moveDataValid**" << std::endl;
+
+	InterfaceCPURNG cpurng;
+	std::vector<uint8_t> data;
+
+	// Take over recorded bytes, if the CPU RNG is available.
+	bool status = cpurng.generateRandomBytes(4096);
+	cpurng.moveData(data);
+	bool retVal = status ? (data.size() == 4096) : data.empty();
+
+	// Nothing is left to take over.
+	std::vector<uint8_t> rest;
+	cpurng.moveData(rest);
+	retVal = retVal && rest.empty();
+
+	if (!retVal) {
+		std::cerr << "!!Failed moveDataValid test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return retVal;
+}
+
+int main() {
+	/* Run tests and count passed.
+	 * Order matters.
+	 */
+	int passed = 0;
+	passed += appendDataValid();
+	passed += measureEntropyValid();
+	passed += appendDataInvalid();
+	passed += moveDataValid();
+
+	std::cerr << std::endl;
+	std::cerr << "--Passed " << passed << "/4" << " tests--" << std::endl;
+
+	// Assert passing all tests.
+	assert(passed == 4);
+
+	return 0;
+}
@@ -41,6 +41,7 @@
 #include <sstream>
 #include <iomanip>
 #include <iostream>
+#include <atomic>
 
 // --------------------
 // third party includes
@@ -52,6 +53,9 @@
 // library includes
 // ----------------
 #include "randomSource.h"
+#include "bitHistogram.h"
+#include "frameToBytes.h"
+#include "boundedQueue.h"
 
 // ---------------
 // InterfaceCamera
@@ -65,6 +69,17 @@
 class InterfaceCamera: public RandomSource {
 public:
 
+	// ---------
+	// constants
+	// ---------
+
+	// Frames grabbed without decoding after opening the camera, while
+	// exposure settles.
+	static const size_t CAMERA_WARMUP_FRAMES = 2;
+
+	// Captured frames waiting to be converted; capture waits while full.
+	static const size_t CAMERA_QUEUE_DEPTH = 4;
+
 	// -----------
 	// Constructor
 	// -----------
@@ -75,6 +90,16 @@ public:
      */
 	InterfaceCamera();
 
+	// ----------
+	// Destructor
+	// ----------
+
+	/**
+	 * Destructor
+	 * @brief Releases the camera if it is open.
+	 */
+	~InterfaceCamera();
+
 	// ----------
 	// appendData
 	// ----------
@@ -90,6 +115,22 @@ public:
 	 */
 	void appendData(std::vector<uint8_t>& data);
 
+	// --------
+	// moveData
+	// --------
+
+	/**
+	 * @brief Appends available entropic data to the vector byte stream;
+	 *        the recorded buffer is handed over without a copy when data is
+	 *        empty. Override of virtual function from RandomSource.
+	 *
+	 * @param data a reference to a byte vector to be appended with
+	 *        entropic data from the camera.
+	 *
+	 * @return void
+	 */
+	void moveData(std::vector<uint8_t>& data);
+
 	// ----------
 	// bitEntropy
 	// ----------
@@ -103,13 +144,43 @@ public:
 	 */
 	std::vector<double> bitEntropy();
 
+	// ------------
+	// setNoiseBits
+	// ------------
+
+	/**
+	 * @brief Selects how frames are recorded: whole frames (0) or only the
+	 *        noiseBits low order bits of the differences between
+	 *        consecutive frames of a burst, packed into bytes. Differencing
+	 *        cancels static scene content and keeps sensor noise, shrinking
+	 *        the data. The bit estimate then covers the packed bytes.
+	 *
+	 * @param noiseBits unsigned with low order bits kept per residual, at
+	 *        most NoiseBitPacker::MAX_NOISE_BITS; 0 records whole frames.
+	 * @param gridStep size_t; only every gridStep-th row and column of a
+	 *        frame is differenced (default 1, all pixels).
+	 * @param region const reference to a Rect limiting the differenced
+	 *        pixels (default empty, the whole frame).
+	 *
+	 * @return true, if the mode was set.
+	 */
+	bool setNoiseBits(
+		unsigned noiseBits,
+		size_t gridStep = 1,
+		const cv::Rect& region = cv::Rect()
+	);
+
 	// -------------
 	// captureFrames
 	// -------------
 
 	/**
 	 * @brief Captures frames from a specific camera device. Must be called
-	 *        sucessfully before accessing bytes or entropy estimate.
+	 *        sucessfully before accessing bytes or entropy estimate. The
+	 *        camera is opened once and kept open across calls until
+	 *        release, or until a different device is requested. Frames
+	 *        are captured on the calling thread and converted by a worker
+	 *        thread, handed over through a queue of bounded depth.
 	 *
 	 * @param numFrames size_t with num frames to be captured (default 10).
 	 * @param device int camera device identifier to be used (default 0).
@@ -118,37 +189,89 @@ public:
 	 */
 	bool captureFrames(size_t numFrames = 10, int device = 0);
 
+	// -------
+	// release
+	// -------
+
+	/**
+	 * @brief Releases the camera; the next capture opens it again.
+	 *
+	 * @return void
+	 */
+	void release();
+
+	// ------
+	// isOpen
+	// ------
+
+	/**
+	 * @brief Returns whether a camera is held open.
+	 *
+	 * @return true, if a camera is open.
+	 */
+	bool isOpen() const;
+
+	// -------------
+	// setQueueDepth
+	// -------------
+
+	/**
+	 * @brief Sets the number of captured frames that may wait for
+	 *        conversion; capture waits while the queue is full, which
+	 *        bounds memory to depth frames.
+	 *
+	 * @param depth size_t with maximum frames queued (at least 1).
+	 *
+	 * @return true, if the depth was set.
+	 */
+	bool setQueueDepth(size_t depth);
+
 private:
 
 	// -------------
-	// captureHelper
+	// CapturedFrame
 	// -------------
 
+	// Frame handed from capture to conversion with its position in a burst.
+	struct CapturedFrame {
+		cv::Mat image;
+		int shot;
+	};
+
+	// ----------
+	// openDevice
+	// ----------
+
 	/**
-	 * @brief Helper to captureFrames to interact with the camera.
+	 * @brief Opens a camera device and sets capture properties, unless it
+	 *        is already open; frames taken while exposure settles are
+	 *        grabbed without decoding.
 	 *
-	 * @param device int with camera device identifier
+	 * @param device int with camera device identifier.
 	 *
-	 * @return true if frames were captured sucessfully
+	 * @return true, if the camera is open.
 	 */
-	bool captureHelper(int device);
+	bool openDevice(int device);
 
-	// ------------
-	// int16toBytes
-	// ------------
+	// ---------------
+	// conditionFrames
+	// ---------------
 
 	/**
-	 * @brief Converts an int16 stream to a byte stream and records bit
-	 *        occurrence over the int16 sample.
+	 * @brief Runs on the conversion worker; records queued frames, or in
+	 *        noise bit mode the differences of consecutive frames of a
+	 *        burst, until the queue is closed and empty.
 	 *
-	 * @param begin input iterator to the beginning of the int16 stream.
-	 * @param end input iterator to the end of the int16 stream.
-	 * @param out output iterator to record bytes from the int16 stream.
+	 * @param queue reference to the queue of captured frames.
+	 * @param converted reference to an atomic bool, cleared when a frame
+	 *        cannot be recorded.
 	 *
 	 * @return void
 	 */
-	template <typename II, typename OI>
-	void int16toBytes(II begin, II end, OI out);
+	void conditionFrames(
+		BoundedQueue<CapturedFrame>& queue,
+		std::atomic<bool>& converted
+	);
 
 	// ----
 	// data
@@ -157,70 +280,15 @@ private:
 	std::vector<uint8_t> _cameraData; // Vector of random bytes from camera.
 	int _contShootCount; // Number of frames per activation of the camera.
 	int _exp; // Exposure of the camera.
-	std::vector<double> _bitEntropy; // Bit occurrence probabilites of data.
-	std::vector<std::vector<uint8_t> > _bitCountCache; /* Cache: Bit occurrences
-													    * in sample space.
-													    */
+	cv::VideoCapture _capture; // Camera kept open across captures.
+	int _device; // Identifier of the open camera, -1 if none.
+	BitHistogram<uint16_t> _histogram; // Sample counts for bit estimate.
+	unsigned _noiseBits; // Low order bits kept per residual, 0 for frames.
+	size_t _gridStep; // Row and column step of differenced pixels.
+	cv::Rect _region; // Differenced pixels, empty for the whole frame.
+	NoiseBitPacker _packer; // Packs noise bits of residuals.
+	BitHistogram<uint8_t> _packedHistogram; // Counts of packed bytes.
+	size_t _queueDepth; // Captured frames that may wait for conversion.
 };
 
-// ------------
-// int16toBytes
-// ------------
-
-/**
- * @brief Converts an int16 stream to a byte stream and records bit
- *        occurrence over the int16 sample.
- *
- * @param begin input iterator to the beginning of the int16 stream.
- * @param end input iterator to the end of the int16 stream.
- * @param out output iterator to record bytes from the int16 stream.
- *
- * @return void
- */
-template <typename II, typename OI>
-void InterfaceCamera::int16toBytes(II begin, II end, OI out) {
-
-	// Loop through int16 stream.
-	while (begin != end){
-
-		uint16_t sample = static_cast<uint16_t>(*begin);
-
-		// Check if sample has been encountered before.
-		if (_bitCountCache[sample].empty()) {
-			uint16_t temp = sample;
-			uint8_t bitPos = 0;
-
-			// Compute and record set bits in the sample
-			while (temp) {
-
-				if (temp & 1) {
-					_bitCountCache[sample].push_back(bitPos);
-				}
-
-				temp = temp >> 1;
-				bitPos = bitPos + 1;
-			}
-		}
-
-		/* Update _bitEntropy with occurrences of set bits in the sample from
-		 * the cache.
-		 */
-		auto cachedSample = _bitCountCache[sample];
-
-		std::for_each (
-			cachedSample.begin(),
-			cachedSample.end(),
-			[this] (uint8_t val) {
-				_bitEntropy[val] = _bitEntropy[val] + 1;
-			}
-		);
-
-		// Convert int16 to bytes and load them into out.
-		*out = static_cast<uint8_t>(*begin & uint16_t(0x00FF));
-		++out;
-		*out = static_cast<uint8_t>((*begin & uint16_t(0xFF00)) >> 8);
-		++begin;
-	}
-}
-
 #endif
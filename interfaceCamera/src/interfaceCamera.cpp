@@ -34,6 +34,8 @@
 #include <numeric>
 #include <algorithm>
 #include <sstream>
+#include <thread>
+#include <system_error>
 
 // ----------------
 // library includes
@@ -51,11 +53,25 @@
 InterfaceCamera::InterfaceCamera():
 	_contShootCount(4), // Images per frame set to 4.
 	_exp(2), // Camera exposure param set to 2.
-	_bitEntropy(16,0.0f), // Bit occurrence probabilities initialized to 0.
-	_bitCountCache(65536) { // Cache to accommodate 16bit sample space.
+	_device(-1), // No camera open yet.
+	_noiseBits(0), // Record whole frames.
+	_gridStep(1), // Difference all pixels when enabled.
+	_queueDepth(InterfaceCamera::CAMERA_QUEUE_DEPTH) { // Frames in flight.
 
 }
 
+// ----------
+// Destructor
+// ----------
+
+/**
+ * Destructor
+ * @brief Releases the camera if it is open.
+ */
+InterfaceCamera::~InterfaceCamera() {
+	release();
+}
+
 // ----------
 // appendData
 // ----------
@@ -79,9 +95,41 @@ void InterfaceCamera::appendData(std::vector<uint8_t>& data) {
 	}
 	std::copy(_cameraData.begin(), _cameraData.end(), std::back_inserter(data));
 
-	// Clear entropic data.
+	// Clear entropic data and reset sample counts for further captures.
 	_cameraData.clear();
-	_bitEntropy.clear();
+	_histogram.reset();
+	_packedHistogram.reset();
+}
+
+// --------
+// moveData
+// --------
+
+/**
+ * @brief Appends available entropic data to the vector byte stream;
+ *        the recorded buffer is handed over without a copy when data is
+ *        empty. Override of virtual function from RandomSource.
+ *
+ * @param data a reference to a byte vector to be appended with
+ *        entropic data from the camera.
+ *
+ * @return void
+ */
+void InterfaceCamera::moveData(std::vector<uint8_t>& data) {
+
+	// Append by copy if data already holds bytes.
+	if (!data.empty()) {
+		appendData(data);
+		return;
+	}
+
+	// Hand over recorded bytes and release the buffer previously held by data.
+	data.swap(_cameraData);
+	std::vector<uint8_t>().swap(_cameraData);
+
+	// Reset sample counts for further captures.
+	_histogram.reset();
+	_packedHistogram.reset();
 }
 
 // ----------
@@ -96,27 +144,49 @@ void InterfaceCamera::appendData(std::vector<uint8_t>& data) {
  * @return double vector with bit occurrence probabilities.
  */
 std::vector<double> InterfaceCamera::bitEntropy() {
-	// Compute present entropy estimate.
-	auto tempEntropy = _bitEntropy;
+	// Derive bit occurrence probabilities from counts of recorded samples.
+	if (_noiseBits != 0) {
+		return _packedHistogram.bitProbabilities();
+	}
+
+	return _histogram.bitProbabilities();
+}
 
-	// Normalize to compute bit occurrence probabilities.
-	double normalizer = static_cast<double>(_cameraData.size() / 2.0f);
+// ------------
+// setNoiseBits
+// ------------
 
-	if (std::fabs(normalizer)<0.01) {
-		normalizer = 1.0f;
+/**
+ * @brief Selects how frames are recorded: whole frames (0) or only the
+ *        noiseBits low order bits of the differences between
+ *        consecutive frames of a burst, packed into bytes. Differencing
+ *        cancels static scene content and keeps sensor noise, shrinking
+ *        the data. The bit estimate then covers the packed bytes.
+ *
+ * @param noiseBits unsigned with low order bits kept per residual, at
+ *        most NoiseBitPacker::MAX_NOISE_BITS; 0 records whole frames.
+ * @param gridStep size_t; only every gridStep-th row and column of a
+ *        frame is differenced (default 1, all pixels).
+ * @param region const reference to a Rect limiting the differenced
+ *        pixels (default empty, the whole frame).
+ *
+ * @return true, if the mode was set.
+ */
+bool InterfaceCamera::setNoiseBits(
+	unsigned noiseBits,
+	size_t gridStep,
+	const cv::Rect& region
+) {
+	if (noiseBits > NoiseBitPacker::MAX_NOISE_BITS || gridStep == 0) {
+		return false;
 	}
 
-	std::transform(
-		tempEntropy.begin(),
-		tempEntropy.end(),
-		tempEntropy.begin(),
-		[normalizer] (double val) {
-			return val / normalizer;
-		}
-	);
+	_noiseBits = noiseBits;
+	_gridStep = gridStep;
+	_region = region;
+	_packer = NoiseBitPacker(noiseBits);
 
-	// Return bit occurrence probabilities of entropic data.
-	return tempEntropy;
+	return true;
 }
 
 // -------------
@@ -125,7 +195,11 @@ std::vector<double> InterfaceCamera::bitEntropy() {
 
 /**
  * @brief Captures frames from a specific camera device. Must be called
- *        sucessfully before accessing bytes or entropy estimate.
+ *        sucessfully before accessing bytes or entropy estimate. The
+ *        camera is opened once and kept open across calls until
+ *        release, or until a different device is requested. Frames
+ *        are captured on the calling thread and converted by a worker
+ *        thread, handed over through a queue of bounded depth.
  *
  * @param numFrames size_t with num frames to be captured (default 10).
  * @param device int camera device identifier to be used (default 0).
@@ -133,78 +207,222 @@ std::vector<double> InterfaceCamera::bitEntropy() {
  * @return true, if frames are sucessfully captured.
  */
 bool InterfaceCamera::captureFrames(size_t numFrames, int device) {
-	bool sucess = true;
+	if (!openDevice(device)) {
+		return false;
+	}
+
+	// Residuals of a new capture are packed from scratch.
+	_packer.reset();
+
+	BoundedQueue<CapturedFrame> queue(_queueDepth);
+	std::atomic<bool> converted(true);
+	std::thread conditioner;
+
+	try {
+		conditioner = std::thread(
+			&InterfaceCamera::conditionFrames,
+			this,
+			std::ref(queue),
+			std::ref(converted)
+		);
+	} catch (const std::system_error& e) {
+		std::cerr << "Unable to start frame worker" << std::endl;
+		return false;
+	}
+
+	bool captured = true;
+
+	// Capture numFrames bursts; waits while the worker is behind.
+	for (size_t frame = 0; frame < numFrames && captured && converted; ++frame) {
+		for (int shot = 0; shot < _contShootCount && captured; ++shot) {
+			CapturedFrame capturedFrame;
+			capturedFrame.shot = shot;
 
-	// Call helper to capture numFrames.
-	while (numFrames > 0) {
-		sucess = sucess && captureHelper(device);
-		--numFrames;
+			// Stop capturing once the worker failed.
+			if (!converted) {
+				break;
+			}
+
+			// Capture image; decode only frames that are recorded.
+			captured = _capture.grab()
+				&& _capture.retrieve(capturedFrame.image);
+
+			if (captured) {
+				queue.push(std::move(capturedFrame));
+			}
+		}
+	}
+
+	// Let the worker record the frames left.
+	queue.close();
+	conditioner.join();
+
+	bool sucess = captured && converted;
+
+	if (!captured) {
+		std::cerr << "Unable to capture frame" << std::endl;
+	}
+
+	// A failing camera is opened again by the next capture.
+	if (!sucess) {
+		release();
 	}
 
 	return sucess;
 }
 
+// -------
+// release
+// -------
+
+/**
+ * @brief Releases the camera; the next capture opens it again.
+ *
+ * @return void
+ */
+void InterfaceCamera::release() {
+	if (_device != -1) {
+		_capture.release();
+		_device = -1;
+	}
+}
+
+// ------
+// isOpen
+// ------
+
+/**
+ * @brief Returns whether a camera is held open.
+ *
+ * @return true, if a camera is open.
+ */
+bool InterfaceCamera::isOpen() const {
+	return _device != -1;
+}
+
 // -------------
-// captureHelper
+// setQueueDepth
 // -------------
 
 /**
- * @brief Helper to captureFrames to interact with the camera.
+ * @brief Sets the number of captured frames that may wait for
+ *        conversion; capture waits while the queue is full, which
+ *        bounds memory to depth frames.
+ *
+ * @param depth size_t with maximum frames queued (at least 1).
+ *
+ * @return true, if the depth was set.
+ */
+bool InterfaceCamera::setQueueDepth(size_t depth) {
+	if (depth == 0) {
+		return false;
+	}
+
+	_queueDepth = depth;
+
+	return true;
+}
+
+// ----------
+// openDevice
+// ----------
+
+/**
+ * @brief Opens a camera device and sets capture properties, unless it
+ *        is already open; frames taken while exposure settles are
+ *        grabbed without decoding.
  *
- * @param device int with camera device identifier
+ * @param device int with camera device identifier.
  *
- * @return true if frames were captured sucessfully
+ * @return true, if the camera is open.
  */
-bool InterfaceCamera::captureHelper(int device) {
-	// Instantiate capture device.
-	cv::VideoCapture cap(device);
+bool InterfaceCamera::openDevice(int device) {
+	// Keep the open camera.
+	if (_device == device) {
+		return true;
+	}
+
+	release();
 
-	if (!cap.isOpened()) {
+	if (!_capture.open(device) || !_capture.isOpened()) {
 		std::cerr << "Unable to open camera" <<std::endl;
+		_capture.release();
 		return false;
 	}
 
 	// Set capture exposure properties.
-	cap.set(CV_CAP_PROP_EXPOSURE, _exp);
+	_capture.set(CV_CAP_PROP_EXPOSURE, _exp);
 
 	// Set capture format to 3 channel signed 16 bit samples.
-	cap.set(CV_CAP_PROP_FORMAT, CV_16SC3);
+	_capture.set(CV_CAP_PROP_FORMAT, CV_16SC3);
 
-	for (int i = 0; i < _contShootCount; ++i) {
+	// Skip frames while exposure settles; grabbing does not decode.
+	for (size_t i = 0; i < InterfaceCamera::CAMERA_WARMUP_FRAMES; ++i) {
+		_capture.grab();
+	}
 
-		cv::Mat streamImage;
-		cap >> streamImage; // Capture image.
+	_device = device;
 
-		// Compute storage required for image.
-		size_t additionalStorage = (
-			streamImage.cols   // image rows
-			* streamImage.rows // image cols
-			* 2                // int16 sample
-			* 3               // BGR channels
-		);
+	return true;
+}
+
+// ---------------
+// conditionFrames
+// ---------------
 
-		// Compute total storage required.
-		size_t requiredStorage = _cameraData.size() + additionalStorage;
+/**
+ * @brief Runs on the conversion worker; records queued frames, or in
+ *        noise bit mode the differences of consecutive frames of a
+ *        burst, until the queue is closed and empty.
+ *
+ * @param queue reference to the queue of captured frames.
+ * @param converted reference to an atomic bool, cleared when a frame
+ *        cannot be recorded.
+ *
+ * @return void
+ */
+void InterfaceCamera::conditionFrames(
+	BoundedQueue<CapturedFrame>& queue,
+	std::atomic<bool>& converted
+) {
+	CapturedFrame capturedFrame;
+	cv::Mat previousImage; // Frame before in the burst.
+	std::vector<int16_t> residuals;
 
-		// Check if data can be held.
-		if (_cameraData.max_size() < requiredStorage) {
-			std::cerr << "[Max Capacity] Samples discarded: " << std::endl;
-			break; // cannot hold new data
+	while (queue.pop(capturedFrame)) {
+		// Drain frames queued after a failure.
+		if (!converted) {
+			continue;
 		}
 
-		try {
-			_cameraData.reserve(requiredStorage);
-			// Convert samples to bytes to be loaded into _cameraData.
-			int16toBytes(
-				streamImage.begin<int16_t>(),
-				streamImage.end<int16_t>(),
-				std::back_inserter(_cameraData)
+		bool recorded = true;
+
+		if (_noiseBits == 0) {
+			// Record samples of the frame and count them.
+			recorded = frameToBytes(
+				capturedFrame.image,
+				_cameraData,
+				_histogram
+			);
+		} else if (capturedFrame.shot > 0) {
+			// The first frame of a burst is only differenced against.
+			recorded = frameDifferenceBits(
+				previousImage,
+				capturedFrame.image,
+				_gridStep,
+				_region,
+				residuals,
+				_packer,
+				_cameraData,
+				_packedHistogram
 			);
+		}
 
-		} catch (const std::bad_alloc& ba) {
-			std::cerr << "[Memory Error] Samples discarded: " << std::endl;
-			return false;
+		if (!recorded) {
+			converted = false;
 		}
+
+		// Each captured frame has its own buffer.
+		previousImage = capturedFrame.image;
 	}
-	return true;
 }
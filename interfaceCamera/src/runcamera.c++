@@ -217,6 +217,145 @@ int measureEntropyInvalid () {
 	return retVal;
 }
 
+// -------------
+// moveDataValid
+// -------------
+
+/**
+ * @brief Attempt to take over entropic bytes without a copy; the source must
+ *        be emptied.
+ *
+ * @return true, if test passed.
+ */
+int moveDataValid () {
+	std::cerr << "**Running test moveDataValid**" << std::endl;
+
+	InterfaceCamera camera;
+
+	// Capture frames.
+	camera.captureFrames(2);
+	std::vector<uint8_t> data;
+
+	// Take over recorded bytes; sum should be non-zero.
+	camera.moveData(data);
+	size_t sum = std::accumulate(data.begin(), data.end(), 0);
+	bool retVal = (sum > 0);
+
+	// Nothing is left to take over and the entropy estimate is reset.
+	std::vector<uint8_t> rest;
+	camera.moveData(rest);
+	std::vector<double> entropy = camera.bitEntropy();
+	double meanEntropy = std::accumulate(entropy.begin(), entropy.end(), 0.0f);
+	retVal = retVal && rest.empty() && (std::fabs(meanEntropy) < 0.01f);
+
+	if (!retVal) {
+		std::cerr << "!!Failed moveDataValid test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return retVal;
+}
+
+// -----------------
+// persistentCapture
+// -----------------
+
+/**
+ * @brief Attempt to capture repeatedly through one open camera; release
+ *        closes it and the next capture opens it again.
+ *
+ * @return true, if test passed.
+ */
+int persistentCapture () {
+	std::cerr << "**Running test persistentCapture**" << std::endl;
+
+	InterfaceCamera camera;
+
+	bool retVal = !camera.isOpen();
+	retVal = retVal && camera.captureFrames(1) && camera.isOpen();
+	retVal = retVal && camera.captureFrames(2) && camera.isOpen();
+
+	camera.release();
+	retVal = retVal && !camera.isOpen();
+	retVal = retVal && camera.captureFrames(1) && camera.isOpen();
+
+	if (!retVal) {
+		std::cerr << "!!Failed persistentCapture test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return retVal;
+}
+
+// ----------------------
+// noiseBitsResidualValid
+// ----------------------
+
+/**
+ * @brief Attempt to record packed noise bits of frame differences on a
+ *        subsampled grid; the estimate covers packed bytes.
+ *
+ * @return true, if test passed.
+ */
+int noiseBitsResidualValid () {
+	std::cerr << "**Running test noiseBitsResidualValid**" << std::endl;
+
+	InterfaceCamera camera;
+
+	bool retVal = !camera.setNoiseBits(NoiseBitPacker::MAX_NOISE_BITS + 1);
+	retVal = retVal && !camera.setNoiseBits(4, 0);
+	retVal = retVal && camera.setNoiseBits(4, 2);
+	retVal = retVal && camera.captureFrames(2);
+
+	std::vector<double> entropy = camera.bitEntropy();
+	std::vector<uint8_t> data;
+	camera.moveData(data);
+
+	retVal = retVal && (entropy.size() == 8) && !data.empty();
+
+	if (!retVal) {
+		std::cerr << "!!Failed noiseBitsResidualValid test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return retVal;
+}
+
+// ---------------
+// queueDepthValid
+// ---------------
+
+/**
+ * @brief Attempt to capture through a queue of a single frame; capture
+ *        must wait for conversion and still record every frame.
+ *
+ * @return true, if test passed.
+ */
+int queueDepthValid () {
+	std::cerr << "**Running test queueDepthValid**" << std::endl;
+
+	InterfaceCamera camera;
+
+	bool retVal = !camera.setQueueDepth(0);
+	retVal = retVal && camera.setQueueDepth(1);
+	retVal = retVal && camera.captureFrames(3);
+
+	std::vector<uint8_t> data;
+	camera.moveData(data);
+	retVal = retVal && !data.empty();
+
+	if (!retVal) {
+		std::cerr << "!!Failed queueDepthValid test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return retVal;
+}
+
 int main(){
 	/* Run tests and count passed.
 	 * Order matters.
@@ -227,12 +366,16 @@ int main(){
 	passed += measureEntropyValid();
 	passed += appendDataInvalid();
 	passed += measureEntropyInvalid();
+	passed += moveDataValid();
+	passed += persistentCapture();
+	passed += noiseBitsResidualValid();
+	passed += queueDepthValid();
 
 
 	std::cerr << std::endl;
-	std::cerr << "--Passed " << passed << "/5" << " tests--" << std::endl;
+	std::cerr << "--Passed " << passed << "/9" << " tests--" << std::endl;
 
 	// Assert passing all tests.
-	assert(passed == 5);
+	assert(passed == 9);
 	return 0;
 }
\ No newline at end of file
@@ -0,0 +1,191 @@
+/** @file interfaceJitter.h
+ *  @brief Interface to CPU timing jitter of memory access and compute loops
+ *         to gather entropic bytes.
+ *
+ *  @author Aashish Sheshadri
+ *  @author Rohit Harchandani
+ *
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2015, 2016, 2017 PayPal
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef INTERFACEJITTER_H
+#define INTERFACEJITTER_H
+
+// -----------------
+// standard includes
+// -----------------
+#include <vector>
+#include <iterator>
+#include <iostream>
+
+// ----------------
+// library includes
+// ----------------
+#include "randomSource.h"
+#include "bitHistogram.h"
+
+/**
+ * @class InterfaceJitter tasked with recording entropic bytes from timing
+ *        jitter of tight memory access and compute loops and provide an
+ *        entropy estimate per byte. Each timing delta is folded to a byte.
+ *        Inherits the abstract class RandomSource
+ */
+class InterfaceJitter: public RandomSource {
+public:
+
+	// ---------
+	// constants
+	// ---------
+
+	// Size in bytes of the memory walked per sample (power of 2).
+	static const size_t JITTER_MEMORY_SIZE = 1024*1024;
+
+	// Number of memory accesses per sample.
+	static const size_t JITTER_ACCESS_LOOPS = 128;
+
+	// Consecutive stuck samples tolerated before collection fails.
+	static const size_t JITTER_STUCK_LIMIT = 1024;
+
+	// Samples taken by the health check on construction.
+	static const size_t JITTER_HEALTH_SAMPLES = 512;
+
+	// Minimum bytes per worker thread of a parallel capture.
+	static const size_t JITTER_THREAD_MIN_BYTES = 4096;
+
+	// -----------
+	// Constructor
+	// -----------
+
+	/**
+	 * Constructor
+	 * @brief Creates InterfaceJitter object and checks that the timer
+	 *        exhibits usable jitter.
+	 */
+	InterfaceJitter();
+
+	// ----------
+	// appendData
+	// ----------
+
+	/**
+	 * @brief Appends available entropic data to the vector byte stream.
+	 *        Implementation of pure virtual function from RandomSource.
+	 *
+	 * @param data a reference to a byte vector to be appended with
+	 *        entropic data from timing jitter.
+	 *
+	 * @return void
+	 */
+	void appendData(std::vector<uint8_t>& data);
+
+	// --------
+	// moveData
+	// --------
+
+	/**
+	 * @brief Appends available entropic data to the vector byte stream;
+	 *        the recorded buffer is handed over without a copy when data is
+	 *        empty. Override of virtual function from RandomSource.
+	 *
+	 * @param data a reference to a byte vector to be appended with
+	 *        entropic data from timing jitter.
+	 *
+	 * @return void
+	 */
+	void moveData(std::vector<uint8_t>& data);
+
+	// ----------
+	// bitEntropy
+	// ----------
+
+	/**
+	 * @brief Returns entropy estimate of timing jitter samples as
+	 *        bit occurrence probabilities.
+	 *        Implementation of pure virtual function from RandomSource.
+	 *
+	 * @return double vector with bit occurrence probabilities.
+	 */
+	std::vector<double> bitEntropy();
+
+	// ---------
+	// available
+	// ---------
+
+	/**
+	 * @brief Checks if the health check on construction found usable
+	 *        jitter, i.e. a fine grained timer and few stuck samples.
+	 *
+	 * @return true, if random bytes can be generated.
+	 */
+	bool available() const;
+
+	// -------------------
+	// generateRandomBytes
+	// -------------------
+
+	/**
+	 * @brief Captures random bytes from timing jitter, one folded timing
+	 *        delta per byte. The request can be split across worker threads,
+	 *        each walking its own memory and keeping its own sample counts.
+	 *
+	 * @param numBytes size_t with number of bytes to be recorded
+	 *        (default 64KB).
+	 * @param numThreads size_t with number of worker threads; 0 uses the
+	 *        hardware concurrency (default 1). Each thread records at least
+	 *        JITTER_THREAD_MIN_BYTES.
+	 *
+	 * @return true, if bytes were generated successfully.
+	 */
+	bool generateRandomBytes(size_t numBytes = 64*1024, size_t numThreads = 1);
+
+private:
+
+	// -------
+	// collect
+	// -------
+
+	/**
+	 * @brief Records numBytes folded timing deltas; samples whose delta or
+	 *        first/second order differences are zero are discarded.
+	 *
+	 * @param output pointer to memory to hold numBytes bytes.
+	 * @param numBytes size_t with number of bytes to record.
+	 * @param histogram reference to a BitHistogram counting the bytes.
+	 *
+	 * @return true, if numBytes bytes were recorded.
+	 */
+	static bool collect(
+		uint8_t* output,
+		size_t numBytes,
+		BitHistogram<uint8_t>& histogram
+	);
+
+	// ----
+	// data
+	// ----
+	std::vector<uint8_t> _jitterData; // Vector of folded timing deltas.
+	bool _available; // Health check result.
+	BitHistogram<uint8_t> _histogram; // Sample counts for bit estimate.
+};
+
+#endif
@@ -0,0 +1,382 @@
+/** @file interfaceJitter.cpp
+ *  @brief Interface to CPU timing jitter of memory access and compute loops
+ *         to gather entropic bytes.
+ *
+ *  @author Aashish Sheshadri
+ *  @author Rohit Harchandani
+ *
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2015, 2016, 2017 PayPal
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+// -----------------
+// standard includes
+// -----------------
+#include <thread>
+#include <system_error>
+#include <chrono>
+#include <time.h>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+	#include <intrin.h>
+	#define JITTER_RDTSC 1
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	#include <x86intrin.h>
+	#define JITTER_RDTSC 1
+#else
+	#define JITTER_RDTSC 0
+#endif
+
+// ----------------
+// library includes
+// ----------------
+#include "interfaceJitter.h"
+
+// ---------
+// timestamp
+// ---------
+
+/**
+ * @brief Reads the finest timer available; the time stamp counter on x86,
+ *        the monotonic clock elsewhere.
+ *
+ * @return uint64_t with the current timer value.
+ */
+static uint64_t timestamp() {
+#if JITTER_RDTSC
+	return static_cast<uint64_t>(__rdtsc());
+#elif defined(CLOCK_MONOTONIC)
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return static_cast<uint64_t>(now.tv_sec) * 1000000000ULL
+		+ static_cast<uint64_t>(now.tv_nsec);
+#else
+	return static_cast<uint64_t>(
+		std::chrono::high_resolution_clock::now().time_since_epoch().count()
+	);
+#endif
+}
+
+// -----------
+// Constructor
+// -----------
+
+/**
+ * Constructor
+ * @brief Creates InterfaceJitter object and checks that the timer
+ *        exhibits usable jitter.
+ */
+InterfaceJitter::InterfaceJitter():
+	_available(false) {
+
+	std::vector<uint8_t> samples(InterfaceJitter::JITTER_HEALTH_SAMPLES);
+	BitHistogram<uint8_t> histogram;
+
+	// Timer must not get stuck and folded deltas must not be near constant.
+	if (collect(samples.data(), samples.size(), histogram)) {
+		std::vector<double> probabilities = histogram.bitProbabilities();
+		size_t varyingBits = 0;
+
+		for (auto it = probabilities.begin(); it != probabilities.end(); ++it) {
+			if (*it > 0.1 && *it < 0.9) {
+				varyingBits = varyingBits + 1;
+			}
+		}
+
+		_available = (varyingBits == probabilities.size());
+	}
+}
+
+// ----------
+// appendData
+// ----------
+
+/**
+ * @brief Appends available entropic data to the vector byte stream.
+ *        Implementation of pure virtual function from RandomSource.
+ *
+ * @param data a reference to a byte vector to be appended with
+ *        entropic data from timing jitter.
+ *
+ * @return void
+ */
+void InterfaceJitter::appendData(std::vector<uint8_t>& data) {
+	try {
+		// Reserve space for data to be appended.
+		data.reserve(data.size() + _jitterData.size());
+	} catch (const std::bad_alloc& ba) {
+		std::cerr << "[Memory Error] Cannot Append: " << std::endl;
+		return;
+	}
+
+	// Append available entropic data.
+	std::copy(_jitterData.begin(), _jitterData.end(), std::back_inserter(data));
+
+	// Clear entropic data and reset sample counts for further captures.
+	_jitterData.clear();
+	_histogram.reset();
+}
+
+// --------
+// moveData
+// --------
+
+/**
+ * @brief Appends available entropic data to the vector byte stream;
+ *        the recorded buffer is handed over without a copy when data is
+ *        empty. Override of virtual function from RandomSource.
+ *
+ * @param data a reference to a byte vector to be appended with
+ *        entropic data from timing jitter.
+ *
+ * @return void
+ */
+void InterfaceJitter::moveData(std::vector<uint8_t>& data) {
+
+	// Append by copy if data already holds bytes.
+	if (!data.empty()) {
+		appendData(data);
+		return;
+	}
+
+	// Hand over recorded bytes and release the buffer previously held by data.
+	data.swap(_jitterData);
+	std::vector<uint8_t>().swap(_jitterData);
+
+	// Reset sample counts for further captures.
+	_histogram.reset();
+}
+
+// ----------
+// bitEntropy
+// ----------
+
+/**
+ * @brief Returns entropy estimate of timing jitter samples as
+ *        bit occurrence probabilities.
+ *        Implementation of pure virtual function from RandomSource.
+ *
+ * @return double vector with bit occurrence probabilities.
+ */
+std::vector<double> InterfaceJitter::bitEntropy() {
+	// Derive bit occurrence probabilities from counts of recorded bytes.
+	return _histogram.bitProbabilities();
+}
+
+// ---------
+// available
+// ---------
+
+/**
+ * @brief Checks if the health check on construction found usable
+ *        jitter, i.e. a fine grained timer and few stuck samples.
+ *
+ * @return true, if random bytes can be generated.
+ */
+bool InterfaceJitter::available() const {
+	return _available;
+}
+
+// -------------------
+// generateRandomBytes
+// -------------------
+
+/**
+ * @brief Captures random bytes from timing jitter, one folded timing
+ *        delta per byte. The request can be split across worker threads,
+ *        each walking its own memory and keeping its own sample counts.
+ *
+ * @param numBytes size_t with number of bytes to be recorded
+ *        (default 64KB).
+ * @param numThreads size_t with number of worker threads; 0 uses the
+ *        hardware concurrency (default 1). Each thread records at least
+ *        JITTER_THREAD_MIN_BYTES.
+ *
+ * @return true, if bytes were generated successfully.
+ */
+bool InterfaceJitter::generateRandomBytes(size_t numBytes, size_t numThreads) {
+	if (!_available) {
+		return false;
+	}
+
+	// Bytes are written directly after data already recorded.
+	size_t offset = _jitterData.size();
+
+	try {
+		// Check if data can be held.
+		if (_jitterData.max_size() - offset < numBytes) {
+			// Update numBytes to max possible.
+			numBytes = _jitterData.max_size() - offset;
+		}
+
+		_jitterData.resize(offset + numBytes);
+	} catch (const std::bad_alloc& ba) {
+		std::cerr << "[Memory Error] Samples discarded." << std::endl;
+		return false;
+	}
+
+	uint8_t* output = _jitterData.data() + offset;
+
+	// Use hardware concurrency if requested.
+	if (numThreads == 0) {
+		numThreads = std::thread::hardware_concurrency();
+	}
+
+	// Limit threads so that each records at least JITTER_THREAD_MIN_BYTES.
+	size_t maxThreads = numBytes / InterfaceJitter::JITTER_THREAD_MIN_BYTES;
+	if (numThreads > maxThreads) {
+		numThreads = maxThreads;
+	}
+	if (numThreads == 0) {
+		numThreads = 1;
+	}
+
+	// Each worker records a region and counts its samples independently.
+	size_t regionSize = numBytes / numThreads;
+	std::vector<BitHistogram<uint8_t> > histograms(numThreads);
+	std::vector<char> recorded(numThreads, 0);
+
+	auto recordRegion = [&] (size_t region) {
+		size_t length = (region == numThreads - 1)
+			? numBytes - region * regionSize
+			: regionSize;
+
+		if (collect(output + region * regionSize, length, histograms[region])) {
+			recorded[region] = 1;
+		}
+	};
+
+	// Region 0 is recorded by the calling thread.
+	std::vector<std::thread> workers;
+	for (size_t region = 1; region < numThreads; ++region) {
+		try {
+			workers.push_back(std::thread(recordRegion, region));
+		} catch (const std::system_error& e) {
+			recordRegion(region); // Thread unavailable; record inline.
+		}
+	}
+
+	recordRegion(0);
+
+	for (auto it = workers.begin(); it != workers.end(); ++it) {
+		it->join();
+	}
+
+	for (size_t region = 0; region < numThreads; ++region) {
+		if (!recorded[region]) {
+			std::cerr << "[Failed] Timer stuck, jitter discarded." << std::endl;
+			_jitterData.resize(offset);
+			return false;
+		}
+	}
+
+	// Merge sample counts of all regions.
+	for (auto it = histograms.begin(); it != histograms.end(); ++it) {
+		_histogram.merge(*it);
+	}
+
+	return true;
+}
+
+// -------
+// collect
+// -------
+
+/**
+ * @brief Records numBytes folded timing deltas; samples whose delta or
+ *        first/second order differences are zero are discarded.
+ *
+ * @param output pointer to memory to hold numBytes bytes.
+ * @param numBytes size_t with number of bytes to record.
+ * @param histogram reference to a BitHistogram counting the bytes.
+ *
+ * @return true, if numBytes bytes were recorded.
+ */
+bool InterfaceJitter::collect(
+	uint8_t* output,
+	size_t numBytes,
+	BitHistogram<uint8_t>& histogram
+) {
+	// Memory walked by this worker, larger than typical L1/L2 caches.
+	std::vector<uint8_t> memory(InterfaceJitter::JITTER_MEMORY_SIZE, 0);
+	size_t mask = memory.size() - 1;
+	size_t index = 0;
+
+	uint64_t state = 0x9E3779B97F4A7C15ULL; // Compute loop state.
+	volatile uint64_t sink = 0; // Keeps loops from being optimized out.
+
+	uint64_t last = timestamp();
+	uint64_t lastDelta = 0;
+	int64_t lastDelta1 = 0;
+	size_t stuck = 0;
+	size_t recorded = 0;
+
+	while (recorded < numBytes) {
+
+		// Data dependent memory walk; each access updates the walked byte.
+		for (size_t i = 0; i < InterfaceJitter::JITTER_ACCESS_LOOPS; ++i) {
+			index = (index + 4099 + (static_cast<size_t>(memory[index]) << 6))
+				& mask;
+			memory[index] = static_cast<uint8_t>(memory[index] + i + 1);
+		}
+
+		// Short compute loop (xorshift) mixed with the walk position.
+		for (int i = 0; i < 16; ++i) {
+			state ^= state << 13;
+			state ^= state >> 7;
+			state ^= state << 17;
+		}
+		sink = state ^ index;
+
+		// Timing delta and its first and second order differences.
+		uint64_t now = timestamp();
+		uint64_t delta = now - last;
+		int64_t delta1 = static_cast<int64_t>(delta - lastDelta);
+		int64_t delta2 = delta1 - lastDelta1;
+		last = now;
+		lastDelta = delta;
+		lastDelta1 = delta1;
+
+		// Discard stuck samples; fail if the timer stays stuck.
+		if (delta == 0 || delta1 == 0 || delta2 == 0) {
+			stuck = stuck + 1;
+			if (stuck > InterfaceJitter::JITTER_STUCK_LIMIT) {
+				return false;
+			}
+			continue;
+		}
+		stuck = 0;
+
+		// Fold the 64bit delta into a byte.
+		uint8_t folded = 0;
+		for (int shift = 0; shift < 64; shift += 8) {
+			folded ^= static_cast<uint8_t>(delta >> shift);
+		}
+
+		output[recorded] = folded;
+		histogram.add(folded);
+		recorded = recorded + 1;
+	}
+
+	(void)sink;
+	return true;
+}
@@ -0,0 +1,246 @@
+/** @file runjitter.c++
+ *  @brief Test public functions from interfaceJitter.h
+ *
+ *  @author Aashish Sheshadri
+ *  @author Rohit Harchandani
+ *
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2015, 2016, 2017 PayPal
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+// -----------------
+// standard includes
+// -----------------
+#include <cassert>
+#include <numeric>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+// ----------------
+// library includes
+// ----------------
+#include "interfaceJitter.h"
+
+// ---------------
+// appendDataValid
+// ---------------
+
+/**
+ * @brief Attempt to get entropic bytes (recorded from timing jitter); capture
+ *        must fail without bytes if the timer shows no usable jitter.
+ *
+ * @return true, if test passed.
+ */
+int appendDataValid () {
+	std::cerr << "**Running test appendDataValid**" << std::endl;
+
+	InterfaceJitter jitter;
+	std::vector<uint8_t> data;
+
+	// Attempt to record bytes from timing jitter.
+	bool status = jitter.generateRandomBytes(16*1024);
+	jitter.appendData(data);
+
+	bool retVal;
+	if (jitter.available()) {
+		// Append recorded bytes; sum should be non-zero.
+		size_t sum = std::accumulate(data.begin(), data.end(), 0);
+		retVal = status && (data.size() == 16*1024) && (sum > 0);
+	} else {
+		std::cerr << "Timing jitter unavailable" << std::endl;
+		retVal = !status && data.empty();
+	}
+
+	if (!retVal) {
+		std::cerr << "!!Failed appendDataValid test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return retVal;
+}
+
+// -------------------
+// measureEntropyValid
+// -------------------
+
+/**
+ * @brief Attempt to measure bit occurrence probabilities (entropy estimate) on
+ *        recorded bytes from timing jitter.
+ *
+ * @return true, if test passed.
+ */
+int measureEntropyValid () {
+	std::cerr << "**Running test measureEntropyValid**" << std::endl;
+
+	InterfaceJitter jitter;
+	bool retVal = true;
+
+	// Record bytes from timing jitter.
+	if (jitter.generateRandomBytes(64*1024)) {
+		std::vector<double> entropy = jitter.bitEntropy();
+
+		// Each bit must vary; jitter is biased so bounds are loose.
+		for (auto it = entropy.begin(); it != entropy.end(); ++it) {
+			retVal = retVal && (*it > 0.1) && (*it < 0.9);
+		}
+	} else {
+		retVal = !jitter.available();
+	}
+
+	if (!retVal) {
+		std::cerr << "!!Failed measureEntropyValid test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return retVal;
+}
+
+// -----------------
+// appendDataInvalid
+// -----------------
+
+/**
+ * @brief attempt to get entropic bytes before bytes are recorded.
+ *
+ * @return true, if test passed.
+ */
+int appendDataInvalid () {
+	std::cerr << "**Running test appendDataInvalid**" << std::endl;
+
+	InterfaceJitter jitter;
+	std::vector<uint8_t> data;
+
+	// Attempt to get data from jitter before recording bytes.
+	jitter.appendData(data);
+	std::vector<double> entropy = jitter.bitEntropy();
+	double meanEntropy = std::accumulate(entropy.begin(), entropy.end(), 0.0f);
+	bool retVal = data.empty() && (std::fabs(meanEntropy) < 0.01f);
+
+	if (!retVal) {
+		std::cerr << "!!Failed appendDataInvalid test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return retVal;
+}
+
+// -------------
+// moveDataValid
+// -------------
+
+/**
+ * @brief Attempt to take over entropic bytes without a copy; the source must
+ *        be emptied.
+ *
+ * @return true, if test passed.
+ */
+int moveDataValid () {
+	std::cerr << "**Running test moveDataValid**" << std::endl;
+
+	InterfaceJitter jitter;
+	std::vector<uint8_t> data;
+
+	// Take over recorded bytes, if timing jitter is available.
+	bool status = jitter.generateRandomBytes(4096);
+	jitter.moveData(data);
+	bool retVal = status ? (data.size() == 4096) : data.empty();
+
+	// Nothing is left to take over.
+	std::vector<uint8_t> rest;
+	jitter.moveData(rest);
+	retVal = retVal && rest.empty();
+
+	if (!retVal) {
+		std::cerr << "!!Failed moveDataValid test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return retVal;
+}
+
+// ---------------------
+// generateParallelValid
+// ---------------------
+
+/**
+ * @brief Attempt to record bytes across several threads; all bytes must be
+ *        recorded and counted once.
+ *
+ * @return true, if test passed.
+ */
+int generateParallelValid () {
+	std::cerr << "**Running test generateParallelValid**" << std::endl;
+
+	InterfaceJitter jitter;
+	std::vector<uint8_t> data;
+
+	// Split recording of an uneven size across 4 threads.
+	bool status = jitter.generateRandomBytes(4*4096 + 7, 4);
+	std::vector<double> entropy = jitter.bitEntropy();
+	jitter.moveData(data);
+
+	bool retVal;
+	if (jitter.available()) {
+		// Probabilities are only non-zero if counts of all threads merged.
+		double meanEntropy = std::accumulate(
+			entropy.begin(),
+			entropy.end(),
+			0.0
+		) / entropy.size();
+		retVal = status && (data.size() == 4*4096 + 7) && (meanEntropy > 0.1);
+	} else {
+		retVal = !status && data.empty();
+	}
+
+	if (!retVal) {
+		std::cerr << "!!Failed generateParallelValid test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return retVal;
+}
+
+int main() {
+	/* Run tests and count passed.
+	 * Order matters.
+	 */
+	int passed = 0;
+	passed += appendDataValid();
+	passed += measureEntropyValid();
+	passed += appendDataInvalid();
+	passed += moveDataValid();
+	passed += generateParallelValid();
+
+	std::cerr << std::endl;
+	std::cerr << "--Passed " << passed << "/5" << " tests--" << std::endl;
+
+	// Assert passing all tests.
+	assert(passed == 5);
+
+	return 0;
+}
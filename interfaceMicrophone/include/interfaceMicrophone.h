@@ -44,7 +44,11 @@
 #include <iomanip>
 #include <sstream>
 #include <mutex>
+#include <condition_variable>
 #include <functional>
+#include <thread>
+#include <atomic>
+#include <deque>
 
 // --------------------
 // third party includes
@@ -55,6 +59,10 @@
 // library includes
 // ----------------
 #include "randomSource.h"
+#include "bitHistogram.h"
+#include "spscRing.h"
+#include "int16toBytes.h"
+#include "noiseBits.h"
 
 /**
  * @class InterfaceMicrophone tasked with recording entropic bytes from a
@@ -64,6 +72,29 @@
 class InterfaceMicrophone: public RandomSource {
 public:
 
+	// ---------
+	// constants
+	// ---------
+
+	// Samples held between the audio callback and the drain worker
+	// (~11.9s of 16bit stereo at 44.1kHz).
+	static const size_t MIC_RING_SAMPLES = 1024*1024;
+
+	// Samples moved out of the ring per drain step; the callback wakes the
+	// drain worker once this many samples are waiting.
+	static const size_t MIC_DRAIN_SAMPLES = 16*1024;
+
+	// Time in milliseconds to wait for the callback to complete on stop
+	// before the stream is aborted.
+	static const size_t MIC_STOP_TIMEOUT_MS = 1000;
+
+	// Recorded bytes per credited block of a capture session.
+	static const size_t MIC_SESSION_BLOCK_BYTES = 4096;
+
+	// Credited blocks held by a capture session; the oldest block is
+	// discarded when a new block does not fit.
+	static const size_t MIC_SESSION_BLOCKS = 256;
+
 	// -----------
 	// Constructor
 	// -----------
@@ -99,6 +130,22 @@ public:
 	 */
 	void appendData(std::vector<uint8_t>& data);
 
+	// --------
+	// moveData
+	// --------
+
+	/**
+	 * @brief Appends available entropic data to the vector byte stream;
+	 *        the recorded buffer is handed over without a copy when data is
+	 *        empty. Override of virtual function from RandomSource.
+	 *
+	 * @param data a reference to a byte vector to be appended with
+	 *        entropic data from the microphone.
+	 *
+	 * @return void
+	 */
+	void moveData(std::vector<uint8_t>& data);
+
 	// ----------
 	// bitEntropy
 	// ----------
@@ -112,6 +159,26 @@ public:
 	 */
 	std::vector<double> bitEntropy();
 
+	// ------------
+	// setNoiseBits
+	// ------------
+
+	/**
+	 * @brief Selects how samples are recorded: whole 16bit samples (0) or
+	 *        only their noiseBits low order bits packed into bytes, which
+	 *        keeps the bits carrying most noise and shrinks the data.
+	 *        The bit estimate then covers the packed bytes.
+	 *
+	 * @param noiseBits unsigned with low order bits kept per sample, at
+	 *        most NoiseBitPacker::MAX_NOISE_BITS; 0 records whole samples.
+	 * @param decorrelate bool; if true, keep the bits of left minus right
+	 *        of each stereo frame, removing signal common to both channels
+	 *        (default false).
+	 *
+	 * @return true, if the mode was set.
+	 */
+	bool setNoiseBits(unsigned noiseBits, bool decorrelate = false);
+
 	// --------
 	// initFlow
 	// --------
@@ -136,8 +203,74 @@ public:
 	 */
 	bool stopFlow();
 
+	// -----------
+	// openSession
+	// -----------
+
+	/**
+	 * @brief Starts a long lived capture session; the stream stays open
+	 *        and recorded bytes are continuously split into blocks of
+	 *        MIC_SESSION_BLOCK_BYTES, each credited with its min-entropy
+	 *        estimate, until closeSession. Bytes are recorded as selected
+	 *        by setNoiseBits.
+	 *
+	 * @return int with value 1 if the session has been started, 0 if a
+	 *         session is already open or -1 if it failed to start.
+	 */
+	int openSession();
+
+	// ------------
+	// closeSession
+	// ------------
+
+	/**
+	 * @brief Stops a capture session, releases the microphone and wipes
+	 *        blocks not taken yet.
+	 *
+	 * @return true, if the session was closed.
+	 */
+	bool closeSession();
+
+	// -------------
+	// availableBits
+	// -------------
+
+	/**
+	 * @brief Returns entropy credited to blocks held by the session.
+	 *
+	 * @return double with credited bits ready to be taken.
+	 */
+	double availableBits();
+
+	// --------
+	// takeBits
+	// --------
+
+	/**
+	 * @brief Takes the oldest session blocks until at least numBits are
+	 *        credited and appends their bytes to data. Nothing is taken
+	 *        while fewer bits are available.
+	 *
+	 * @param numBits double with entropy to take in bits.
+	 * @param data a reference to a byte vector to be appended with the
+	 *        bytes of the blocks taken.
+	 *
+	 * @return double with bits credited to the bytes appended; 0 if none.
+	 */
+	double takeBits(double numBits, std::vector<uint8_t>& data);
+
 private:
 
+	// ------------
+	// SessionBlock
+	// ------------
+
+	// Recorded bytes of a session with their credited entropy in bits.
+	struct SessionBlock {
+		std::vector<uint8_t> data;
+		double credit;
+	};
+
 	// ----------
 	// paCallback
 	// ----------
@@ -172,6 +305,34 @@ private:
 		);
  	}
 
+	// ------------------
+	// paFinishedCallback
+	// ------------------
+
+	/**
+	 * @brief Invoked by PortAudio once the stream became inactive, e.g.
+	 *        after the callback returned paComplete.
+	 *
+	 * @param userData void pointer to calling object.
+	 *
+	 * @return void
+	 */
+	static void paFinishedCallback(void *userData) {
+		// pass along to memberFinishedCallback
+		((InterfaceMicrophone*)userData)->memberFinishedCallback();
+	}
+
+	// ----------------------
+	// memberFinishedCallback
+	// ----------------------
+
+	/**
+	 * @brief Signals a waiting closeStream that the stream completed.
+	 *
+	 * @return void
+	 */
+	void memberFinishedCallback();
+
 	// --------------
 	// memberCallback
 	// --------------
@@ -231,29 +392,68 @@ private:
 	 */
 	bool closeStream();
 
-	// ------------
-	// int16toBytes
-	// ------------
+	// ---------
+	// drainLoop
+	// ---------
 
 	/**
-	 * @brief Converts an int16 stream to a byte stream.
+	 * @brief Runs on the drain worker; moves samples from the ring into
+	 *        the recorded bytes and sample counts until draining stops,
+	 *        then drains what is left.
 	 *
-	 * @param begin input iterator to the beginning of the int16 stream.
-	 * @param end input iterator to the end of the int16 stream.
-	 * @param out output iterator to record bytes from the int16 stream.
+	 * @return void
+	 */
+	void drainLoop();
+
+	// ----------
+	// stopWorker
+	// ----------
+
+	/**
+	 * @brief Stops and joins the drain worker, if running, and reports
+	 *        samples dropped because the ring was full.
 	 *
 	 * @return void
 	 */
-	template <typename II, typename OI>
-	void int16toBytes(II begin, II end, OI out);
+	void stopWorker();
+
+	// -------------
+	// recordSession
+	// -------------
+
+	/**
+	 * @brief Runs on the drain worker; records samples of a session and
+	 *        moves every full block into the session blocks.
+	 *
+	 * @param samples const pointer to the samples drained.
+	 * @param count size_t with number of samples.
+	 *
+	 * @return void
+	 */
+	void recordSession(const int16_t* samples, size_t count);
+
+	// -----------
+	// blockCredit
+	// -----------
+
+	/**
+	 * @brief Estimates the min-entropy of a block of bytes as the smaller
+	 *        of the most common byte estimate and the sum of per bit
+	 *        estimates.
+	 *
+	 * @param block const reference to a byte vector.
+	 *
+	 * @return double with credited entropy of the block in bits.
+	 */
+	static double blockCredit(const std::vector<uint8_t>& block);
 
 	// ----------------
 	// copyNCompEntropy
 	// ----------------
 
 	/**
-	 * @brief Copies audio samples from buffer to a container and updates
-	 *        bit occurrence counts.
+	 * @brief Copies audio samples from buffer to a container as bytes and
+	 *        counts them in the sample histogram.
 	 *
 	 * @param begin input iterator to the beginning of the int16 stream.
 	 * @param end input iterator to the end of the int16 stream.
@@ -267,52 +467,40 @@ private:
 	// ----
 	// data
 	// ----
-	std::vector<int16_t> _microphoneData; // Vector of random samples from mic.
+	std::vector<uint8_t> _microphoneData; // Vector of random bytes from mic.
 	PaStream* _stream;    // Audio stream.
 	PaStreamParameters _inputParameters; // Stream paramters
 	double _samplingRate; // Audio recording sampling rate.
 	bool _streamInUse;    // Status of audio stream.
-	bool _stopCalled;     // Status of recording.
+	std::atomic<bool> _stopCalled; // Status of recording.
 	PaError _err;		  // Error object.
-	std::vector<double> _bitEntropy; // Bit occurrence probabilites of data.
-	std::vector<std::vector<uint8_t> > _bitCountCache; /* Cache: Bit occurrences
-													    * in sample space.
-													    */
+	BitHistogram<uint16_t> _histogram; // Sample counts for bit estimate.
+	unsigned _noiseBits; // Low order bits kept per sample, 0 for all.
+	NoiseBitPacker _packer; // Packs noise bits of samples.
+	BitHistogram<uint8_t> _packedHistogram; // Counts of packed bytes.
+	SpscRing<int16_t> _ring; // Samples from the audio callback.
+	std::thread _worker;  // Drains the ring while streaming.
+	std::atomic<bool> _draining; // Status of the drain worker.
+	std::mutex _drainMutex; // Guards the drain worker's wait.
+	std::condition_variable _drainCondition; // Wakes the drain worker.
+	std::atomic<size_t> _droppedSamples; // Samples lost to a full ring.
+	std::mutex _completeMutex; // Guards _streamComplete.
+	std::condition_variable _completeCondition; // Signals _streamComplete.
+	bool _streamComplete; // Stream became inactive after a stop request.
+	bool _session;        // Stream records session blocks.
+	std::vector<uint8_t> _blockData; // Session bytes not in a block yet.
+	std::deque<SessionBlock> _sessionBlocks; // Credited session blocks.
+	double _sessionBits;  // Entropy credited to _sessionBlocks.
+	std::mutex _sessionMutex; // Guards _sessionBlocks and _sessionBits.
 };
 
-// ------------
-// int16toBytes
-// ------------
-
-/**
- * @brief Converts an int16 stream to a byte stream.
- *
- * @param begin input iterator to the beginning of the int16 stream.
- * @param end input iterator to the end of the int16 stream.
- * @param out output iterator to record bytes from the int16 stream.
- *
- * @return void
- */
-template <typename II, typename OI>
-void InterfaceMicrophone::int16toBytes(II begin, II end, OI out) {
-
-	// Loop through int16 stream.
-	while (begin != end) {
-		// Convert int16 to bytes and load them into out.
-		*out = static_cast<uint8_t>(*begin & uint16_t(0x00FF));
-		++out;
-		*out = static_cast<uint8_t>((*begin & uint16_t(0xFF00)) >> 8);
-		++begin;
-	}
-}
-
 // ----------------
 // copyNCompEntropy
 // ----------------
 
 /**
- * @brief Copies audio samples from buffer to a container and updates
- *        bit occurrence counts.
+ * @brief Copies audio samples from buffer to a container as bytes and
+ *        counts them in the sample histogram.
  *
  * @param begin input iterator to the beginning of the int16 stream.
  * @param end input iterator to the end of the int16 stream.
@@ -322,47 +510,8 @@ void InterfaceMicrophone::int16toBytes(II begin, II end, OI out) {
  */
 template <typename II, typename OI>
 void InterfaceMicrophone::copyNCompEntropy(II begin, II end, OI out) {
-
-	// Loop through int16 stream.
-	while (begin != end) {
-		*out = *begin;
-
-		uint16_t sample = static_cast<uint16_t>(*begin);
-
-		// Check if sample has been encountered before.
-		if (_bitCountCache[sample].empty()) {
-
-			uint16_t temp = sample;
-			uint8_t bitPos = 0;
-
-			// Compute and record set bits in the sample.
-			while (temp) {
-
-				if (temp & 1) {
-					_bitCountCache[sample].push_back(bitPos);
-				}
-
-				temp = temp >> 1;
-				bitPos = bitPos + 1;
-			}
-		}
-
-		/* Update _bitEntropy with occurrences of set bits in the sample from
-		 * the cache.
-		 */
-		auto cachedSample = _bitCountCache[sample];
-
-		std::for_each (
-			cachedSample.begin(),
-			cachedSample.end(),
-			[this] (uint8_t val) {
-				_bitEntropy[val] = _bitEntropy[val] + 1;
-			}
-		);
-
-		++begin;
-		++out;
-	}
+	// Shared with replayed audio (InterfaceAudioFile).
+	int16toBytes(begin, end, out, _histogram);
 }
 
 #endif
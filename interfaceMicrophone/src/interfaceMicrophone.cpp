@@ -31,6 +31,9 @@
 // standard includes
 // -----------------
 #include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <system_error>
 
 // ----------------
 // library includes
@@ -49,8 +52,13 @@ InterfaceMicrophone::InterfaceMicrophone():
 	_samplingRate(44100),   // Set sampling rate of audio signal.
 	_streamInUse(false),    // Reset recording state.
 	_stopCalled(false),     // Reset recording state.
-	_bitEntropy(16,0.0f),   // Bit occurrence probabilities initialized to 0.
-	_bitCountCache(65536) { // Cache to accommodate 16bit sample space.
+	_noiseBits(0),          // Record whole samples.
+	_ring(InterfaceMicrophone::MIC_RING_SAMPLES), // Preallocate samples.
+	_draining(false),       // No drain worker yet.
+	_droppedSamples(0),     // No samples lost yet.
+	_streamComplete(false), // Reset recording state.
+	_session(false),        // Record into _microphoneData.
+	_sessionBits(0) {       // No session blocks yet.
 
 }
 
@@ -65,9 +73,14 @@ InterfaceMicrophone::InterfaceMicrophone():
 InterfaceMicrophone::~InterfaceMicrophone() {
 
 	// If audio capture is active, stop recording before destroying object.
-	if (_streamInUse) {
+	if (_streamInUse && _session) {
+		closeSession();
+	} else if (_streamInUse) {
 		stopFlow();
 	}
+
+	// Join the drain worker if it outlived a failed stream.
+	stopWorker();
 }
 
 // ----------
@@ -92,22 +105,59 @@ void InterfaceMicrophone::appendData(std::vector<uint8_t>& data) {
 
 	try {
 		// Reserve space for data to be appended.
-		data.reserve(data.size() + (_microphoneData.size() * 2));
+		data.reserve(data.size() + _microphoneData.size());
 	} catch (const std::bad_alloc& ba) {
 		std::cerr << "[Memory Error] Cannot Append: " << std::endl;
 		return;
 	}
 
-	// Convert samples to bytes and copy into data.
-	int16toBytes(
+	// Append available entropic data.
+	std::copy(
 		_microphoneData.begin(),
 		_microphoneData.end(),
 		std::back_inserter(data)
 	);
 
-	// Clear entropic data
+	// Clear entropic data and reset sample counts for further captures.
 	_microphoneData.clear();
-	_bitEntropy.clear();
+	_histogram.reset();
+	_packedHistogram.reset();
+}
+
+// --------
+// moveData
+// --------
+
+/**
+ * @brief Appends available entropic data to the vector byte stream;
+ *        the recorded buffer is handed over without a copy when data is
+ *        empty. Override of virtual function from RandomSource.
+ *
+ * @param data a reference to a byte vector to be appended with
+ *        entropic data from the microphone.
+ *
+ * @return void
+ */
+void InterfaceMicrophone::moveData(std::vector<uint8_t>& data) {
+
+	if (_streamInUse) {
+		std::cerr << "Stream still running";
+		return;
+	}
+
+	// Append by copy if data already holds bytes.
+	if (!data.empty()) {
+		appendData(data);
+		return;
+	}
+
+	// Hand over recorded bytes and release the buffer previously held by data.
+	data.swap(_microphoneData);
+	std::vector<uint8_t>().swap(_microphoneData);
+
+	// Reset sample counts for further captures.
+	_histogram.reset();
+	_packedHistogram.reset();
 }
 
 // ----------
@@ -122,27 +172,46 @@ void InterfaceMicrophone::appendData(std::vector<uint8_t>& data) {
  * @return double vector with bit occurrence probabilities.
  */
 std::vector<double> InterfaceMicrophone::bitEntropy() {
-	// Compute present entropy estimate.
-	auto tempEntropy = _bitEntropy;
+	// Derive bit occurrence probabilities from counts of recorded samples.
+	if (_noiseBits != 0) {
+		return _packedHistogram.bitProbabilities();
+	}
 
-	// Normalize to compute bit occurrence probabilities.
-	double normalizer = _microphoneData.size();
+	return _histogram.bitProbabilities();
+}
+
+// ------------
+// setNoiseBits
+// ------------
 
-	if (std::fabs(normalizer)<0.01) {
-		normalizer = 1.0f;
+/**
+ * @brief Selects how samples are recorded: whole 16bit samples (0) or
+ *        only their noiseBits low order bits packed into bytes, which
+ *        keeps the bits carrying most noise and shrinks the data.
+ *        The bit estimate then covers the packed bytes.
+ *
+ * @param noiseBits unsigned with low order bits kept per sample, at
+ *        most NoiseBitPacker::MAX_NOISE_BITS; 0 records whole samples.
+ * @param decorrelate bool; if true, keep the bits of left minus right
+ *        of each stereo frame, removing signal common to both channels
+ *        (default false).
+ *
+ * @return true, if the mode was set.
+ */
+bool InterfaceMicrophone::setNoiseBits(unsigned noiseBits, bool decorrelate) {
+	// Mode cannot change while recording.
+	if (_streamInUse) {
+		return false;
 	}
 
-	std::transform(
-		tempEntropy.begin(),
-		tempEntropy.end(),
-		tempEntropy.begin(),
-		[normalizer] (double val) {
-			return val / normalizer;
-		}
-	);
+	if (noiseBits > NoiseBitPacker::MAX_NOISE_BITS) {
+		return false;
+	}
+
+	_noiseBits = noiseBits;
+	_packer = NoiseBitPacker(noiseBits, decorrelate);
 
-	// Return bit occurrence probabilities of entropic data.
-	return tempEntropy;
+	return true;
 }
 
 // --------
@@ -210,6 +279,143 @@ bool InterfaceMicrophone::stopFlow() {
 	return true;
 }
 
+// -----------
+// openSession
+// -----------
+
+/**
+ * @brief Starts a long lived capture session; the stream stays open
+ *        and recorded bytes are continuously split into blocks of
+ *        MIC_SESSION_BLOCK_BYTES, each credited with its min-entropy
+ *        estimate, until closeSession. Bytes are recorded as selected
+ *        by setNoiseBits.
+ *
+ * @return int with value 1 if the session has been started, 0 if a
+ *         session is already open or -1 if it failed to start.
+ */
+int InterfaceMicrophone::openSession() {
+	// A running session continues; a plain recording cannot turn into one.
+	if (_streamInUse) {
+		return _session ? 0 : -1;
+	}
+
+	// Set before the drain worker starts; fixed while streaming.
+	_session = true;
+	_blockData.clear();
+
+	int status = initFlow();
+
+	if (status != 1) {
+		_session = false;
+	}
+
+	return status;
+}
+
+// ------------
+// closeSession
+// ------------
+
+/**
+ * @brief Stops a capture session, releases the microphone and wipes
+ *        blocks not taken yet.
+ *
+ * @return true, if the session was closed.
+ */
+bool InterfaceMicrophone::closeSession() {
+	if (!_session || !_streamInUse) {
+		return false;
+	}
+
+	bool retVal = stopFlow();
+
+	// Wipe bytes that were never handed out.
+	std::fill(_blockData.begin(), _blockData.end(), 0);
+	_blockData.clear();
+
+	{
+		std::lock_guard<std::mutex> lock(_sessionMutex);
+
+		for (SessionBlock& block : _sessionBlocks) {
+			std::fill(block.data.begin(), block.data.end(), 0);
+		}
+
+		_sessionBlocks.clear();
+		_sessionBits = 0;
+	}
+
+	_session = false;
+
+	return retVal;
+}
+
+// -------------
+// availableBits
+// -------------
+
+/**
+ * @brief Returns entropy credited to blocks held by the session.
+ *
+ * @return double with credited bits ready to be taken.
+ */
+double InterfaceMicrophone::availableBits() {
+	std::lock_guard<std::mutex> lock(_sessionMutex);
+	return _sessionBits;
+}
+
+// --------
+// takeBits
+// --------
+
+/**
+ * @brief Takes the oldest session blocks until at least numBits are
+ *        credited and appends their bytes to data. Nothing is taken
+ *        while fewer bits are available.
+ *
+ * @param numBits double with entropy to take in bits.
+ * @param data a reference to a byte vector to be appended with the
+ *        bytes of the blocks taken.
+ *
+ * @return double with bits credited to the bytes appended; 0 if none.
+ */
+double InterfaceMicrophone::takeBits(
+	double numBits,
+	std::vector<uint8_t>& data
+) {
+	std::lock_guard<std::mutex> lock(_sessionMutex);
+
+	if (numBits <= 0 || _sessionBits < numBits) {
+		return 0;
+	}
+
+	double taken = 0;
+
+	while (taken < numBits && !_sessionBlocks.empty()) {
+		SessionBlock& block = _sessionBlocks.front();
+
+		try {
+			data.insert(data.end(), block.data.begin(), block.data.end());
+		} catch (const std::bad_alloc& ba) {
+			std::cerr << "[Memory Error] Cannot Append: " << std::endl;
+			break;
+		}
+
+		taken += block.credit;
+		_sessionBits -= block.credit;
+
+		// Wipe block from memory.
+		std::fill(block.data.begin(), block.data.end(), 0);
+		_sessionBlocks.pop_front();
+	}
+
+	// Avoid drift of the running sum.
+	if (_sessionBlocks.empty()) {
+		_sessionBits = 0;
+	}
+
+	return taken;
+}
+
 // --------------
 // memberCallback
 // --------------
@@ -242,28 +448,25 @@ int InterfaceMicrophone::memberCallback(
 		return paContinue;
 	}
 
-	// Compute total storage required.
-	size_t requiredStorage = _microphoneData.size() + frameCount;
-
-	// Check if data can be held.
-	if (_microphoneData.max_size() < requiredStorage) {
-		std::cerr << "[Max Capacity] Samples discarded: " << std::endl;
-		return paComplete; // cannot hold new data stop recording
+	/* Copy samples of all channels into the preallocated ring; the drain
+	 * worker records and counts them. Samples that do not fit are dropped
+	 * and counted; no allocation, locking or logging on the audio thread.
+	 */
+	size_t numSamples = frameCount * _inputParameters.channelCount;
+	size_t copied = _ring.push(recordedData, numSamples);
+
+	if (copied < numSamples) {
+		_droppedSamples.fetch_add(
+			numSamples - copied,
+			std::memory_order_relaxed
+		);
 	}
 
-	try {
-		// Reserve space to record samples from buffer.
-		_microphoneData.reserve(requiredStorage);
-
-		// Copy data from buffer and update bit occurrence in samples.
-		copyNCompEntropy(
-			recordedData,
-			recordedData + frameCount,
-			std::back_inserter(_microphoneData)
-		);
-	} catch (const std::bad_alloc& ba) {
-		std::cerr << "[Memory Error] Samples discarded: " << std::endl;
-		return paComplete;
+	/* Wake the drain worker once a drain step is waiting. Notifying without
+	 * the lock may miss a worker about to wait; the next callback wakes it.
+	 */
+	if (_ring.size() >= InterfaceMicrophone::MIC_DRAIN_SAMPLES) {
+		_drainCondition.notify_one();
 	}
 
 	// Check if the stream has been requested to end.
@@ -276,6 +479,24 @@ int InterfaceMicrophone::memberCallback(
 	return paContinue;
 }
 
+// ----------------------
+// memberFinishedCallback
+// ----------------------
+
+/**
+ * @brief Signals a waiting closeStream that the stream completed.
+ *
+ * @return void
+ */
+void InterfaceMicrophone::memberFinishedCallback() {
+	{
+		std::lock_guard<std::mutex> lock(_completeMutex);
+		_streamComplete = true;
+	}
+
+	_completeCondition.notify_all();
+}
+
 // ----------
 // openStream
 // ----------
@@ -322,6 +543,18 @@ int InterfaceMicrophone::openStream() {
     	return -1;
     }
 
+    // Get notified as soon as the stream completes.
+    _err = Pa_SetStreamFinishedCallback(
+    	_stream,
+    	&InterfaceMicrophone::paFinishedCallback
+    );
+
+    if (_err != paNoError) {
+    	std::cerr << "Unable to watch audio stream" << std::endl;
+    	Pa_CloseStream(_stream);
+    	return -1;
+    }
+
     return 1;
 }
 
@@ -336,11 +569,33 @@ int InterfaceMicrophone::openStream() {
  */
 int InterfaceMicrophone::startStream() {
 
+	// Frames of a new stream are packed from scratch.
+	_packer.reset();
+
+	// Drain samples from the ring on a worker thread while streaming.
+	_draining = true;
+	_droppedSamples = 0;
+
+	try {
+		_worker = std::thread(&InterfaceMicrophone::drainLoop, this);
+	} catch (const std::system_error& e) {
+		std::cerr << "Unable to start drain worker" << std::endl;
+		_draining = false;
+		return -1;
+	}
+
+	// Stream has not completed yet.
+	{
+		std::lock_guard<std::mutex> lock(_completeMutex);
+		_streamComplete = false;
+	}
+
 	// Start configured stream.
 	_err = Pa_StartStream(_stream);
 
 	if (_err!=paNoError) {
 		std::cerr << "Pa_StartStream error:" << Pa_GetErrorText(_err) << std::endl;
+		stopWorker();
 		return -1;
 	}
 	_streamInUse = true;
@@ -362,13 +617,27 @@ bool InterfaceMicrophone::closeStream() {
 	// Set stop called for stream callback to flush.
 	_stopCalled = true;
 
-	// Wait for stream callback to call paComplete.
-	while (( _err = Pa_IsStreamActive(_stream)) == 1) {
-		Pa_Sleep(1000);
+	// Wait for stream callback to call paComplete (signalled once inactive).
+	std::unique_lock<std::mutex> lock(_completeMutex);
+	bool completed = _completeCondition.wait_for(
+		lock,
+		std::chrono::milliseconds(
+			static_cast<long>(InterfaceMicrophone::MIC_STOP_TIMEOUT_MS)
+		),
+		[this] () { return _streamComplete; }
+	);
+	lock.unlock();
+
+	// Stop stream; abort it if the callback did not complete in time.
+	if (completed) {
+		_err = Pa_StopStream(_stream);
+	} else {
+		std::cerr << "[Timeout] Aborting audio stream" << std::endl;
+		_err = Pa_AbortStream(_stream);
 	}
 
-	// Stop stream.
-	_err = Pa_StopStream(_stream);
+	// No more callbacks; drain what is left in the ring.
+	stopWorker();
 
 	if (_err != paNoError) {
 		std::cerr << "Pa_StopStream error:" << Pa_GetErrorText(_err) << std::endl;
@@ -385,3 +654,204 @@ bool InterfaceMicrophone::closeStream() {
     }
     return true;
 }
+
+// ---------
+// drainLoop
+// ---------
+
+/**
+ * @brief Runs on the drain worker; moves samples from the ring into
+ *        the recorded bytes and sample counts until draining stops,
+ *        then drains what is left.
+ *
+ * @return void
+ */
+void InterfaceMicrophone::drainLoop() {
+	std::vector<int16_t> chunk(InterfaceMicrophone::MIC_DRAIN_SAMPLES);
+	bool draining = true;
+
+	while (draining) {
+		// Read the flag first; samples pushed before a stop are drained.
+		draining = _draining.load();
+
+		size_t count;
+		while ((count = _ring.pop(chunk.data(), chunk.size())) > 0) {
+			if (_session) {
+				try {
+					recordSession(chunk.data(), count);
+				} catch (const std::bad_alloc& ba) {
+					_droppedSamples.fetch_add(count, std::memory_order_relaxed);
+				}
+				continue;
+			}
+
+			// Compute total storage required (2 bytes per int16 sample).
+			size_t requiredStorage = _microphoneData.size() + (count * 2);
+
+			try {
+				// Grow geometrically; recording below cannot throw.
+				if (_microphoneData.capacity() < requiredStorage) {
+					_microphoneData.reserve(std::max(
+						requiredStorage,
+						2 * _microphoneData.capacity()
+					));
+				}
+			} catch (const std::bad_alloc& ba) {
+				_droppedSamples.fetch_add(count, std::memory_order_relaxed);
+				continue;
+			}
+
+			if (_noiseBits != 0) {
+				// Pack noise bits of samples and count packed bytes.
+				_packer.pack(
+					chunk.data(),
+					count,
+					_microphoneData,
+					_packedHistogram
+				);
+			} else {
+				// Copy samples as bytes and update bit occurrence in samples.
+				copyNCompEntropy(
+					chunk.begin(),
+					chunk.begin() + count,
+					std::back_inserter(_microphoneData)
+				);
+			}
+		}
+
+		// Wait for the callback to fill a drain step or for a stop request.
+		if (draining) {
+			std::unique_lock<std::mutex> lock(_drainMutex);
+			_drainCondition.wait(lock, [this] () {
+				return !_draining
+					|| _ring.size() >= InterfaceMicrophone::MIC_DRAIN_SAMPLES;
+			});
+		}
+	}
+}
+
+// ----------
+// stopWorker
+// ----------
+
+/**
+ * @brief Stops and joins the drain worker, if running, and reports
+ *        samples dropped because the ring was full.
+ *
+ * @return void
+ */
+void InterfaceMicrophone::stopWorker() {
+	if (!_worker.joinable()) {
+		return;
+	}
+
+	// Set under the lock so the worker cannot miss the wake up.
+	{
+		std::lock_guard<std::mutex> lock(_drainMutex);
+		_draining = false;
+	}
+	_drainCondition.notify_one();
+	_worker.join();
+
+	size_t dropped = _droppedSamples.exchange(0);
+
+	if (dropped > 0) {
+		std::cerr << "[Overrun] Samples discarded: " << dropped << std::endl;
+	}
+}
+
+// -------------
+// recordSession
+// -------------
+
+/**
+ * @brief Runs on the drain worker; records samples of a session and
+ *        moves every full block into the session blocks.
+ *
+ * @param samples const pointer to the samples drained.
+ * @param count size_t with number of samples.
+ *
+ * @return void
+ */
+void InterfaceMicrophone::recordSession(const int16_t* samples, size_t count) {
+	if (_noiseBits != 0) {
+		_packer.pack(samples, count, _blockData, _packedHistogram);
+	} else {
+		copyNCompEntropy(
+			samples,
+			samples + count,
+			std::back_inserter(_blockData)
+		);
+	}
+
+	// Session blocks carry their own estimate.
+	_histogram.reset();
+	_packedHistogram.reset();
+
+	const size_t blockBytes = InterfaceMicrophone::MIC_SESSION_BLOCK_BYTES;
+	size_t offset = 0;
+
+	while (_blockData.size() - offset >= blockBytes) {
+		SessionBlock block;
+		block.data.assign(
+			_blockData.begin() + offset,
+			_blockData.begin() + offset + blockBytes
+		);
+		block.credit = blockCredit(block.data);
+		offset += blockBytes;
+
+		std::lock_guard<std::mutex> lock(_sessionMutex);
+
+		_sessionBits += block.credit;
+		_sessionBlocks.push_back(std::move(block));
+
+		// Keep the freshest blocks when nobody takes them.
+		if (_sessionBlocks.size() > InterfaceMicrophone::MIC_SESSION_BLOCKS) {
+			SessionBlock& oldest = _sessionBlocks.front();
+			_sessionBits -= oldest.credit;
+			std::fill(oldest.data.begin(), oldest.data.end(), 0);
+			_sessionBlocks.pop_front();
+		}
+	}
+
+	// Keep the partial block; wipe bytes moved into blocks.
+	std::fill(_blockData.begin(), _blockData.begin() + offset, 0);
+	_blockData.erase(_blockData.begin(), _blockData.begin() + offset);
+}
+
+// -----------
+// blockCredit
+// -----------
+
+/**
+ * @brief Estimates the min-entropy of a block of bytes as the smaller
+ *        of the most common byte estimate and the sum of per bit
+ *        estimates.
+ *
+ * @param block const reference to a byte vector.
+ *
+ * @return double with credited entropy of the block in bits.
+ */
+double InterfaceMicrophone::blockCredit(const std::vector<uint8_t>& block) {
+	if (block.empty()) {
+		return 0;
+	}
+
+	BitHistogram<uint8_t> histogram;
+	histogram.add(block.begin(), block.end());
+
+	// Most common byte.
+	double mostCommon = -std::log2(
+		static_cast<double>(histogram.maxCount())
+			/ static_cast<double>(histogram.samples())
+	);
+
+	// Most likely value of each bit.
+	double bitwise = 0;
+
+	for (double p : histogram.bitProbabilities()) {
+		bitwise -= std::log2(std::max(p, 1.0 - p));
+	}
+
+	return block.size() * std::min(mostCommon, bitwise);
+}
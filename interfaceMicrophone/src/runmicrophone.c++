@@ -35,6 +35,8 @@
 #include <vector>
 #include <cmath>
 #include <algorithm>
+#include <thread>
+#include <chrono>
 
 // ----------------
 // library includes
@@ -257,6 +259,228 @@ int measureEntropyInvalid () {
 }
 
 
+// -------------
+// moveDataValid
+// -------------
+
+/**
+ * @brief Attempt to take over entropic bytes without a copy; the source must
+ *        be emptied.
+ *
+ * @return true, if test passed.
+ */
+int moveDataValid () {
+	std::cerr << "**Running test moveDataValid**" << std::endl;
+
+	InterfaceMicrophone microphone;
+
+	// Record audio samples for ~5s.
+	microphone.initFlow();
+	Pa_Sleep(5*1000);
+	microphone.stopFlow();
+	std::vector<uint8_t> data;
+
+	// Take over recorded bytes; sum should be non-zero.
+	microphone.moveData(data);
+	size_t sum = std::accumulate(data.begin(), data.end(), 0);
+	bool retVal = (sum > 0);
+
+	// Nothing is left to take over and the entropy estimate is reset.
+	std::vector<uint8_t> rest;
+	microphone.moveData(rest);
+	std::vector<double> entropy = microphone.bitEntropy();
+	double meanEntropy = std::accumulate(entropy.begin(), entropy.end(), 0.0f);
+	retVal = retVal && rest.empty() && (std::fabs(meanEntropy) < 0.01f);
+
+	if (!retVal) {
+		std::cerr << "!!Failed moveDataValid test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return retVal;
+}
+
+// -----------------
+// ringTransferValid
+// -----------------
+
+/**
+ * @brief Attempt to pass samples through the ring shared by the audio
+ *        callback and the drain worker; all samples must arrive in order
+ *        across many wrap arounds.
+ *
+ * @return true, if test passed.
+ */
+int ringTransferValid () {
+	std::cerr << "**Running test ringTransferValid**" << std::endl;
+
+	SpscRing<uint32_t> ring(1000);
+	const uint32_t numSamples = 1000*1000;
+
+	// Producer pushes increasing samples in uneven bursts.
+	std::thread producer([&ring, numSamples] () {
+		std::vector<uint32_t> burst(333);
+		uint32_t next = 0;
+
+		while (next < numSamples) {
+			size_t count = std::min<size_t>(burst.size(), numSamples - next);
+			for (size_t i = 0; i < count; ++i) {
+				burst[i] = next + i;
+			}
+
+			next += ring.push(burst.data(), count);
+		}
+	});
+
+	// Consumer checks samples arrive once and in order.
+	std::vector<uint32_t> chunk(257);
+	uint32_t expected = 0;
+	bool retVal = (ring.capacity() == 1024);
+
+	while (expected < numSamples && retVal) {
+		size_t count = ring.pop(chunk.data(), chunk.size());
+		for (size_t i = 0; i < count; ++i) {
+			retVal = retVal && (chunk[i] == expected + i);
+		}
+		expected += count;
+	}
+
+	producer.join();
+	retVal = retVal && (ring.size() == 0);
+
+	if (!retVal) {
+		std::cerr << "!!Failed ringTransferValid test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return retVal;
+}
+
+// --------------
+// stopFlowPrompt
+// --------------
+
+/**
+ * @brief Attempt to stop recording promptly; stopping must take about one
+ *        audio buffer, not a polling interval.
+ *
+ * @return true, if test passed.
+ */
+int stopFlowPrompt () {
+	std::cerr << "**Running test stopFlowPrompt**" << std::endl;
+
+	InterfaceMicrophone microphone;
+
+	// Record audio samples for ~0.5s.
+	bool retVal = (microphone.initFlow() == 1);
+	Pa_Sleep(500);
+
+	auto start = std::chrono::steady_clock::now();
+	retVal = retVal && microphone.stopFlow();
+	double seconds = std::chrono::duration<double>(
+		std::chrono::steady_clock::now() - start
+	).count();
+
+	retVal = retVal && (seconds < 0.25);
+
+	if (!retVal) {
+		std::cerr << "!!Failed stopFlowPrompt test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return retVal;
+}
+
+// --------------------
+// noiseBitsPackedValid
+// --------------------
+
+/**
+ * @brief Attempt to record packed noise bits; the mode is fixed while
+ *        recording and the estimate covers packed bytes.
+ *
+ * @return true, if test passed.
+ */
+int noiseBitsPackedValid () {
+	std::cerr << "**Running test noiseBitsPackedValid**" << std::endl;
+
+	InterfaceMicrophone microphone;
+
+	// Keep 2 bits of left minus right per frame.
+	bool retVal = microphone.setNoiseBits(2, true);
+	retVal = retVal && (microphone.initFlow() == 1);
+	retVal = retVal && !microphone.setNoiseBits(0);
+	Pa_Sleep(1000);
+	retVal = retVal && microphone.stopFlow();
+
+	std::vector<double> entropy = microphone.bitEntropy();
+	std::vector<uint8_t> data;
+	microphone.moveData(data);
+
+	retVal = retVal && (entropy.size() == 8) && !data.empty();
+
+	if (!retVal) {
+		std::cerr << "!!Failed noiseBitsPackedValid test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return retVal;
+}
+
+// -----------------
+// sessionTakeCredit
+// -----------------
+
+/**
+ * @brief Attempt to take credited bits from a capture session; blocks are
+ *        taken whole and nothing is taken beyond what is available.
+ *
+ * @return true, if test passed.
+ */
+int sessionTakeCredit () {
+	std::cerr << "**Running test sessionTakeCredit**" << std::endl;
+
+	InterfaceMicrophone microphone;
+
+	bool retVal = (microphone.openSession() == 1);
+	retVal = retVal && (microphone.openSession() == 0);
+	retVal = retVal && (microphone.initFlow() == 0);
+
+	// Wait for the session to credit some blocks.
+	for (int i = 0; i < 40 && microphone.availableBits() < 1024; ++i) {
+		Pa_Sleep(50);
+	}
+
+	std::vector<uint8_t> data;
+	double taken = microphone.takeBits(1024, data);
+
+	retVal = retVal && (taken >= 1024) && !data.empty();
+	retVal = retVal && (taken <= 8.0 * data.size());
+	retVal = retVal
+		&& (data.size() % InterfaceMicrophone::MIC_SESSION_BLOCK_BYTES == 0);
+
+	// Requests beyond what is available take nothing.
+	size_t size = data.size();
+	retVal = retVal && (microphone.takeBits(1e12, data) == 0);
+	retVal = retVal && (data.size() == size);
+
+	retVal = retVal && microphone.closeSession();
+	retVal = retVal && (microphone.availableBits() == 0);
+	retVal = retVal && !microphone.closeSession();
+
+	if (!retVal) {
+		std::cerr << "!!Failed sessionTakeCredit test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return retVal;
+}
+
 int main(){
 	/* Run tests and count passed.
 	 * Order matters.
@@ -268,13 +492,18 @@ int main(){
 	passed += measureEntropyValid();
 	passed += appendDataInvalid();
 	passed += measureEntropyInvalid();
+	passed += moveDataValid();
+	passed += ringTransferValid();
+	passed += stopFlowPrompt();
+	passed += noiseBitsPackedValid();
+	passed += sessionTakeCredit();
 
 
 	std::cerr << std::endl;
-	std::cerr << "--Passed " << passed << "/6" << " tests--" << std::endl;
+	std::cerr << "--Passed " << passed << "/11" << " tests--" << std::endl;
 
 	// Assert passing all tests.
-	assert(passed == 6);
+	assert(passed == 11);
 
 	return 0;
 }
\ No newline at end of file
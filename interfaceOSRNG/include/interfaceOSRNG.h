@@ -50,6 +50,7 @@
 // library includes
 // ----------------
 #include "randomSource.h"
+#include "bitHistogram.h"
 
 /**
  * @class InterfaceOSRNG tasked with recording entropic bytes from the OS and
@@ -59,6 +60,16 @@
 class InterfaceOSRNG: public RandomSource {
 public:
 
+	// ---------
+	// constants
+	// ---------
+
+	// Maximum bytes requested from the kernel per read (32 MiB).
+	static const size_t OS_READ_CHUNK = 32*1024*1024;
+
+	// Minimum bytes per worker thread of a parallel capture (1 MiB).
+	static const size_t OS_THREAD_MIN_BYTES = 1024*1024;
+
 	// -----------
 	// Constructor
 	// -----------
@@ -84,6 +95,22 @@ public:
 	 */
 	void appendData(std::vector<uint8_t>& data);
 
+	// --------
+	// moveData
+	// --------
+
+	/**
+	 * @brief Appends available entropic data to the vector byte stream;
+	 *        the recorded buffer is handed over without a copy when data is
+	 *        empty. Override of virtual function from RandomSource.
+	 *
+	 * @param data a reference to a byte vector to be appended with
+	 *        entropic data from the OS.
+	 *
+	 * @return void
+	 */
+	void moveData(std::vector<uint8_t>& data);
+
 	// ----------
 	// bitEntropy
 	// ----------
@@ -102,101 +129,46 @@ public:
 	// -------------------
 
 	/**
-	 * @brief Captures random bytes from OS generator.
+	 * @brief Captures random bytes from OS generator. The request can be
+	 *        split across worker threads, each filling its own region and
+	 *        keeping its own sample counts.
 	 *
 	 * @param size_t with number of bytes to be recorded (default 1MB).
+	 * @param numThreads size_t with number of worker threads; 0 uses the
+	 *        hardware concurrency (default 1). Each thread fills at least
+	 *        OS_THREAD_MIN_BYTES.
 	 *
 	 * @return true, if bytes were generated successfully.
 	 */
-	bool generateRandomBytes(size_t numBytes = 1024*1024);
+	bool generateRandomBytes(
+		size_t numBytes = 1024*1024,
+		size_t numThreads = 1
+	);
 
 private:
 
-	// ----------------
-	// copyNCompEntropy
-	// ----------------
+	// ----------
+	// readKernel
+	// ----------
 
 	/**
-	 * @brief Copies samples from buffer to a container and updates
-	 *        bit occurrence counts.
+	 * @brief Fills a buffer directly from the kernel RNG; getrandom(2) in
+	 *        OS_READ_CHUNK reads, falling back to /dev/urandom. Linux only.
 	 *
-	 * @param begin input iterator to the beginning of the byte stream.
-	 * @param end input iterator to the end of the int16 stream.
-	 * @param out output iterator to record bytes from the int16 stream.
+	 * @param output pointer to memory to hold numBytes bytes.
+	 * @param numBytes size_t with number of bytes to read.
 	 *
-	 * @return void
+	 * @return true, if numBytes bytes were read.
 	 */
-	template <typename II, typename OI>
-	void copyNCompEntropy(II begin, II end, OI out);
+	static bool readKernel(uint8_t* output, size_t numBytes);
 
 	// ----
 	// data
 	// ----
 	std::vector<uint8_t> _osrngData; // Vector of random bytes from OS.
-	CryptoPP::AutoSeededRandomPool _generator; // OS random bytes generator.
-	std::vector<double> _bitEntropy; // Bit occurrence probabilites of data.
-	std::vector<std::vector<uint8_t> > _bitCountCache; /* Cache: Bit occurrences
-													    * in sample space.
-													    */
-
-
+	CryptoPP::AutoSeededRandomPool _generator; // Portable OS random bytes.
+	BitHistogram<uint8_t> _histogram; // Sample counts for bit estimate.
 };
 
 
-// ----------------
-// copyNCompEntropy
-// ----------------
-
-/**
- * @brief Copies samples from buffer to a container and updates
- *        bit occurrence counts.
- *
- * @param begin input iterator to the beginning of the byte stream.
- * @param end input iterator to the end of the int16 stream.
- * @param out output iterator to record bytes from the int16 stream.
- *
- * @return void
- */
-template <typename II, typename OI>
-void InterfaceOSRNG::copyNCompEntropy(II begin, II end, OI out) {
-
-	// Loop through byte stream.
-	while (begin!=end) {
-		*out = *begin;
-		uint8_t sample = static_cast<uint8_t>(*begin);
-
-		// Check if sample has been encountered before.
-		if (_bitCountCache[sample].empty()) {
-			uint8_t temp = sample;
-			uint8_t bitPos = 0;
-
-			// Compute and record set bits in the sample.
-			while (temp) {
-				if (temp & 1) {
-					_bitCountCache[sample].push_back(bitPos);
-				}
-
-				temp = temp >> 1;
-				bitPos = bitPos + 1;
-			}
-		}
-
-		/* Update _bitEntropy with occurrences of set bits in the sample from
-		 * the cache.
-		 */
-		auto cachedSample = _bitCountCache[sample];
-
-		std::for_each (
-			cachedSample.begin(),
-			cachedSample.end(),
-			[this] (uint8_t val) {
-				_bitEntropy[val] = _bitEntropy[val] + 1;
-			}
-		);
-
-		++begin;
-		++out;
-	}
-}
-
 #endif
\ No newline at end of file
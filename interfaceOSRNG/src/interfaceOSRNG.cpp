@@ -27,6 +27,19 @@
  *  DEALINGS IN THE SOFTWARE.
  */
 
+// -----------------
+// standard includes
+// -----------------
+#include <thread>
+#include <system_error>
+
+#if defined(__linux__)
+	#include <cerrno>
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <sys/syscall.h>
+#endif
+
 // ----------------
 // library includes
 // ----------------
@@ -40,9 +53,8 @@
  * Constructor
  * @brief Creates InterfaceOSRNG object and initializes properties.
  */
-InterfaceOSRNG::InterfaceOSRNG():
-	_bitEntropy(8,0.0f),  // Bit occurrence probabilities initialized to 0.
-	_bitCountCache(256) { // Cache to accommodate 16bit sample space.
+InterfaceOSRNG::InterfaceOSRNG() {
+	// Histogram of 8bit samples is zeroed on construction.
 }
 
 /**
@@ -66,9 +78,39 @@ void InterfaceOSRNG::appendData(std::vector<uint8_t>& data) {
 	// Append available entropic data.
 	std::copy(_osrngData.begin(), _osrngData.end(), std::back_inserter(data));
 
-	// Clear entropic data.
+	// Clear entropic data and reset sample counts for further captures.
 	_osrngData.clear();
-	_bitEntropy.clear();
+	_histogram.reset();
+}
+
+// --------
+// moveData
+// --------
+
+/**
+ * @brief Appends available entropic data to the vector byte stream;
+ *        the recorded buffer is handed over without a copy when data is
+ *        empty. Override of virtual function from RandomSource.
+ *
+ * @param data a reference to a byte vector to be appended with
+ *        entropic data from the OS.
+ *
+ * @return void
+ */
+void InterfaceOSRNG::moveData(std::vector<uint8_t>& data) {
+
+	// Append by copy if data already holds bytes.
+	if (!data.empty()) {
+		appendData(data);
+		return;
+	}
+
+	// Hand over recorded bytes and release the buffer previously held by data.
+	data.swap(_osrngData);
+	std::vector<uint8_t>().swap(_osrngData);
+
+	// Reset sample counts for further captures.
+	_histogram.reset();
 }
 
 // ----------
@@ -83,27 +125,8 @@ void InterfaceOSRNG::appendData(std::vector<uint8_t>& data) {
  * @return double vector with bit occurrence probabilities.
  */
 std::vector<double> InterfaceOSRNG::bitEntropy() {
-	// Compute present entropy estimate.
-	auto tempEntropy = _bitEntropy;
-
-	// Normalize bit occurrence in bytes recorded.
-	double normalizer = _osrngData.size();
-
-	if (std::fabs(normalizer)<0.01) {
-		normalizer = 1.0f;
-	}
-
-	std::transform(
-		tempEntropy.begin(),
-		tempEntropy.end(),
-		tempEntropy.begin(),
-		[normalizer] (double val) {
-			return val / normalizer;
-		}
-	);
-
-	// Return bit occurrence probabilities of entropic data.
-	return tempEntropy;
+	// Derive bit occurrence probabilities from counts of recorded bytes.
+	return _histogram.bitProbabilities();
 }
 
 // -------------------
@@ -111,48 +134,184 @@ std::vector<double> InterfaceOSRNG::bitEntropy() {
 // -------------------
 
 /**
- * @brief Captures random bytes from OS generator.
+ * @brief Captures random bytes from OS generator. The request can be
+ *        split across worker threads, each filling its own region and
+ *        keeping its own sample counts.
  *
  * @param size_t with number of bytes to be recorded (default 1MB).
+ * @param numThreads size_t with number of worker threads; 0 uses the
+ *        hardware concurrency (default 1). Each thread fills at least
+ *        OS_THREAD_MIN_BYTES.
  *
  * @return true, if bytes were generated successfully.
  */
-bool InterfaceOSRNG::generateRandomBytes(size_t numBytes) {
-	// Compute total storage required.
-	size_t requiredStorage = _osrngData.size() + numBytes;
+bool InterfaceOSRNG::generateRandomBytes(size_t numBytes, size_t numThreads) {
+	// Bytes are written directly after data already recorded.
+	size_t offset = _osrngData.size();
 
 	try {
 		// Check if data can be held.
-		if (_osrngData.max_size() < requiredStorage) {
+		if (_osrngData.max_size() - offset < numBytes) {
 			// Update numBytes to max possible.
-			numBytes = _osrngData.max_size() - _osrngData.size();
-
-			// Reserve max size.
-			_osrngData.reserve(_osrngData.max_size());
-		} else {
-			_osrngData.reserve(requiredStorage);
+			numBytes = _osrngData.max_size() - offset;
 		}
 
-		std::vector<uint8_t> tempVec(numBytes);
+		_osrngData.resize(offset + numBytes);
+	} catch (const std::bad_alloc& ba) {
+		std::cerr << "[Memory Error] Samples discarded." << std::endl;
+		return false;
+	}
+
+	uint8_t* output = _osrngData.data() + offset;
+
+	// Use hardware concurrency if requested.
+	if (numThreads == 0) {
+		numThreads = std::thread::hardware_concurrency();
+	}
+
+	// Limit threads so that each fills at least OS_THREAD_MIN_BYTES.
+	size_t maxThreads = numBytes / InterfaceOSRNG::OS_THREAD_MIN_BYTES;
+	if (numThreads > maxThreads) {
+		numThreads = maxThreads;
+	}
+	if (numThreads == 0) {
+		numThreads = 1;
+	}
+
+	// Each worker fills a region and counts its samples independently.
+	size_t regionSize = numBytes / numThreads;
+	std::vector<BitHistogram<uint8_t> > histograms(numThreads);
+	std::vector<char> filled(numThreads, 0);
+
+	auto fillRegion = [&] (size_t region) {
+		uint8_t* begin = output + region * regionSize;
+		size_t length = (region == numThreads - 1)
+			? numBytes - region * regionSize
+			: regionSize;
 
+		// Read the kernel RNG directly.
+		if (InterfaceOSRNG::readKernel(begin, length)) {
+			histograms[region].add(begin, begin + length);
+			filled[region] = 1;
+		}
+	};
+
+	// Region 0 is filled by the calling thread.
+	std::vector<std::thread> workers;
+	for (size_t region = 1; region < numThreads; ++region) {
 		try {
-			// Generate numBytes from OS generator.
-			_generator.GenerateBlock(tempVec.data(), numBytes);
-		} catch (...) {
-			std::cerr << "[Failed] OS RNG failed to generate bytes" << std::endl;
-			return false;
+			workers.push_back(std::thread(fillRegion, region));
+		} catch (const std::system_error& e) {
+			fillRegion(region); // Thread unavailable; fill inline.
 		}
+	}
 
-		// Copy bytes and update bit occurrence.
-		copyNCompEntropy(
-			tempVec.begin(),
-			tempVec.end(),
-			std::back_inserter(_osrngData)
-		);
-	} catch (const std::bad_alloc& ba) {
-		std::cerr << "[Memory Error] Samples discarded." << std::endl;
-		return false;
+	fillRegion(0);
+
+	for (auto it = workers.begin(); it != workers.end(); ++it) {
+		it->join();
+	}
+
+	for (size_t region = 0; region < numThreads; ++region) {
+		if (!filled[region]) {
+			uint8_t* begin = output + region * regionSize;
+			size_t length = (region == numThreads - 1)
+				? numBytes - region * regionSize
+				: regionSize;
+
+			try {
+				// Generate region from crypto++, the portable fallback.
+				_generator.GenerateBlock(begin, length);
+			} catch (...) {
+				std::cerr << "[Failed] OS RNG failed to generate bytes" << std::endl;
+				_osrngData.resize(offset);
+				return false;
+			}
+
+			histograms[region].add(begin, begin + length);
+		}
+
+		// Merge sample counts of the region.
+		_histogram.merge(histograms[region]);
 	}
 
 	return true;
-}
\ No newline at end of file
+}
+
+// ----------
+// readKernel
+// ----------
+
+/**
+ * @brief Fills a buffer directly from the kernel RNG; getrandom(2) in
+ *        OS_READ_CHUNK reads, falling back to /dev/urandom. Linux only.
+ *
+ * @param output pointer to memory to hold numBytes bytes.
+ * @param numBytes size_t with number of bytes to read.
+ *
+ * @return true, if numBytes bytes were read.
+ */
+bool InterfaceOSRNG::readKernel(uint8_t* output, size_t numBytes) {
+#if defined(__linux__)
+	size_t total = 0; // Track bytes read.
+
+#ifdef SYS_getrandom
+	// Read in chunks; getrandom may return fewer bytes than requested.
+	while (total < numBytes) {
+		size_t chunk = InterfaceOSRNG::OS_READ_CHUNK;
+		if (numBytes - total < chunk) {
+			chunk = numBytes - total;
+		}
+
+		long result = syscall(SYS_getrandom, output + total, chunk, 0);
+
+		if (result < 0) {
+			if (errno == EINTR) {
+				continue; // Interrupted by a signal; retry.
+			}
+			break; // e.g. ENOSYS on kernels older than 3.17.
+		}
+
+		total += static_cast<size_t>(result);
+	}
+
+	if (total == numBytes) {
+		return true;
+	}
+#endif
+
+	// Fall back to large reads from /dev/urandom.
+	int fd = open("/dev/urandom", O_RDONLY | O_CLOEXEC);
+	if (fd < 0) {
+		return false;
+	}
+
+	while (total < numBytes) {
+		size_t chunk = InterfaceOSRNG::OS_READ_CHUNK;
+		if (numBytes - total < chunk) {
+			chunk = numBytes - total;
+		}
+
+		ssize_t result = read(fd, output + total, chunk);
+
+		if (result < 0 && errno == EINTR) {
+			continue; // Interrupted by a signal; retry.
+		}
+
+		if (result <= 0) {
+			break;
+		}
+
+		total += static_cast<size_t>(result);
+	}
+
+	close(fd);
+
+	return total == numBytes;
+#else
+	// No direct kernel interface; use the portable generator.
+	(void)output;
+	(void)numBytes;
+	return false;
+#endif
+}
@@ -189,6 +189,131 @@ int measureEntropyInvalid () {
 	return retVal;
 }
 
+// --------------------
+// generateChunkedValid
+// --------------------
+
+/**
+ * @brief Attempt to record more bytes than a single kernel read returns and
+ *        to record again after data has been appended.
+ *
+ * @return true, if test passed.
+ */
+int generateChunkedValid () {
+	std::cerr << "**Running test generateChunkedValid**" << std::endl;
+
+	InterfaceOSRNG osrng;
+	std::vector<uint8_t> data;
+	size_t numBytes = InterfaceOSRNG::OS_READ_CHUNK + 4096;
+
+	// Record bytes spanning more than one chunk.
+	bool retVal = osrng.generateRandomBytes(numBytes);
+	osrng.appendData(data);
+	retVal = retVal && (data.size() == numBytes);
+
+	// Tail of the recorded bytes must have been written.
+	retVal = retVal
+		&& (std::count(data.end() - 4096, data.end(), 0) < 4096);
+
+	// Record again after appending; entropy estimate must be available.
+	retVal = retVal && osrng.generateRandomBytes(1024);
+	std::vector<double> entropy = osrng.bitEntropy();
+	double meanEntropy = std::accumulate(entropy.begin(), entropy.end(), 0.0f);
+	retVal = retVal && (entropy.size() == 8) && (meanEntropy / 8 > 0.1);
+
+	if (!retVal) {
+		std::cerr << "!!Failed generateChunkedValid test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return retVal;
+}
+
+// -------------
+// moveDataValid
+// -------------
+
+/**
+ * @brief Attempt to take over entropic bytes without a copy; the source must
+ *        be emptied.
+ *
+ * @return true, if test passed.
+ */
+int moveDataValid () {
+	std::cerr << "**Running test moveDataValid**" << std::endl;
+
+	InterfaceOSRNG osrng;
+
+	// Record random bytes from OS.
+	osrng.generateRandomBytes(1024*1024);
+	std::vector<uint8_t> data;
+
+	// Take over recorded bytes; sum should be non-zero.
+	osrng.moveData(data);
+	size_t sum = std::accumulate(data.begin(), data.end(), 0);
+	bool retVal = (sum > 0);
+
+	// Nothing is left to take over and the entropy estimate is reset.
+	std::vector<uint8_t> rest;
+	osrng.moveData(rest);
+	std::vector<double> entropy = osrng.bitEntropy();
+	double meanEntropy = std::accumulate(entropy.begin(), entropy.end(), 0.0f);
+	retVal = retVal && rest.empty() && (std::fabs(meanEntropy) < 0.01f);
+
+	if (!retVal) {
+		std::cerr << "!!Failed moveDataValid test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return retVal;
+}
+
+// ---------------------
+// generateParallelValid
+// ---------------------
+
+/**
+ * @brief Attempt to record bytes on several worker threads; all regions must
+ *        be written and counted in the entropy estimate.
+ *
+ * @return true, if test passed.
+ */
+int generateParallelValid () {
+	std::cerr << "**Running test generateParallelValid**" << std::endl;
+
+	InterfaceOSRNG osrng;
+	std::vector<uint8_t> data;
+	size_t numBytes = 4 * InterfaceOSRNG::OS_THREAD_MIN_BYTES + 3;
+
+	// Record bytes on 4 threads; the last region holds the remainder.
+	bool retVal = osrng.generateRandomBytes(numBytes, 4);
+
+	// Bits of merged counts must occur with probability ~0.5.
+	std::vector<double> entropy = osrng.bitEntropy();
+	for (auto it = entropy.begin(); it != entropy.end(); ++it) {
+		retVal = retVal && (std::fabs(*it - 0.5) < 0.01);
+	}
+
+	osrng.appendData(data);
+	retVal = retVal && (data.size() == numBytes);
+
+	// Start of each region must have been written.
+	for (size_t i = 0; i < 4; ++i) {
+		auto begin = data.begin() + i * (numBytes / 4);
+		retVal = retVal && (std::count(begin, begin + 64, 0) < 64);
+	}
+
+	if (!retVal) {
+		std::cerr << "!!Failed generateParallelValid test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return retVal;
+}
+
 int main() {
 	/* Run tests and count passed.
 	 * Order matters.
@@ -198,13 +323,16 @@ int main() {
 	passed += measureEntropyValid();
 	passed += appendDataInvalid();
 	passed += measureEntropyInvalid();
+	passed += generateChunkedValid();
+	passed += moveDataValid();
+	passed += generateParallelValid();
 
 
 	std::cerr << std::endl;
-	std::cerr << "--Passed " << passed << "/4" << " tests--" << std::endl;
+	std::cerr << "--Passed " << passed << "/7" << " tests--" << std::endl;
 
 	// Assert passing all tests.
-	assert(passed == 4);
+	assert(passed == 7);
 
 	return 0;
 }
@@ -0,0 +1,145 @@
+/** @file interfaceSnapshot.h
+ *  @brief Interface to a snapshot of volatile process and system state
+ *         (clocks, resource usage, kernel counters, addresses) to gather
+ *         entropic bytes.
+ *
+ *  @author Aashish Sheshadri
+ *  @author Rohit Harchandani
+ *
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2015, 2016, 2017 PayPal
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef INTERFACESNAPSHOT_H
+#define INTERFACESNAPSHOT_H
+
+// -----------------
+// standard includes
+// -----------------
+#include <vector>
+#include <iterator>
+#include <iostream>
+
+// ----------------
+// library includes
+// ----------------
+#include "randomSource.h"
+#include "bitHistogram.h"
+
+/**
+ * @class InterfaceSnapshot tasked with recording a cheap snapshot of
+ *        volatile process and system state and provide an entropy estimate
+ *        per byte. The state is structured, not noise; it is meant to be
+ *        mixed with a fixed, conservative credit (SNAPSHOT_CREDIT_BITS).
+ *        Inherits the abstract class RandomSource
+ */
+class InterfaceSnapshot: public RandomSource {
+public:
+
+	// ---------
+	// constants
+	// ---------
+
+	// Min-entropy in bits credited per snapshot (deliberately conservative).
+	static const size_t SNAPSHOT_CREDIT_BITS = 8;
+
+	// Maximum bytes read from each kernel state file.
+	static const size_t SNAPSHOT_FILE_LIMIT = 16*1024;
+
+	// -----------
+	// Constructor
+	// -----------
+
+	/**
+	 * Constructor
+	 * @brief Creates InterfaceSnapshot object.
+	 */
+	InterfaceSnapshot();
+
+	// ----------
+	// appendData
+	// ----------
+
+	/**
+	 * @brief Appends available entropic data to the vector byte stream.
+	 *        Implementation of pure virtual function from RandomSource.
+	 *
+	 * @param data a reference to a byte vector to be appended with
+	 *        recorded state snapshots.
+	 *
+	 * @return void
+	 */
+	void appendData(std::vector<uint8_t>& data);
+
+	// --------
+	// moveData
+	// --------
+
+	/**
+	 * @brief Appends available entropic data to the vector byte stream;
+	 *        the recorded buffer is handed over without a copy when data is
+	 *        empty. Override of virtual function from RandomSource.
+	 *
+	 * @param data a reference to a byte vector to be appended with
+	 *        recorded state snapshots.
+	 *
+	 * @return void
+	 */
+	void moveData(std::vector<uint8_t>& data);
+
+	// ----------
+	// bitEntropy
+	// ----------
+
+	/**
+	 * @brief Returns bit occurrence probabilities of recorded snapshot
+	 *        bytes. Structured state skews these; credit is fixed instead.
+	 *        Implementation of pure virtual function from RandomSource.
+	 *
+	 * @return double vector with bit occurrence probabilities.
+	 */
+	std::vector<double> bitEntropy();
+
+	// ---------------
+	// captureSnapshot
+	// ---------------
+
+	/**
+	 * @brief Records one snapshot of volatile state: high resolution clocks,
+	 *        process and thread ids, stack/heap/image addresses (ASLR),
+	 *        resource usage and, on Linux, /proc/self/stat, /proc/stat and
+	 *        /proc/interrupts with a clock reading after each file.
+	 *
+	 * @return true, if a snapshot was recorded.
+	 */
+	bool captureSnapshot();
+
+private:
+
+	// ----
+	// data
+	// ----
+	std::vector<uint8_t> _snapshotData; // Vector of recorded snapshots.
+	BitHistogram<uint8_t> _histogram; // Sample counts for bit estimate.
+};
+
+#endif
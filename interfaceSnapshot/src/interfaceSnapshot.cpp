@@ -0,0 +1,365 @@
+/** @file interfaceSnapshot.cpp
+ *  @brief Interface to a snapshot of volatile process and system state
+ *         (clocks, resource usage, kernel counters, addresses) to gather
+ *         entropic bytes.
+ *
+ *  @author Aashish Sheshadri
+ *  @author Rohit Harchandani
+ *
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2015, 2016, 2017 PayPal
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+// -----------------
+// standard includes
+// -----------------
+#include <chrono>
+#include <thread>
+#include <memory>
+#include <functional>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+
+#if defined(__unix__) || defined(__APPLE__)
+	#include <unistd.h>
+	#include <fcntl.h>
+	#include <time.h>
+	#include <sys/resource.h>
+	#define SNAPSHOT_POSIX 1
+#else
+	#define SNAPSHOT_POSIX 0
+#endif
+
+#if defined(__linux__)
+	#include <sys/syscall.h>
+#endif
+
+#if defined(_WIN32)
+	#include <process.h>
+#endif
+
+// ----------------
+// library includes
+// ----------------
+#include "interfaceSnapshot.h"
+
+// -----------
+// appendBytes
+// -----------
+
+/**
+ * @brief Appends the object representation of a value to data.
+ *
+ * @param data reference to a byte vector to be appended.
+ * @param value const pointer to the value.
+ * @param size size_t with size of the value in bytes.
+ *
+ * @return void
+ */
+static void appendBytes(
+	std::vector<uint8_t>& data,
+	const void* value,
+	size_t size
+) {
+	const uint8_t* bytes = static_cast<const uint8_t*>(value);
+	data.insert(data.end(), bytes, bytes + size);
+}
+
+// ------------
+// appendClocks
+// ------------
+
+/**
+ * @brief Appends readings of all high resolution clocks available.
+ *
+ * @param data reference to a byte vector to be appended.
+ *
+ * @return void
+ */
+static void appendClocks(std::vector<uint8_t>& data) {
+	int64_t ticks[] = {
+		static_cast<int64_t>(
+			std::chrono::high_resolution_clock::now().time_since_epoch().count()
+		),
+		static_cast<int64_t>(
+			std::chrono::steady_clock::now().time_since_epoch().count()
+		),
+		static_cast<int64_t>(
+			std::chrono::system_clock::now().time_since_epoch().count()
+		),
+		static_cast<int64_t>(std::clock())
+	};
+	appendBytes(data, ticks, sizeof(ticks));
+
+#if SNAPSHOT_POSIX
+	// Process and thread cpu time clocks in addition to wall clocks.
+	clockid_t clocks[] = {
+		CLOCK_REALTIME,
+		CLOCK_MONOTONIC,
+		CLOCK_PROCESS_CPUTIME_ID,
+		CLOCK_THREAD_CPUTIME_ID
+	};
+
+	for (size_t i = 0; i < sizeof(clocks) / sizeof(clocks[0]); ++i) {
+		struct timespec now;
+		if (clock_gettime(clocks[i], &now) == 0) {
+			int64_t reading[] = {
+				static_cast<int64_t>(now.tv_sec),
+				static_cast<int64_t>(now.tv_nsec)
+			};
+			appendBytes(data, reading, sizeof(reading));
+		}
+	}
+#endif
+}
+
+// ----------
+// appendFile
+// ----------
+
+/**
+ * @brief Appends up to limit bytes read from a (kernel state) file.
+ *
+ * @param data reference to a byte vector to be appended.
+ * @param path const pointer to the path of the file.
+ * @param limit size_t with maximum number of bytes to read.
+ *
+ * @return true, if bytes were read.
+ */
+static bool appendFile(
+	std::vector<uint8_t>& data,
+	const char* path,
+	size_t limit
+) {
+#if SNAPSHOT_POSIX
+	int fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		return false;
+	}
+
+	// Read into the tail of data, shrinking to the bytes actually read.
+	size_t offset = data.size();
+	data.resize(offset + limit);
+	size_t total = 0;
+
+	while (total < limit) {
+		ssize_t count = read(fd, data.data() + offset + total, limit - total);
+		if (count < 0 && errno == EINTR) {
+			continue;
+		}
+		if (count <= 0) {
+			break;
+		}
+		total += static_cast<size_t>(count);
+	}
+
+	close(fd);
+	data.resize(offset + total);
+
+	return total > 0;
+#else
+	(void)data;
+	(void)path;
+	(void)limit;
+	return false;
+#endif
+}
+
+// -----------
+// Constructor
+// -----------
+
+/**
+ * Constructor
+ * @brief Creates InterfaceSnapshot object.
+ */
+InterfaceSnapshot::InterfaceSnapshot() {}
+
+// ----------
+// appendData
+// ----------
+
+/**
+ * @brief Appends available entropic data to the vector byte stream.
+ *        Implementation of pure virtual function from RandomSource.
+ *
+ * @param data a reference to a byte vector to be appended with
+ *        recorded state snapshots.
+ *
+ * @return void
+ */
+void InterfaceSnapshot::appendData(std::vector<uint8_t>& data) {
+	try {
+		// Reserve space for data to be appended.
+		data.reserve(data.size() + _snapshotData.size());
+	} catch (const std::bad_alloc& ba) {
+		std::cerr << "[Memory Error] Cannot Append: " << std::endl;
+		return;
+	}
+
+	// Append available snapshot data.
+	std::copy(
+		_snapshotData.begin(),
+		_snapshotData.end(),
+		std::back_inserter(data)
+	);
+
+	// Clear snapshot data and reset sample counts for further captures.
+	_snapshotData.clear();
+	_histogram.reset();
+}
+
+// --------
+// moveData
+// --------
+
+/**
+ * @brief Appends available entropic data to the vector byte stream;
+ *        the recorded buffer is handed over without a copy when data is
+ *        empty. Override of virtual function from RandomSource.
+ *
+ * @param data a reference to a byte vector to be appended with
+ *        recorded state snapshots.
+ *
+ * @return void
+ */
+void InterfaceSnapshot::moveData(std::vector<uint8_t>& data) {
+
+	// Append by copy if data already holds bytes.
+	if (!data.empty()) {
+		appendData(data);
+		return;
+	}
+
+	// Hand over recorded bytes and release the buffer previously held by data.
+	data.swap(_snapshotData);
+	std::vector<uint8_t>().swap(_snapshotData);
+
+	// Reset sample counts for further captures.
+	_histogram.reset();
+}
+
+// ----------
+// bitEntropy
+// ----------
+
+/**
+ * @brief Returns bit occurrence probabilities of recorded snapshot
+ *        bytes. Structured state skews these; credit is fixed instead.
+ *        Implementation of pure virtual function from RandomSource.
+ *
+ * @return double vector with bit occurrence probabilities.
+ */
+std::vector<double> InterfaceSnapshot::bitEntropy() {
+	// Derive bit occurrence probabilities from counts of recorded bytes.
+	return _histogram.bitProbabilities();
+}
+
+// ---------------
+// captureSnapshot
+// ---------------
+
+/**
+ * @brief Records one snapshot of volatile state: high resolution clocks,
+ *        process and thread ids, stack/heap/image addresses (ASLR),
+ *        resource usage and, on Linux, /proc/self/stat, /proc/stat and
+ *        /proc/interrupts with a clock reading after each file.
+ *
+ * @return true, if a snapshot was recorded.
+ */
+bool InterfaceSnapshot::captureSnapshot() {
+	size_t offset = _snapshotData.size();
+
+	try {
+		// Reserve space for clocks, ids and the kernel state files.
+		_snapshotData.reserve(
+			offset + 3 * InterfaceSnapshot::SNAPSHOT_FILE_LIMIT + 1024
+		);
+
+		appendClocks(_snapshotData);
+
+		// Addresses of stack, heap, image and thread local storage (ASLR).
+		int stackMarker = 0;
+		std::unique_ptr<int> heapMarker(new int(0));
+		uintptr_t addresses[] = {
+			reinterpret_cast<uintptr_t>(&stackMarker),
+			reinterpret_cast<uintptr_t>(heapMarker.get()),
+			reinterpret_cast<uintptr_t>(&appendBytes),
+			reinterpret_cast<uintptr_t>(&errno)
+		};
+		appendBytes(_snapshotData, addresses, sizeof(addresses));
+
+		// Process and thread ids.
+		uint64_t ids[] = {
+			static_cast<uint64_t>(
+				std::hash<std::thread::id>()(std::this_thread::get_id())
+			),
+#if SNAPSHOT_POSIX
+			static_cast<uint64_t>(getpid()),
+			static_cast<uint64_t>(getppid()),
+#elif defined(_WIN32)
+			static_cast<uint64_t>(_getpid()),
+#endif
+#if defined(__linux__)
+			static_cast<uint64_t>(syscall(SYS_gettid)),
+#endif
+			0
+		};
+		appendBytes(_snapshotData, ids, sizeof(ids));
+
+#if SNAPSHOT_POSIX
+		// Resource usage: cpu times, page faults, context switches.
+		struct rusage usage;
+		std::memset(&usage, 0, sizeof(usage));
+		if (getrusage(RUSAGE_SELF, &usage) == 0) {
+			appendBytes(_snapshotData, &usage, sizeof(usage));
+		}
+#endif
+
+		// Kernel counters; the clock after each read records its duration.
+		const char* files[] = {
+			"/proc/self/stat",
+			"/proc/stat",
+			"/proc/interrupts"
+		};
+
+		for (size_t i = 0; i < sizeof(files) / sizeof(files[0]); ++i) {
+			if (appendFile(
+				_snapshotData,
+				files[i],
+				InterfaceSnapshot::SNAPSHOT_FILE_LIMIT
+			)) {
+				appendClocks(_snapshotData);
+			}
+		}
+	} catch (const std::bad_alloc& ba) {
+		std::cerr << "[Memory Error] Snapshot discarded." << std::endl;
+		_snapshotData.resize(offset);
+		return false;
+	}
+
+	// Count recorded bytes.
+	_histogram.add(_snapshotData.begin() + offset, _snapshotData.end());
+
+	return _snapshotData.size() > offset;
+}
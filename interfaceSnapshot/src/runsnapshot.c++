@@ -0,0 +1,227 @@
+/** @file runsnapshot.c++
+ *  @brief Test public functions from interfaceSnapshot.h
+ *
+ *  @author Aashish Sheshadri
+ *  @author Rohit Harchandani
+ *
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2015, 2016, 2017 PayPal
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+// -----------------
+// standard includes
+// -----------------
+#include <cassert>
+#include <numeric>
+#include <vector>
+#include <cmath>
+#include <chrono>
+#include <algorithm>
+
+// ----------------
+// library includes
+// ----------------
+#include "interfaceSnapshot.h"
+
+// ---------------
+// appendDataValid
+// ---------------
+
+/**
+ * @brief Attempt to get entropic bytes from a state snapshot.
+ *
+ * @return true, if test passed.
+ */
+int appendDataValid () {
+	std::cerr << "**Running test appendDataValid**" << std::endl;
+
+	InterfaceSnapshot snapshot;
+	std::vector<uint8_t> data;
+
+	// Record a snapshot and append it; sum should be non-zero.
+	bool retVal = snapshot.captureSnapshot();
+	snapshot.appendData(data);
+	size_t sum = std::accumulate(data.begin(), data.end(), 0);
+	retVal = retVal && !data.empty() && (sum > 0);
+
+	if (!retVal) {
+		std::cerr << "!!Failed appendDataValid test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return retVal;
+}
+
+// -----------------
+// snapshotsDistinct
+// -----------------
+
+/**
+ * @brief Attempt to record two snapshots; clocks alone must make them
+ *        differ.
+ *
+ * @return true, if test passed.
+ */
+int snapshotsDistinct () {
+	std::cerr << "**Running test snapshotsDistinct**" << std::endl;
+
+	InterfaceSnapshot snapshot;
+	std::vector<uint8_t> first;
+	std::vector<uint8_t> second;
+
+	bool retVal = snapshot.captureSnapshot();
+	snapshot.moveData(first);
+	retVal = retVal && snapshot.captureSnapshot();
+	snapshot.moveData(second);
+
+	retVal = retVal && !first.empty() && (first != second);
+
+	if (!retVal) {
+		std::cerr << "!!Failed snapshotsDistinct test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return retVal;
+}
+
+// -----------------
+// appendDataInvalid
+// -----------------
+
+/**
+ * @brief attempt to get entropic bytes before a snapshot is recorded.
+ *
+ * @return true, if test passed.
+ */
+int appendDataInvalid () {
+	std::cerr << "**Running test appendDataInvalid**" << std::endl;
+
+	InterfaceSnapshot snapshot;
+	std::vector<uint8_t> data;
+
+	// Attempt to get data from snapshot before recording.
+	snapshot.appendData(data);
+	std::vector<double> entropy = snapshot.bitEntropy();
+	double meanEntropy = std::accumulate(entropy.begin(), entropy.end(), 0.0f);
+	bool retVal = data.empty() && (std::fabs(meanEntropy) < 0.01f);
+
+	if (!retVal) {
+		std::cerr << "!!Failed appendDataInvalid test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return retVal;
+}
+
+// -------------
+// moveDataValid
+// -------------
+
+/**
+ * @brief Attempt to take over entropic bytes without a copy; the source must
+ *        be emptied.
+ *
+ * @return true, if test passed.
+ */
+int moveDataValid () {
+	std::cerr << "**Running test moveDataValid**" << std::endl;
+
+	InterfaceSnapshot snapshot;
+	std::vector<uint8_t> data;
+
+	// Take over the recorded snapshot.
+	bool retVal = snapshot.captureSnapshot();
+	snapshot.moveData(data);
+	retVal = retVal && !data.empty();
+
+	// Nothing is left to take over.
+	std::vector<uint8_t> rest;
+	snapshot.moveData(rest);
+	retVal = retVal && rest.empty();
+
+	if (!retVal) {
+		std::cerr << "!!Failed moveDataValid test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return retVal;
+}
+
+// -----------------
+// captureCheapValid
+// -----------------
+
+/**
+ * @brief Attempt to record snapshots quickly; meant for the startup path,
+ *        each should take well under a millisecond (bound kept loose).
+ *
+ * @return true, if test passed.
+ */
+int captureCheapValid () {
+	std::cerr << "**Running test captureCheapValid**" << std::endl;
+
+	InterfaceSnapshot snapshot;
+	bool retVal = true;
+
+	// Time 10 snapshots.
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < 10; ++i) {
+		retVal = retVal && snapshot.captureSnapshot();
+	}
+	double seconds = std::chrono::duration<double>(
+		std::chrono::steady_clock::now() - start
+	).count();
+
+	retVal = retVal && (seconds < 0.5);
+
+	if (!retVal) {
+		std::cerr << "!!Failed captureCheapValid test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return retVal;
+}
+
+int main() {
+	/* Run tests and count passed.
+	 * Order matters.
+	 */
+	int passed = 0;
+	passed += appendDataValid();
+	passed += snapshotsDistinct();
+	passed += appendDataInvalid();
+	passed += moveDataValid();
+	passed += captureCheapValid();
+
+	std::cerr << std::endl;
+	std::cerr << "--Passed " << passed << "/5" << " tests--" << std::endl;
+
+	// Assert passing all tests.
+	assert(passed == 5);
+
+	return 0;
+}
@@ -0,0 +1,251 @@
+/** @file interfaceVideoFile.h
+ *  @brief Replays frames of a video file or image directory as a random source.
+ *
+ *  @author Aashish Sheshadri
+ *  @author Rohit Harchandani
+ *
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2015, 2016, 2017 PayPal
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef INTERFACEVIDEOFILE_H
+#define INTERFACEVIDEOFILE_H
+
+// -----------------
+// standard includes
+// -----------------
+#include <string>
+#include <vector>
+#include <iostream>
+
+// --------------------
+// third party includes
+// --------------------
+#include <opencv2/opencv.hpp>
+
+// ----------------
+// library includes
+// ----------------
+#include "randomSource.h"
+#include "bitHistogram.h"
+#include "frameToBytes.h"
+
+/**
+ * @class InterfaceVideoFile tasked with replaying frames decoded from a
+ *        video file, an image sequence or a directory of images and
+ *        provide an entropy estimate per sample. Frames are converted and
+ *        counted exactly as InterfaceCamera does, enabling capture free
+ *        benchmarks.
+ *        Inherits the abstract class RandomSource.
+ */
+class InterfaceVideoFile: public RandomSource {
+public:
+
+	// -----------
+	// Constructor
+	// -----------
+
+	/**
+	 * Constructor
+	 * @brief Creates InterfaceVideoFile object without an open file.
+	 */
+	InterfaceVideoFile();
+
+	// ----------
+	// Destructor
+	// ----------
+
+	/**
+	 * Destructor
+	 * @brief Releases the open file, if any.
+	 */
+	~InterfaceVideoFile();
+
+	// ----------
+	// appendData
+	// ----------
+
+	/**
+	 * @brief Appends available entropic data to the vector byte stream.
+	 *        Implementation of pure virtual function from RandomSource.
+	 *
+	 * @param data a reference to a byte vector to be appended with
+	 *        replayed frame samples.
+	 *
+	 * @return void
+	 */
+	void appendData(std::vector<uint8_t>& data);
+
+	// --------
+	// moveData
+	// --------
+
+	/**
+	 * @brief Appends available entropic data to the vector byte stream;
+	 *        the recorded buffer is handed over without a copy when data is
+	 *        empty. Override of virtual function from RandomSource.
+	 *
+	 * @param data a reference to a byte vector to be appended with
+	 *        replayed frame samples.
+	 *
+	 * @return void
+	 */
+	void moveData(std::vector<uint8_t>& data);
+
+	// ----------
+	// bitEntropy
+	// ----------
+
+	/**
+	 * @brief Returns entropy estimate of replayed samples as bit
+	 *        occurrence probabilities.
+	 *        Implementation of pure virtual function from RandomSource.
+	 *
+	 * @return double vector with bit occurrence probabilities.
+	 */
+	std::vector<double> bitEntropy();
+
+	// ------------
+	// setNoiseBits
+	// ------------
+
+	/**
+	 * @brief Selects how frames are recorded: whole frames (0) or only the
+	 *        noiseBits low order bits of the differences between
+	 *        consecutive replayed frames, packed into bytes, as the camera
+	 *        does. The bit estimate then covers the packed bytes.
+	 *
+	 * @param noiseBits unsigned with low order bits kept per residual, at
+	 *        most NoiseBitPacker::MAX_NOISE_BITS; 0 records whole frames.
+	 * @param gridStep size_t; only every gridStep-th row and column of a
+	 *        frame is differenced (default 1, all pixels).
+	 * @param region const reference to a Rect limiting the differenced
+	 *        pixels (default empty, the whole frame).
+	 *
+	 * @return true, if the mode was set.
+	 */
+	bool setNoiseBits(
+		unsigned noiseBits,
+		size_t gridStep = 1,
+		const cv::Rect& region = cv::Rect()
+	);
+
+	// --------
+	// openFile
+	// --------
+
+	/**
+	 * @brief Opens frames for replay. A directory is replayed as its
+	 *        image files in name order (files that do not decode are
+	 *        skipped); any other path is opened as a video file or image
+	 *        sequence pattern (e.g. frame_%04d.png) by OpenCV.
+	 *
+	 * @param path const reference to a string with the path.
+	 *
+	 * @return true, if frames can be replayed from path.
+	 */
+	bool openFile(const std::string& path);
+
+	// ---------
+	// closeFile
+	// ---------
+
+	/**
+	 * @brief Releases the open file; recorded bytes are kept.
+	 *
+	 * @return void
+	 */
+	void closeFile();
+
+	// ----------
+	// readFrames
+	// ----------
+
+	/**
+	 * @brief Replays up to numFrames frames from the current position into
+	 *        the recorded bytes and sample counts. With noise bits set, a
+	 *        frame of another size or type than the frame before starts a
+	 *        new burst of differences.
+	 *
+	 * @param numFrames size_t with number of frames to replay.
+	 *
+	 * @return size_t with number of frames replayed.
+	 */
+	size_t readFrames(size_t numFrames);
+
+	// ------
+	// rewind
+	// ------
+
+	/**
+	 * @brief Restarts replay from the first frame.
+	 *
+	 * @return true, if replay was restarted.
+	 */
+	bool rewind();
+
+	// ------
+	// isOpen
+	// ------
+
+	/**
+	 * @brief Returns whether frames are open for replay.
+	 *
+	 * @return true, if a file or directory is open.
+	 */
+	bool isOpen() const;
+
+private:
+
+	// ---------
+	// readFrame
+	// ---------
+
+	/**
+	 * @brief Decodes the next frame of the open video or directory.
+	 *
+	 * @param frame reference to a Mat to hold the decoded frame.
+	 *
+	 * @return true, if a frame was decoded.
+	 */
+	bool readFrame(cv::Mat& frame);
+
+	// ----
+	// data
+	// ----
+	std::string _path; // Path of the open video, sequence or directory.
+	bool _open; // Status of replay.
+	cv::VideoCapture _capture; // Decoder of a video or image sequence.
+	std::vector<cv::String> _images; // Image files of a directory.
+	size_t _imageIndex; // Next image of _images to replay.
+	std::vector<uint8_t> _videoData; // Vector of replayed sample bytes.
+	BitHistogram<uint16_t> _histogram; // Sample counts for bit estimate.
+	unsigned _noiseBits; // Low order bits kept per residual, 0 for frames.
+	size_t _gridStep; // Row and column step of differenced pixels.
+	cv::Rect _region; // Differenced pixels, empty for the whole frame.
+	NoiseBitPacker _packer; // Packs noise bits of residuals.
+	BitHistogram<uint8_t> _packedHistogram; // Counts of packed bytes.
+	std::vector<int16_t> _residuals; // Residuals of the last difference.
+	cv::Mat _previousFrame; // Last replayed frame, differenced against.
+};
+
+#endif
@@ -0,0 +1,397 @@
+/** @file interfaceVideoFile.cpp
+ *  @brief Replays frames of a video file or image directory as a random source.
+ *
+ *  @author Aashish Sheshadri
+ *  @author Rohit Harchandani
+ *
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2015, 2016, 2017 PayPal
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+// -----------------
+// standard includes
+// -----------------
+#include <algorithm>
+#include <sys/stat.h>
+
+// ----------------
+// library includes
+// ----------------
+#include "interfaceVideoFile.h"
+
+// -----------
+// isDirectory
+// -----------
+
+/**
+ * @brief Checks whether a path names a directory.
+ *
+ * @param path const reference to a string with the path.
+ *
+ * @return true, if path is a directory.
+ */
+static bool isDirectory(const std::string& path) {
+	struct stat info;
+
+	if (stat(path.c_str(), &info) != 0) {
+		return false;
+	}
+
+	return (info.st_mode & S_IFMT) == S_IFDIR;
+}
+
+// -----------
+// Constructor
+// -----------
+
+/**
+ * Constructor
+ * @brief Creates InterfaceVideoFile object without an open file.
+ */
+InterfaceVideoFile::InterfaceVideoFile():
+	_open(false),
+	_imageIndex(0),
+	_noiseBits(0),
+	_gridStep(1) {
+
+}
+
+// ----------
+// Destructor
+// ----------
+
+/**
+ * Destructor
+ * @brief Releases the open file, if any.
+ */
+InterfaceVideoFile::~InterfaceVideoFile() {
+	closeFile();
+}
+
+// ----------
+// appendData
+// ----------
+
+/**
+ * @brief Appends available entropic data to the vector byte stream.
+ *        Implementation of pure virtual function from RandomSource.
+ *
+ * @param data a reference to a byte vector to be appended with
+ *        replayed frame samples.
+ *
+ * @return void
+ */
+void InterfaceVideoFile::appendData(std::vector<uint8_t>& data) {
+	try {
+		// Reserve space for data to be appended.
+		data.reserve(data.size() + _videoData.size());
+	} catch (const std::bad_alloc& ba) {
+		std::cerr << "[Memory Error] Cannot Append: " << std::endl;
+		return;
+	}
+	std::copy(_videoData.begin(), _videoData.end(), std::back_inserter(data));
+
+	// Clear entropic data and reset sample counts for further replays.
+	_videoData.clear();
+	_histogram.reset();
+	_packedHistogram.reset();
+}
+
+// --------
+// moveData
+// --------
+
+/**
+ * @brief Appends available entropic data to the vector byte stream;
+ *        the recorded buffer is handed over without a copy when data is
+ *        empty. Override of virtual function from RandomSource.
+ *
+ * @param data a reference to a byte vector to be appended with
+ *        replayed frame samples.
+ *
+ * @return void
+ */
+void InterfaceVideoFile::moveData(std::vector<uint8_t>& data) {
+
+	// Append by copy if data already holds bytes.
+	if (!data.empty()) {
+		appendData(data);
+		return;
+	}
+
+	// Hand over recorded bytes and release the buffer previously held by data.
+	data.swap(_videoData);
+	std::vector<uint8_t>().swap(_videoData);
+
+	// Reset sample counts for further replays.
+	_histogram.reset();
+	_packedHistogram.reset();
+}
+
+// ----------
+// bitEntropy
+// ----------
+
+/**
+ * @brief Returns entropy estimate of replayed samples as bit
+ *        occurrence probabilities.
+ *        Implementation of pure virtual function from RandomSource.
+ *
+ * @return double vector with bit occurrence probabilities.
+ */
+std::vector<double> InterfaceVideoFile::bitEntropy() {
+	// Derive bit occurrence probabilities from counts of replayed samples.
+	if (_noiseBits != 0) {
+		return _packedHistogram.bitProbabilities();
+	}
+
+	return _histogram.bitProbabilities();
+}
+
+// ------------
+// setNoiseBits
+// ------------
+
+/**
+ * @brief Selects how frames are recorded: whole frames (0) or only the
+ *        noiseBits low order bits of the differences between
+ *        consecutive replayed frames, packed into bytes, as the camera
+ *        does. The bit estimate then covers the packed bytes.
+ *
+ * @param noiseBits unsigned with low order bits kept per residual, at
+ *        most NoiseBitPacker::MAX_NOISE_BITS; 0 records whole frames.
+ * @param gridStep size_t; only every gridStep-th row and column of a
+ *        frame is differenced (default 1, all pixels).
+ * @param region const reference to a Rect limiting the differenced
+ *        pixels (default empty, the whole frame).
+ *
+ * @return true, if the mode was set.
+ */
+bool InterfaceVideoFile::setNoiseBits(
+	unsigned noiseBits,
+	size_t gridStep,
+	const cv::Rect& region
+) {
+	if (noiseBits > NoiseBitPacker::MAX_NOISE_BITS || gridStep == 0) {
+		return false;
+	}
+
+	_noiseBits = noiseBits;
+	_gridStep = gridStep;
+	_region = region;
+	_packer = NoiseBitPacker(noiseBits);
+	_previousFrame = cv::Mat();
+
+	return true;
+}
+
+// --------
+// openFile
+// --------
+
+/**
+ * @brief Opens frames for replay. A directory is replayed as its
+ *        image files in name order (files that do not decode are
+ *        skipped); any other path is opened as a video file or image
+ *        sequence pattern (e.g. frame_%04d.png) by OpenCV.
+ *
+ * @param path const reference to a string with the path.
+ *
+ * @return true, if frames can be replayed from path.
+ */
+bool InterfaceVideoFile::openFile(const std::string& path) {
+	closeFile();
+
+	if (isDirectory(path)) {
+		// List files of the directory, sorted by name.
+		cv::glob(path, _images, false);
+
+		if (_images.empty()) {
+			std::cerr << "No images in directory: " << path << std::endl;
+			return false;
+		}
+	} else if (!_capture.open(path) || !_capture.isOpened()) {
+		std::cerr << "Unable to open video file: " << path << std::endl;
+		_capture.release();
+		return false;
+	}
+
+	_path = path;
+	_open = true;
+
+	return true;
+}
+
+// ---------
+// closeFile
+// ---------
+
+/**
+ * @brief Releases the open file; recorded bytes are kept.
+ *
+ * @return void
+ */
+void InterfaceVideoFile::closeFile() {
+	_capture.release();
+	_images.clear();
+	_imageIndex = 0;
+	_path.clear();
+	_open = false;
+
+	// Replay of the next file is differenced from scratch.
+	_previousFrame = cv::Mat();
+	_packer.reset();
+}
+
+// ----------
+// readFrames
+// ----------
+
+/**
+ * @brief Replays up to numFrames frames from the current position into
+ *        the recorded bytes and sample counts. With noise bits set, a
+ *        frame of another size or type than the frame before starts a
+ *        new burst of differences.
+ *
+ * @param numFrames size_t with number of frames to replay.
+ *
+ * @return size_t with number of frames replayed.
+ */
+size_t InterfaceVideoFile::readFrames(size_t numFrames) {
+	size_t replayed = 0;
+	cv::Mat frame;
+
+	while (replayed < numFrames && readFrame(frame)) {
+		// Record samples of the frame and count them, as the camera does.
+		if (_noiseBits == 0) {
+			if (!frameToBytes(frame, _videoData, _histogram)) {
+				break;
+			}
+		} else if (!_previousFrame.empty()
+			&& (_previousFrame.size() != frame.size()
+				|| _previousFrame.type() != frame.type())) {
+			// A frame of another size or type starts a new burst.
+			_packer.reset();
+		} else if (!_previousFrame.empty() && !frameDifferenceBits(
+			_previousFrame,
+			frame,
+			_gridStep,
+			_region,
+			_residuals,
+			_packer,
+			_videoData,
+			_packedHistogram
+		)) {
+			break;
+		}
+
+		// Keep the frame to difference against; the next frame is decoded
+		// into the buffer of the frame before.
+		if (_noiseBits != 0) {
+			std::swap(_previousFrame, frame);
+		}
+
+		++replayed;
+	}
+
+	return replayed;
+}
+
+// ------
+// rewind
+// ------
+
+/**
+ * @brief Restarts replay from the first frame.
+ *
+ * @return true, if replay was restarted.
+ */
+bool InterfaceVideoFile::rewind() {
+	if (!_open) {
+		return false;
+	}
+
+	// Frames are differenced from scratch.
+	_previousFrame = cv::Mat();
+	_packer.reset();
+
+	if (!_images.empty()) {
+		_imageIndex = 0;
+		return true;
+	}
+
+	// Seeking is unreliable across decoders; open the video again.
+	_capture.release();
+
+	if (!_capture.open(_path) || !_capture.isOpened()) {
+		std::cerr << "Unable to reopen video file: " << _path << std::endl;
+		closeFile();
+		return false;
+	}
+
+	return true;
+}
+
+// ------
+// isOpen
+// ------
+
+/**
+ * @brief Returns whether frames are open for replay.
+ *
+ * @return true, if a file or directory is open.
+ */
+bool InterfaceVideoFile::isOpen() const {
+	return _open;
+}
+
+// ---------
+// readFrame
+// ---------
+
+/**
+ * @brief Decodes the next frame of the open video or directory.
+ *
+ * @param frame reference to a Mat to hold the decoded frame.
+ *
+ * @return true, if a frame was decoded.
+ */
+bool InterfaceVideoFile::readFrame(cv::Mat& frame) {
+	if (!_open) {
+		return false;
+	}
+
+	if (_images.empty()) {
+		return _capture.read(frame) && !frame.empty();
+	}
+
+	// Skip files of the directory that are not images.
+	while (_imageIndex < _images.size()) {
+		frame = cv::imread(_images[_imageIndex++], CV_LOAD_IMAGE_UNCHANGED);
+
+		if (!frame.empty()) {
+			return true;
+		}
+	}
+
+	return false;
+}
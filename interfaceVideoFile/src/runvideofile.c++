@@ -0,0 +1,478 @@
+/** @file runvideofile.c++
+ *  @brief Tests for InterfaceVideoFile.
+ *
+ *  @author Aashish Sheshadri
+ *  @author Rohit Harchandani
+ *
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2015, 2016, 2017 PayPal
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+// -----------------
+// standard includes
+// -----------------
+#include <cassert>
+#include <numeric>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstdio>
+#include <algorithm>
+#include <sys/stat.h>
+#ifdef _WIN32
+	#include <direct.h>
+#else
+	#include <unistd.h>
+#endif
+
+// ----------------
+// library includes
+// ----------------
+#include "interfaceVideoFile.h"
+
+// Directory of test frames, with one file that is not an image.
+static const std::string TEST_DIRECTORY = ".testframes";
+static const size_t TEST_FRAMES = 3;
+
+// ---------
+// frameName
+// ---------
+
+/**
+ * @brief Returns the path of test frame i.
+ */
+static std::string frameName(size_t i) {
+	return TEST_DIRECTORY + "/frame" + std::to_string(i) + ".png";
+}
+
+// ---------------
+// writeTestFrames
+// ---------------
+
+/**
+ * @brief Writes TEST_FRAMES noise frames and a text file to TEST_DIRECTORY.
+ */
+static void writeTestFrames() {
+#ifdef _WIN32
+	_mkdir(TEST_DIRECTORY.c_str());
+#else
+	mkdir(TEST_DIRECTORY.c_str(), 0755);
+#endif
+
+	for (size_t i = 0; i < TEST_FRAMES; ++i) {
+		cv::Mat frame(48, 64, CV_8UC3);
+		cv::randu(frame, cv::Scalar::all(0), cv::Scalar::all(255));
+		cv::imwrite(frameName(i), frame);
+	}
+
+	std::ofstream notes((TEST_DIRECTORY + "/notes.txt").c_str());
+	notes << "not an image" << std::endl;
+}
+
+// ----------------
+// removeTestFrames
+// ----------------
+
+/**
+ * @brief Removes the files and directory written by writeTestFrames.
+ */
+static void removeTestFrames() {
+	for (size_t i = 0; i < TEST_FRAMES; ++i) {
+		std::remove(frameName(i).c_str());
+	}
+
+	std::remove((TEST_DIRECTORY + "/notes.txt").c_str());
+
+#ifdef _WIN32
+	_rmdir(TEST_DIRECTORY.c_str());
+#else
+	rmdir(TEST_DIRECTORY.c_str());
+#endif
+}
+
+// --------------------
+// replayDirectoryValid
+// --------------------
+
+/**
+ * @brief Attempt to replay a directory of images; bytes must equal the
+ *        frames converted as captured camera frames are, and files that
+ *        are not images must be skipped.
+ *
+ * @return true, if test passed.
+ */
+int replayDirectoryValid () {
+	std::cerr << "**Running test replayDirectoryValid**" << std::endl;
+
+	writeTestFrames();
+
+	// Convert the frames directly.
+	std::vector<uint8_t> expected;
+	BitHistogram<uint16_t> histogram;
+
+	for (size_t i = 0; i < TEST_FRAMES; ++i) {
+		cv::Mat frame = cv::imread(frameName(i), CV_LOAD_IMAGE_UNCHANGED);
+		frameToBytes(frame, expected, histogram);
+	}
+
+	InterfaceVideoFile videoFile;
+
+	bool retVal = videoFile.openFile(TEST_DIRECTORY) && videoFile.isOpen();
+	retVal = retVal && (videoFile.readFrames(10) == TEST_FRAMES);
+	retVal = retVal && (videoFile.readFrames(1) == 0);
+
+	std::vector<double> entropy = videoFile.bitEntropy();
+	std::vector<uint8_t> data;
+	videoFile.appendData(data);
+
+	retVal = retVal && !data.empty() && (data == expected);
+	retVal = retVal && (entropy == histogram.bitProbabilities());
+
+	if (!retVal) {
+		std::cerr << "!!Failed replayDirectoryValid test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return retVal;
+}
+
+// -----------
+// rewindValid
+// -----------
+
+/**
+ * @brief Attempt to replay frames again after a rewind.
+ *
+ * @return true, if test passed.
+ */
+int rewindValid () {
+	std::cerr << "**Running test rewindValid**" << std::endl;
+
+	InterfaceVideoFile videoFile;
+
+	bool retVal = videoFile.openFile(TEST_DIRECTORY);
+	retVal = retVal && (videoFile.readFrames(TEST_FRAMES) == TEST_FRAMES);
+	retVal = retVal && videoFile.rewind();
+	retVal = retVal && (videoFile.readFrames(1) == 1);
+
+	videoFile.closeFile();
+	retVal = retVal && !videoFile.isOpen() && !videoFile.rewind();
+
+	if (!retVal) {
+		std::cerr << "!!Failed rewindValid test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return retVal;
+}
+
+// ----------------------
+// noiseBitsResidualValid
+// ----------------------
+
+/**
+ * @brief Attempt to replay packed noise bits of frame differences, over
+ *        whole frames and over a subsampled region; identical frames
+ *        must leave zero residuals.
+ *
+ * @return true, if test passed.
+ */
+int noiseBitsResidualValid () {
+	std::cerr << "**Running test noiseBitsResidualValid**" << std::endl;
+
+	InterfaceVideoFile videoFile;
+
+	// 4 bits of each residual sample of 2 differences of 48x64x3 frames.
+	bool retVal = videoFile.openFile(TEST_DIRECTORY);
+	retVal = retVal && !videoFile.setNoiseBits(4, 0);
+	retVal = retVal && videoFile.setNoiseBits(4);
+	retVal = retVal && (videoFile.readFrames(TEST_FRAMES) == TEST_FRAMES);
+
+	std::vector<double> entropy = videoFile.bitEntropy();
+	std::vector<uint8_t> data;
+	videoFile.moveData(data);
+
+	retVal = retVal && (entropy.size() == 8);
+	retVal = retVal && (data.size() == (TEST_FRAMES - 1) * 48 * 64 * 3 / 2);
+
+	// Every 2nd row and column of a 16x32 region.
+	retVal = retVal && videoFile.setNoiseBits(4, 2, cv::Rect(8, 8, 32, 16));
+	retVal = retVal && videoFile.rewind();
+	retVal = retVal && (videoFile.readFrames(TEST_FRAMES) == TEST_FRAMES);
+
+	data.clear();
+	videoFile.moveData(data);
+	retVal = retVal && (data.size() == (TEST_FRAMES - 1) * 8 * 16 * 3 / 2);
+
+	// Residuals of a frame and itself are zero.
+	cv::Mat frame = cv::imread(frameName(0), CV_LOAD_IMAGE_UNCHANGED);
+	std::vector<int16_t> residuals;
+	NoiseBitPacker packer(4);
+	BitHistogram<uint8_t> histogram;
+
+	data.clear();
+	retVal = retVal && frameDifferenceBits(
+		frame,
+		frame,
+		1,
+		cv::Rect(),
+		residuals,
+		packer,
+		data,
+		histogram
+	);
+	retVal = retVal && !data.empty();
+	size_t zeros = std::count(data.begin(), data.end(), 0);
+	retVal = retVal && (zeros == data.size());
+
+	if (!retVal) {
+		std::cerr << "!!Failed noiseBitsResidualValid test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return retVal;
+}
+
+// --------------
+// mixedSizeValid
+// --------------
+
+/**
+ * @brief Attempt to replay noise bits of a directory holding frames of
+ *        two sizes; a change of size starts a new burst and replay must
+ *        carry on past it on later calls.
+ *
+ * @return true, if test passed.
+ */
+int mixedSizeValid () {
+	std::cerr << "**Running test mixedSizeValid**" << std::endl;
+
+	std::string directory = TEST_DIRECTORY + "mixed";
+#ifdef _WIN32
+	_mkdir(directory.c_str());
+#else
+	mkdir(directory.c_str(), 0755);
+#endif
+
+	// Frames 48x64, 32x40, 32x40 and 48x64, in name order.
+	const int rows[] = {48, 32, 32, 48};
+	const int cols[] = {64, 40, 40, 64};
+	std::vector<std::string> names;
+
+	for (size_t i = 0; i < 4; ++i) {
+		cv::Mat frame(rows[i], cols[i], CV_8UC3);
+		cv::randu(frame, cv::Scalar::all(0), cv::Scalar::all(255));
+		names.push_back(directory + "/frame" + std::to_string(i) + ".png");
+		cv::imwrite(names.back(), frame);
+	}
+
+	InterfaceVideoFile videoFile;
+
+	bool retVal = videoFile.openFile(directory);
+	retVal = retVal && videoFile.setNoiseBits(4);
+
+	// One frame per call; none may stall at a change of size.
+	for (size_t i = 0; i < 4; ++i) {
+		retVal = retVal && (videoFile.readFrames(1) == 1);
+	}
+
+	// Only frames 1 and 2 share a size: one 32x40x3 difference.
+	std::vector<uint8_t> data;
+	videoFile.moveData(data);
+	retVal = retVal && (data.size() == 32 * 40 * 3 / 2);
+
+	videoFile.closeFile();
+
+	for (auto it = names.begin(); it != names.end(); ++it) {
+		std::remove(it->c_str());
+	}
+
+#ifdef _WIN32
+	_rmdir(directory.c_str());
+#else
+	rmdir(directory.c_str());
+#endif
+
+	if (!retVal) {
+		std::cerr << "!!Failed mixedSizeValid test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return retVal;
+}
+
+// ---------------
+// openFileInvalid
+// ---------------
+
+/**
+ * @brief Attempt to open a missing video file; nothing can be replayed.
+ *
+ * @return true, if test passed.
+ */
+int openFileInvalid () {
+	std::cerr << "**Running test openFileInvalid**" << std::endl;
+
+	InterfaceVideoFile videoFile;
+
+	bool retVal = !videoFile.openFile(".missing.avi");
+	retVal = retVal && !videoFile.isOpen();
+	retVal = retVal && (videoFile.readFrames(1) == 0);
+
+	std::vector<uint8_t> data;
+	videoFile.appendData(data);
+	retVal = retVal && data.empty();
+
+	if (!retVal) {
+		std::cerr << "!!Failed openFileInvalid test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return retVal;
+}
+
+// -------------
+// moveDataValid
+// -------------
+
+/**
+ * @brief Attempt to take over replayed bytes without a copy; the source
+ *        must be emptied.
+ *
+ * @return true, if test passed.
+ */
+int moveDataValid () {
+	std::cerr << "**Running test moveDataValid**" << std::endl;
+
+	InterfaceVideoFile videoFile;
+
+	bool retVal = videoFile.openFile(TEST_DIRECTORY);
+	retVal = retVal && (videoFile.readFrames(2) == 2);
+
+	std::vector<uint8_t> data;
+	videoFile.moveData(data);
+	size_t sum = std::accumulate(data.begin(), data.end(), size_t(0));
+	retVal = retVal && (sum > 0);
+
+	// Nothing is left to take over and the entropy estimate is reset.
+	std::vector<uint8_t> rest;
+	videoFile.moveData(rest);
+	std::vector<double> entropy = videoFile.bitEntropy();
+	double total = std::accumulate(entropy.begin(), entropy.end(), 0.0);
+	retVal = retVal && rest.empty() && (total == 0);
+
+	removeTestFrames();
+
+	if (!retVal) {
+		std::cerr << "!!Failed moveDataValid test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return retVal;
+}
+
+// ---------------
+// frameBytesValid
+// ---------------
+
+/**
+ * @brief Attempt to convert frames of 16bit and 8bit samples; all
+ *        channels are recorded low byte first and byte pairs are counted.
+ *
+ * @return true, if test passed.
+ */
+int frameBytesValid () {
+	std::cerr << "**Running test frameBytesValid**" << std::endl;
+
+	// 2x3 frame of 3 channel int16 samples.
+	std::vector<int16_t> wide(2 * 3 * 3);
+
+	for (size_t i = 0; i < wide.size(); ++i) {
+		wide[i] = static_cast<int16_t>(1000 * i - 7000);
+	}
+
+	cv::Mat wideFrame(2, 3, CV_16SC3, wide.data());
+	std::vector<uint8_t> data;
+	BitHistogram<uint16_t> histogram;
+
+	bool retVal = frameToBytes(wideFrame, data, histogram);
+	retVal = retVal && (data.size() == 2 * wide.size());
+	retVal = retVal && (histogram.samples() == wide.size());
+
+	for (size_t i = 0; retVal && i < wide.size(); ++i) {
+		uint16_t sample = static_cast<uint16_t>(wide[i]);
+		retVal = (data[2 * i] == (sample & 0xFF))
+			&& (data[2 * i + 1] == (sample >> 8));
+	}
+
+	// 3x3 frame of 8bit samples; the odd byte is recorded, not counted.
+	std::vector<uint8_t> narrow(3 * 3);
+
+	for (size_t i = 0; i < narrow.size(); ++i) {
+		narrow[i] = static_cast<uint8_t>(17 * i);
+	}
+
+	cv::Mat narrowFrame(3, 3, CV_8UC1, narrow.data());
+	data.clear();
+	histogram.reset();
+
+	retVal = retVal && frameToBytes(narrowFrame, data, histogram);
+	retVal = retVal && (data == narrow);
+	retVal = retVal && (histogram.samples() == narrow.size() / 2);
+
+	if (!retVal) {
+		std::cerr << "!!Failed frameBytesValid test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return retVal;
+}
+
+int main(){
+	/* Run tests and count passed.
+	 * Order matters.
+	 */
+	int passed = 0;
+	passed += replayDirectoryValid();
+	passed += rewindValid();
+	passed += noiseBitsResidualValid();
+	passed += mixedSizeValid();
+	passed += openFileInvalid();
+	passed += moveDataValid();
+	passed += frameBytesValid();
+
+
+	std::cerr << std::endl;
+	std::cerr << "--Passed " << passed << "/7" << " tests--" << std::endl;
+
+	// Assert passing all tests.
+	assert(passed == 7);
+
+	return 0;
+}
@@ -48,6 +48,17 @@ public:
         return false;
     };
 
+    // -------
+    // release
+    // -------
+
+    /**
+     * @brief Dummy function definition in the absence of camera access.
+     *
+     * @return void
+     */
+    inline void release() {};
+
     // ----------
     // appendData
     // ----------
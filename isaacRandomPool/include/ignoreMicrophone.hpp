@@ -63,6 +63,64 @@ public:
     };
 
 
+	// ------------
+	// setNoiseBits
+	// ------------
+
+	/**
+	 * @brief Dummy function definition in the absence of microphone access.
+	 *
+	 * @param ignore
+	 * @param ignore
+	 *
+	 * @return ignore
+	 */
+	inline bool setNoiseBits(unsigned ignore, bool ignore2 = false) {
+        return false;
+    };
+
+	// -----------
+	// openSession
+	// -----------
+
+	/**
+	 * @brief Dummy function definition in the absence of microphone access.
+	 *
+	 * @return ignore
+	 */
+	inline int openSession() {
+        return -1;
+    };
+
+	// ------------
+	// closeSession
+	// ------------
+
+	/**
+	 * @brief Dummy function definition in the absence of microphone access.
+	 *
+	 * @return ignore
+	 */
+	inline bool closeSession() {
+        return false;
+    };
+
+	// --------
+	// takeBits
+	// --------
+
+	/**
+	 * @brief Dummy function definition in the absence of microphone access.
+	 *
+	 * @param ignore
+	 * @param ignore
+	 *
+	 * @return ignore
+	 */
+	inline double takeBits(double ignore, std::vector<uint8_t>& ignore2) {
+        return 0;
+    };
+
     // ----------
     // appendData
     // ----------
@@ -37,6 +37,8 @@
 // standard includes
 // -----------------
 #include <iterator>
+#include <memory>
+#include <mutex>
 
 // --------------------
 // third party includes
@@ -48,6 +50,13 @@
 // library includes
 // ----------------
 #include "isaac.hpp"
+#include "randomSource.h"
+#include "entropyAccumulator.h"
+#include "seedBank.h"
+#include "seedGenerator.h"
+
+class InterfaceMicrophone;
+class InterfaceCamera;
 
 /**
  * @class IsaacRandomPool tasked with generating random bytes with evenly
@@ -67,21 +76,46 @@ public:
 	// Number of bytes from OS rng.
 	static const size_t NUM_OS_RANDOM_BYTES = 1024*1024*25;
 
+	// Number of bytes from CPU rng (RDSEED/RDRAND), if available.
+	static const size_t NUM_CPU_RANDOM_BYTES = 1024*1024*4;
+
+	// Number of bytes from timing jitter, if available.
+	static const size_t NUM_JITTER_BYTES = 1024*32;
+
 	// Sleep time in milliseconds for a microphone device to capture audio.
 	static const size_t NUM_MIC_SLEEP_MS = 1*1000;
 
-	// Seed for ISAAC generator (256 int32 terms).
-	static const size_t SEEDTERMS = 256;
-
 	// Alpha for ISAAC generator  (2^8 = 256)
 	static const size_t ALPHA = 8;
 
-	// Number of 512bit hashes required to generate seed terms.
+	// Seed for ISAAC generator (2^ALPHA int32 terms).
+	static const size_t SEEDTERMS = size_t(1) << ALPHA;
+
+	// Number of splits the entropy estimate of gathered data is checked over.
 	static const size_t ENTROPYSPLIT = 16;
 
 	// Number of random bytes to burn.
 	static const size_t BURN = 512;
 
+	// Interval in milliseconds between background entropy harvests.
+	static const size_t ACCUMULATOR_INTERVAL_MS = 100;
+
+	// Number of bytes from OS rng per background harvest.
+	static const size_t ACCUMULATOR_OS_BYTES = 64;
+
+	// Number of harvest intervals between background camera captures.
+	static const size_t ACCUMULATOR_DEVICE_PERIOD = 600;
+
+	// Number of harvest intervals between background microphone harvests
+	// from the persistent audio session.
+	static const size_t ACCUMULATOR_MIC_PERIOD = 10;
+
+	// Credited bits of audio condensed per background microphone harvest.
+	static const size_t ACCUMULATOR_MIC_BITS = 512;
+
+	// Low order bits kept per sample by the persistent audio session.
+	static const size_t ACCUMULATOR_MIC_NOISE_BITS = 4;
+
 	// ------
 	// STATUS
 	// ------
@@ -95,6 +129,16 @@ public:
 		RNG_INIT_ERROR = -4		// RNG not initialized.
 	};
 
+	// -----------
+	// Constructor
+	// -----------
+
+	/**
+	 * Constructor
+	 * @brief Creates IsaacRandomPool object with an uninitialized generator.
+	 */
+	IsaacRandomPool();
+
 	// -------------
 	// GenerateBlock
 	// -------------
@@ -120,9 +164,9 @@ public:
 	 *
 	 * @return A string with values "WEAK", "MEDIUM" or "STRONG". If the only
 	 *		   source of entropy is the OS this makes the module's strength
-	 *		   WEAK w.r.t entropy, access to either the microphone or camera
-	 *		   results in Medium strength and finally access to the OS, camera,
-	 *		   microphone and more enables STRONG strength.
+	 *		   WEAK w.r.t entropy, access to one of the microphone, camera,
+	 *		   CPU rng or timing jitter results in Medium strength and finally
+	 *		   access to the OS and two or more of them enables STRONG strength.
 	 */
 	std::string EntropyStrength();
 
@@ -173,6 +217,36 @@ public:
 		std::vector<uint8_t> key = std::vector<uint8_t>()
 	);
 
+	// ----------------
+	// InitializeShards
+	// ----------------
+
+	/**
+	 * @brief Initializes several ISAAC generators from a single entropy
+	 *        mining pass; each generator is seeded with a domain-separated
+	 *        seed derived from the same conditioned pool.
+	 *
+	 * @param shards const reference to a vector of IsaacRandomPool pointers
+	 *        to be initialized.
+	 * @param files const reference to a vector of strings with the file name
+	 *        (with path) for the state of each shard.
+	 * @param multiplier size_t value increasing entropy mining params as an
+	 *        exponent of 2.
+	 * @param key vector of uint8_t containing encryption key (AES-GCM) of
+	 *        valid length, shared by all shards.
+	 *        Empty by default: does not encrypt state data on saving to disk.
+	 *
+	 * @throw runtime_error if entropy source fails to be accessed.
+	 *
+	 * @return true, if all shards were seeded and initialized successfully.
+	 */
+	static bool InitializeShards(
+		const std::vector<IsaacRandomPool*>& shards,
+		const std::vector<std::string>& files,
+		size_t multiplier = 0,
+		std::vector<uint8_t> key = std::vector<uint8_t>()
+	);
+
 	// --------------------
 	// InitializeEncryption
 	// --------------------
@@ -210,7 +284,141 @@ public:
 	 */
 	void Destroy();
 
+	// -----------------
+	// LastEntropyReport
+	// -----------------
+
+	/**
+	 * @brief Returns per-source statistics of the entropy mined by the last
+	 *        Initialize. A seed taken from the seed bank is reported as a
+	 *        single "bank" source with the record size and no credited
+	 *        bits; its entropy was credited when the bank was filled.
+	 *
+	 * @return SeedGenerator::EntropyReport with bytes absorbed, credited
+	 *         min-entropy, estimator timings and split results per source.
+	 */
+	SeedGenerator::EntropyReport LastEntropyReport();
+
+	// -----------
+	// SetSeedBank
+	// -----------
+
+	/**
+	 * @brief Associates an encrypted seed bank with the generator. Initialize
+	 *        consumes a banked seed record before falling back to mining.
+	 *
+	 * @param directory const reference to a string with the bank directory.
+	 * @param key const reference to a vector of uint8_t with the bank
+	 *        encryption key (AES-GCM) of valid length.
+	 *
+	 * @return void
+	 */
+	void SetSeedBank(
+		const std::string& directory,
+		const std::vector<uint8_t>& key
+	);
+
+	// ------------
+	// FillSeedBank
+	// ------------
+
+	/**
+	 * @brief Mines entropy and deposits conditioned seed records into the
+	 *        seed bank. Intended for idle periods, e.g. on a worker thread.
+	 *        Each record is mined from its own capture unless sharedCapture
+	 *        is set.
+	 *
+	 * @param numRecords size_t with number of records to deposit.
+	 * @param multiplier size_t value increasing entropy mining params as an
+	 *        exponent of 2.
+	 * @param sharedCapture bool deriving all records of the call from one
+	 *        capture (see copySeeds); faster, but the records then share a
+	 *        single pool of entropy and a compromise of it exposes them all.
+	 *
+	 * @throw runtime_error if entropy source fails to be accessed.
+	 *
+	 * @return size_t with number of records deposited.
+	 */
+	size_t FillSeedBank(
+		size_t numRecords,
+		size_t multiplier = 0,
+		bool sharedCapture = false
+	);
+
+	// ----------------
+	// StartAccumulator
+	// ----------------
+
+	/**
+	 * @brief Starts harvesting entropy in the background from the OS and
+	 *        available camera/microphone into a multi-pool accumulator.
+	 *
+	 * @return true, if background harvesting was started.
+	 */
+	bool StartAccumulator();
+
+	// ---------------
+	// StopAccumulator
+	// ---------------
+
+	/**
+	 * @brief Stops background entropy harvesting and releases the microphone
+	 *        held by the audio session.
+	 *
+	 * @return void
+	 */
+	void StopAccumulator();
+
+	// ------
+	// Reseed
+	// ------
+
+	/**
+	 * @brief Reseeds an initialized ISAAC generator from the accumulator,
+	 *        mixed with its current output, without a new entropy capture.
+	 *
+	 * @return true, if the generator was reseeded; false if uninitialized or
+	 *         the accumulator has not gathered enough entropy.
+	 */
+	bool Reseed();
+
 private:
+
+	// ---------------
+	// CondenseSource
+	// ---------------
+
+	/**
+	 * @brief Condenses data from a RandomSource into a small event if its
+	 *        entropy estimate meets SeedGenerator::ENTROPYTHRESHOLD.
+	 *
+	 * @param randomSource reference to a RandomSource with captured data.
+	 * @param data reference to a byte vector to be appended with the event.
+	 *
+	 * @return true, if an event was appended.
+	 */
+	static bool CondenseSource(
+		RandomSource& randomSource,
+		std::vector<uint8_t>& data
+	);
+
+	// -------------
+	// CondenseBytes
+	// -------------
+
+	/**
+	 * @brief Condenses bytes into a single accumulator event.
+	 *
+	 * @param randomData const reference to a byte vector to be condensed.
+	 * @param data reference to a byte vector to be appended with the event.
+	 *
+	 * @return void
+	 */
+	static void CondenseBytes(
+		const std::vector<uint8_t>& randomData,
+		std::vector<uint8_t>& data
+	);
+
 	// ------------
 	// int32toBytes
 	// ------------
@@ -228,26 +436,95 @@ private:
 	template <typename II, typename OI>
 	void int32toBytes(II begin, II end, OI out);
 
+	// -------------
+	// GatherEntropy
+	// -------------
+
+	/**
+	 * @brief Interacts with entropic sources to collect random bytes into a
+	 *        SeedGenerator.
+	 *
+	 * @param mulriplier int value increasing entropy mining params as an
+	 *        exponent of 2.
+	 * @param seedGenerator reference to a SeedGenerator to be loaded with
+	 *        data.
+	 *
+	 * @return true, if entropy minning was successfull.
+	 */
+	bool GatherEntropy(int multiplier, SeedGenerator& seedGenerator);
+
+	// ---------
+	// SeedISAAC
+	// ---------
+
+	/**
+	 * @brief Seeds ISAAC generator and burns initial output.
+	 *
+	 * @param seed pointer to SEEDTERMS uint32 seed terms.
+	 *
+	 * @return void
+	 */
+	void SeedISAAC(uint32_t* seed);
+
+	// ------------
+	// SeedFromBank
+	// ------------
+
+	/**
+	 * @brief Seeds ISAAC generator with a record withdrawn from the seed bank;
+	 *        the entropy report then holds a single "bank" source crediting
+	 *        no bits.
+	 *
+	 * @return true, if a valid record was consumed.
+	 */
+	bool SeedFromBank();
+
+	// ---------------------
+	// ReleaseHarvestDevices
+	// ---------------------
+
+	/**
+	 * @brief Releases the camera and closes the microphone session held open
+	 *        by the accumulator harvesters; the next harvest opens them again.
+	 *        Caller must hold _deviceMutex.
+	 *
+	 * @return void
+	 */
+	void ReleaseHarvestDevices();
+
 	// --------------------
 	// GatherEntropyAndSeed
 	// --------------------
 
 	/**
 	 * @brief Interacts with entropic sources to collect random bytes to seed
-	 *        ISAAC generator.
+	 *        ISAAC generators of the given pools; seed i is derived with
+	 *        index i from the same conditioned pool.
 	 *
 	 * @param mulriplier int value increasing entropy mining params as an
 	 *        exponent of 2.
+	 * @param pools const reference to a vector of IsaacRandomPool pointers
+	 *        to be seeded.
 	 *
 	 * @return true, if entropy minning was successfull (causally seeding).
 	 */
-	bool GatherEntropyAndSeed(int multiplier);
+	static bool GatherEntropyAndSeed(
+		int multiplier,
+		const std::vector<IsaacRandomPool*>& pools
+	);
 
 	// ----
 	// data
 	// ----
 
 	QTIsaac<IsaacRandomPool::ALPHA, uint32_t> _isaacrng;
+	EntropyAccumulator _accumulator; // Background multi-pool accumulator.
+	bool _harvestersAdded; // Status of accumulator source registration.
+	std::shared_ptr<InterfaceMicrophone> _audioSession; // Persistent mic.
+	std::shared_ptr<InterfaceCamera> _harvestCamera; // Persistent camera.
+	std::shared_ptr<std::mutex> _deviceMutex; // Guards camera and mic use.
+	std::unique_ptr<SeedBank> _seedBank; // Optional persisted seed bank.
+	SeedGenerator::EntropyReport _entropyReport; // Stats of last mined seed.
 
 };
 
@@ -0,0 +1,147 @@
+/** @file seedBank.h
+ *  @brief Class header tasked with persisting conditioned seed records to
+ *         an encrypted on-disk bank. Records are written through FileCryptopp
+ *         and consumed at most once (delete-on-read).
+ *
+ *  @author Aashish Sheshadri
+ *  @author Rohit Harchandani
+ *
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2015, 2016, 2017 PayPal
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SEEDBANK_H
+#define SEEDBANK_H
+
+// -----------------
+// standard includes
+// -----------------
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/**
+ * @class SeedBank tasked with depositing and withdrawing encrypted seed
+ *        records in a bank directory. Each record is a separate file; a
+ *        withdrawal claims a record by atomically renaming it so that
+ *        concurrent processes never consume the same record.
+ */
+class SeedBank {
+public:
+
+	// ---------
+	// constants
+	// ---------
+
+	// Extension of record files available for withdrawal.
+	static const std::string RECORD_EXTENSION;
+
+	// Bytes of randomness in record names.
+	static const size_t RECORD_NAME_BYTES = 16;
+
+	// -----------
+	// Constructor
+	// -----------
+
+	/**
+	 * Constructor
+	 * @brief Creates SeedBank object associated with a bank directory.
+	 *
+	 * @param directory const reference to a string with the bank directory;
+	 *        created if it does not exist.
+	 * @param key const reference to a byte vector with the bank encryption
+	 *        key (AES-GCM key length); records are never stored in clear.
+	 */
+	SeedBank(const std::string& directory, const std::vector<uint8_t>& key);
+
+	// -------
+	// deposit
+	// -------
+
+	/**
+	 * @brief Encrypts and writes a seed record to the bank.
+	 *
+	 * @param record const reference to a byte vector with the seed record.
+	 *
+	 * @return true, if the record was deposited.
+	 */
+	bool deposit(const std::vector<uint8_t>& record);
+
+	// --------
+	// withdraw
+	// --------
+
+	/**
+	 * @brief Claims, decrypts and deletes one seed record from the bank.
+	 *
+	 * @param record reference to a byte vector to hold the seed record.
+	 *
+	 * @return true, if a record was withdrawn; false if the bank is empty.
+	 */
+	bool withdraw(std::vector<uint8_t>& record);
+
+	// ----
+	// size
+	// ----
+
+	/**
+	 * @brief Counts records available for withdrawal.
+	 *
+	 * @return size_t with number of records in the bank.
+	 */
+	size_t size();
+
+private:
+
+	// ---------
+	// recordKey
+	// ---------
+
+	/**
+	 * @brief Derives the encryption key of a record from the bank key and
+	 *        the record name, so that no two records share a key.
+	 *
+	 * @param name const reference to a string with the record name.
+	 *
+	 * @return byte vector with the record key.
+	 */
+	std::vector<uint8_t> recordKey(const std::string& name);
+
+	// -----------
+	// listRecords
+	// -----------
+
+	/**
+	 * @brief Lists names of records available for withdrawal.
+	 *
+	 * @return vector of strings with record names (without extension).
+	 */
+	std::vector<std::string> listRecords();
+
+	// ----
+	// data
+	// ----
+	std::string _directory; // Bank directory.
+	std::vector<uint8_t> _key; // Bank encryption key.
+};
+
+#endif
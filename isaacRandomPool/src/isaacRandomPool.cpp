@@ -31,7 +31,11 @@
 // standard includes
 // -----------------
 #include <iostream>
+#include <algorithm>
 #include <cmath>
+#include <memory>
+#include <mutex>
+#include <numeric>
 
 // --------------------
 // third party includes
@@ -44,6 +48,9 @@
 #include "isaacRandomPool.h"
 #include "seedGenerator.h"
 #include "interfaceOSRNG.h"
+#include "interfaceCPURNG.h"
+#include "interfaceJitter.h"
+#include "interfaceSnapshot.h"
 
 #ifndef WITH_OPENCV
 	#define WITH_OPENCV 0
@@ -61,6 +68,20 @@
 
 
 
+// -----------
+// Constructor
+// -----------
+
+/**
+ * Constructor
+ * @brief Creates IsaacRandomPool object with an uninitialized generator.
+ */
+IsaacRandomPool::IsaacRandomPool():
+	_harvestersAdded(false),
+	_deviceMutex(std::make_shared<std::mutex>()) {
+
+}
+
 // -------------
 // GenerateBlock
 // -------------
@@ -150,16 +171,27 @@ void IsaacRandomPool::GenerateBlock(byte *output, size_t size) {
  *
  * @return A string with values "WEAK", "MEDIUM" or "STRONG". If the only
  *		   source of entropy is the OS this makes the module's strength
- *		   WEAK w.r.t entropy, access to either the microphone or camera
- *		   results in Medium strength and finally access to the OS, camera,
- *		   microphone and more enables STRONG strength.
+ *		   WEAK w.r.t entropy, access to one of the microphone, camera,
+ *		   CPU rng or timing jitter results in Medium strength and finally
+ *		   access to the OS and two or more of them enables STRONG strength.
  */
 std::string IsaacRandomPool::EntropyStrength() {
-	if (WITH_OPENCV && WITH_PORTAUDIO) {
+	// Count sources available in addition to the OS.
+	int numSources = WITH_OPENCV + WITH_PORTAUDIO;
+
+	if (InterfaceCPURNG().available()) {
+		numSources = numSources + 1;
+	}
+
+	if (InterfaceJitter().available()) {
+		numSources = numSources + 1;
+	}
+
+	if (numSources >= 2) {
 		return "STRONG";
 	}
 
-	if (WITH_OPENCV || WITH_PORTAUDIO) {
+	if (numSources == 1) {
 		return "MEDIUM";
 	}
 
@@ -250,10 +282,21 @@ bool IsaacRandomPool::Initialize(
 	// set decryption key
 	_isaacrng.setKey(key);
 
+	// Discard statistics of a previous seed.
+	_entropyReport = SeedGenerator::EntropyReport();
+
+	// Consume a banked seed if available, mining entropy only if none is.
+	if (SeedFromBank()) {
+		return true;
+	}
+
 	// gather entropy and seed to initialize ISAAC generator.
 	bool result;
 	try {
-		result = GatherEntropyAndSeed(multiplier);
+		result = GatherEntropyAndSeed(
+			multiplier,
+			std::vector<IsaacRandomPool*>(1, this)
+		);
 	} catch (std::runtime_error& e) {
 		throw e;
 	}
@@ -262,6 +305,59 @@ bool IsaacRandomPool::Initialize(
 
 }
 
+// ----------------
+// InitializeShards
+// ----------------
+
+/**
+ * @brief Initializes several ISAAC generators from a single entropy
+ *        mining pass; each generator is seeded with a domain-separated
+ *        seed derived from the same conditioned pool.
+ *
+ * @param shards const reference to a vector of IsaacRandomPool pointers
+ *        to be initialized.
+ * @param files const reference to a vector of strings with the file name
+ *        (with path) for the state of each shard.
+ * @param multiplier size_t value increasing entropy mining params as an
+ *        exponent of 2.
+ * @param key vector of uint8_t containing encryption key (AES-GCM) of
+ *        valid length, shared by all shards.
+ *        Empty by default: does not encrypt state data on saving to disk.
+ *
+ * @throw runtime_error if entropy source fails to be accessed.
+ *
+ * @return true, if all shards were seeded and initialized successfully.
+ */
+bool IsaacRandomPool::InitializeShards(
+	const std::vector<IsaacRandomPool*>& shards,
+	const std::vector<std::string>& files,
+	size_t multiplier,
+	std::vector<uint8_t> key
+) {
+
+	if (shards.empty() || shards.size() != files.size()) {
+		return false;
+	}
+
+	// Prepare each shard for re-initialization, as in Initialize.
+	for (size_t i = 0; i < shards.size(); ++i) {
+		shards[i]->_isaacrng.destroy();
+		shards[i]->_isaacrng.setIdentifier(files[i]);
+		shards[i]->_isaacrng.setKey(key);
+		shards[i]->_entropyReport = SeedGenerator::EntropyReport();
+	}
+
+	// gather entropy once and seed every shard's ISAAC generator.
+	bool result;
+	try {
+		result = GatherEntropyAndSeed(multiplier, shards);
+	} catch (std::runtime_error& e) {
+		throw e;
+	}
+
+	return result;
+}
+
 // --------------------
 // InitializeEncryption
 // --------------------
@@ -316,33 +412,644 @@ void IsaacRandomPool::Destroy() {
 	_isaacrng.destroy();
 }
 
+// -----------------
+// LastEntropyReport
+// -----------------
+
+/**
+ * @brief Returns per-source statistics of the entropy mined by the last
+ *        Initialize. A seed taken from the seed bank is reported as a
+ *        single "bank" source with the record size and no credited
+ *        bits; its entropy was credited when the bank was filled.
+ *
+ * @return SeedGenerator::EntropyReport with bytes absorbed, credited
+ *         min-entropy, estimator timings and split results per source.
+ */
+SeedGenerator::EntropyReport IsaacRandomPool::LastEntropyReport() {
+	return _entropyReport;
+}
+
+// -----------
+// SetSeedBank
+// -----------
+
+/**
+ * @brief Associates an encrypted seed bank with the generator. Initialize
+ *        consumes a banked seed record before falling back to mining.
+ *
+ * @param directory const reference to a string with the bank directory.
+ * @param key const reference to a vector of uint8_t with the bank
+ *        encryption key (AES-GCM) of valid length.
+ *
+ * @return void
+ */
+void IsaacRandomPool::SetSeedBank(
+	const std::string& directory,
+	const std::vector<uint8_t>& key
+) {
+	_seedBank.reset(new SeedBank(directory, key));
+}
+
+// ------------
+// FillSeedBank
+// ------------
+
+/**
+ * @brief Mines entropy and deposits conditioned seed records into the
+ *        seed bank. Intended for idle periods, e.g. on a worker thread.
+ *        Each record is mined from its own capture unless sharedCapture
+ *        is set.
+ *
+ * @param numRecords size_t with number of records to deposit.
+ * @param multiplier size_t value increasing entropy mining params as an
+ *        exponent of 2.
+ * @param sharedCapture bool deriving all records of the call from one
+ *        capture (see copySeeds); faster, but the records then share a
+ *        single pool of entropy and a compromise of it exposes them all.
+ *
+ * @throw runtime_error if entropy source fails to be accessed.
+ *
+ * @return size_t with number of records deposited.
+ */
+size_t IsaacRandomPool::FillSeedBank(
+	size_t numRecords,
+	size_t multiplier,
+	bool sharedCapture
+) {
+	size_t deposited = 0;
+
+	if (!_seedBank) {
+		return deposited;
+	}
+
+	// Each record holds SEEDTERMS int32 terms as bytes.
+	const size_t recordSize = IsaacRandomPool::SEEDTERMS * 4;
+
+	// Records derived from the current capture and not yet deposited.
+	std::vector<uint8_t> records;
+	size_t next = 0;
+
+	while (deposited < numRecords) {
+		if (next == records.size()) {
+			SeedGenerator seedGenerator(
+				IsaacRandomPool::ENTROPYSPLIT,
+				SeedGenerator::MODE::XOF
+			);
+
+			if (!GatherEntropy(multiplier, seedGenerator)) {
+				break; // Not enough entropy.
+			}
+
+			// One record per capture, or all remaining from this one.
+			size_t count = sharedCapture ? numRecords - deposited : 1;
+
+			records.assign(count * recordSize, 0);
+			seedGenerator.generateSeed();
+			seedGenerator.copySeeds(records.data(), recordSize, count);
+			next = 0;
+		}
+
+		std::vector<uint8_t> record(
+			records.begin() + next,
+			records.begin() + next + recordSize
+		);
+		next = next + recordSize;
+
+		bool stored = _seedBank->deposit(record);
+
+		// Wipe record from memory.
+		std::fill(record.begin(), record.end(), 0);
+
+		if (!stored) {
+			break;
+		}
+
+		++deposited;
+	}
+
+	// Wipe records from memory.
+	std::fill(records.begin(), records.end(), 0);
+
+	return deposited;
+}
+
+// ----------------
+// StartAccumulator
+// ----------------
+
+/**
+ * @brief Starts harvesting entropy in the background from the OS and
+ *        available camera/microphone into a multi-pool accumulator.
+ *
+ * @return true, if background harvesting was started.
+ */
+bool IsaacRandomPool::StartAccumulator() {
+
+	// Register sources once; they are kept alive by their harvesters.
+	if (!_harvestersAdded) {
+
+		// OS random bytes are cheap and harvested every interval.
+		auto interfaceOSRNG = std::make_shared<InterfaceOSRNG>();
+
+		_accumulator.addHarvester(
+			[interfaceOSRNG] (std::vector<uint8_t>& data) {
+				if (!interfaceOSRNG->generateRandomBytes(
+					IsaacRandomPool::ACCUMULATOR_OS_BYTES
+				)) {
+					return false;
+				}
+
+				interfaceOSRNG->moveData(data);
+				return true;
+			}
+		);
+
+		/* Device harvests skip while Initialize holds the devices; both
+		 * share _deviceMutex, as neither device may be opened twice.
+		 */
+		std::shared_ptr<std::mutex> deviceMutex = _deviceMutex;
+
+		/* Camera captures are condensed and harvested infrequently; the
+		 * camera is kept open across harvests.
+		 */
+		if (WITH_OPENCV == 1) {
+			_harvestCamera = std::make_shared<InterfaceCamera>();
+
+			std::shared_ptr<InterfaceCamera> harvestCamera = _harvestCamera;
+
+			_accumulator.addHarvester(
+				[harvestCamera, deviceMutex] (std::vector<uint8_t>& data) {
+					std::unique_lock<std::mutex> lock(
+						*deviceMutex,
+						std::try_to_lock
+					);
+
+					if (!lock.owns_lock()) {
+						return false; // Camera in use by Initialize.
+					}
+
+					if (!harvestCamera->captureFrames(1)) {
+						return false;
+					}
+
+					if (IsaacRandomPool::CondenseSource(*harvestCamera, data)) {
+						return true;
+					}
+
+					// Drop rejected frames so later harvests start afresh.
+					std::vector<uint8_t> rejected;
+					harvestCamera->moveData(rejected);
+					std::fill(rejected.begin(), rejected.end(), 0);
+
+					return false;
+				},
+				IsaacRandomPool::ACCUMULATOR_DEVICE_PERIOD
+			);
+		}
+
+		/* Microphone audio is recorded by a session kept open across
+		 * harvests, so device setup is paid once; each harvest condenses
+		 * audio credited with ACCUMULATOR_MIC_BITS.
+		 */
+		if (WITH_PORTAUDIO == 1) {
+			_audioSession = std::make_shared<InterfaceMicrophone>();
+			_audioSession->setNoiseBits(
+				IsaacRandomPool::ACCUMULATOR_MIC_NOISE_BITS
+			);
+
+			std::shared_ptr<InterfaceMicrophone> audioSession = _audioSession;
+
+			_accumulator.addHarvester(
+				[audioSession, deviceMutex] (std::vector<uint8_t>& data) {
+					std::unique_lock<std::mutex> lock(
+						*deviceMutex,
+						std::try_to_lock
+					);
+
+					if (!lock.owns_lock()) {
+						return false; // Microphone in use by Initialize.
+					}
+
+					// Open session once, or again after it was closed.
+					if (audioSession->openSession() == -1) {
+						return false;
+					}
+
+					std::vector<uint8_t> audioData;
+
+					if (audioSession->takeBits(
+						IsaacRandomPool::ACCUMULATOR_MIC_BITS,
+						audioData
+					) == 0) {
+						return false; // Not enough audio credited yet.
+					}
+
+					IsaacRandomPool::CondenseBytes(audioData, data);
+
+					// Wipe audio from memory.
+					std::fill(audioData.begin(), audioData.end(), 0);
+
+					return true;
+				},
+				IsaacRandomPool::ACCUMULATOR_MIC_PERIOD
+			);
+		}
+
+		_harvestersAdded = true;
+	}
+
+	return _accumulator.start(
+		std::chrono::milliseconds(
+			static_cast<long>(IsaacRandomPool::ACCUMULATOR_INTERVAL_MS)
+		)
+	);
+}
+
+// ---------------
+// StopAccumulator
+// ---------------
+
+/**
+ * @brief Stops background entropy harvesting and releases the microphone
+ *        held by the audio session.
+ *
+ * @return void
+ */
+void IsaacRandomPool::StopAccumulator() {
+	_accumulator.stop();
+
+	// Release the devices held by the harvesters.
+	std::lock_guard<std::mutex> lock(*_deviceMutex);
+	ReleaseHarvestDevices();
+}
+
+// ---------------------
+// ReleaseHarvestDevices
+// ---------------------
+
+/**
+ * @brief Releases the camera and closes the microphone session held open
+ *        by the accumulator harvesters; the next harvest opens them again.
+ *        Caller must hold _deviceMutex.
+ *
+ * @return void
+ */
+void IsaacRandomPool::ReleaseHarvestDevices() {
+	if (_harvestCamera) {
+		_harvestCamera->release();
+	}
+
+	if (_audioSession) {
+		_audioSession->closeSession();
+	}
+}
+
+// ------
+// Reseed
+// ------
+
+/**
+ * @brief Reseeds an initialized ISAAC generator from the accumulator,
+ *        mixed with its current output, without a new entropy capture.
+ *
+ * @return true, if the generator was reseeded; false if uninitialized or
+ *         the accumulator has not gathered enough entropy.
+ */
+bool IsaacRandomPool::Reseed() {
+	if (!_isaacrng.initialized()) {
+		return false;
+	}
+
+	uint32_t seed[IsaacRandomPool::SEEDTERMS];
+
+	// Draw seed from accumulated pools.
+	if (!_accumulator.copySeed(seed, IsaacRandomPool::SEEDTERMS)) {
+		return false;
+	}
+
+	// Mix in current generator output so that reseeding never loses state.
+	for (size_t i = 0; i < IsaacRandomPool::SEEDTERMS; ++i) {
+		seed[i] ^= _isaacrng.rand();
+	}
+
+	SeedISAAC(seed);
+
+	// Wipe seed from memory.
+	std::fill(seed, seed + IsaacRandomPool::SEEDTERMS, 0);
+
+	return true;
+}
+
+// ------------
+// SeedFromBank
+// ------------
+
+/**
+ * @brief Seeds ISAAC generator with a record withdrawn from the seed bank;
+ *        the entropy report then holds a single "bank" source crediting
+ *        no bits.
+ *
+ * @return true, if a valid record was consumed.
+ */
+bool IsaacRandomPool::SeedFromBank() {
+
+	if (!_seedBank) {
+		return false;
+	}
+
+	std::vector<uint8_t> record;
+
+	// Withdraw until a record of the expected size is found.
+	while (_seedBank->withdraw(record)) {
+		if (record.size() != IsaacRandomPool::SEEDTERMS * 4) {
+			continue; // Record deposited for a different ALPHA.
+		}
+
+		uint32_t seed[IsaacRandomPool::SEEDTERMS];
+
+		// Group record bytes into int32 seed terms.
+		for (size_t i = 0; i < IsaacRandomPool::SEEDTERMS; ++i) {
+			seed[i] = 0;
+
+			for (size_t j = 0; j < 4; ++j) {
+				seed[i] = (seed[i] << 8) + record[4 * i + j];
+			}
+		}
+
+		size_t recordBytes = record.size();
+
+		// Wipe record from memory.
+		std::fill(record.begin(), record.end(), 0);
+
+		SeedISAAC(seed);
+
+		// Wipe seed from memory.
+		std::fill(seed, seed + IsaacRandomPool::SEEDTERMS, 0);
+
+		/* Mark the seed as banked; its entropy was credited when the bank
+		 * was filled, so the record itself carries no credit.
+		 */
+		SeedGenerator::SourceReport bank;
+		bank.label = "bank";
+		bank.accepted = true;
+		bank.bytesAbsorbed = recordBytes;
+		bank.bitProbability = 0.0;
+		bank.bitMinEntropy = 0.0;
+		bank.byteMinEntropy = 0.0;
+		bank.creditedBits = 0.0;
+		bank.estimatorSeconds = 0.0;
+
+		_entropyReport.sources.push_back(bank);
+		_entropyReport.bytesAbsorbed = recordBytes;
+
+		return true;
+	}
+
+	return false;
+}
+
+// --------------
+// CondenseSource
+// --------------
+
+/**
+ * @brief Condenses data from a RandomSource into a small event if its
+ *        entropy estimate meets SeedGenerator::ENTROPYTHRESHOLD.
+ *
+ * @param randomSource reference to a RandomSource with captured data.
+ * @param data reference to a byte vector to be appended with the event.
+ *
+ * @return true, if an event was appended.
+ */
+bool IsaacRandomPool::CondenseSource(
+	RandomSource& randomSource,
+	std::vector<uint8_t>& data
+) {
+	// Compute avg. bit occurrence in a sample from randomSource.
+	std::vector<double> sampleAvgVec = randomSource.bitEntropy();
+
+	if (sampleAvgVec.empty()) {
+		return false;
+	}
+
+	double sum = std::accumulate(sampleAvgVec.begin(),sampleAvgVec.end(),0.0f);
+
+	if (sum / sampleAvgVec.size() < SeedGenerator::ENTROPYTHRESHOLD) {
+		return false; // Data not good enough.
+	}
+
+	std::vector<uint8_t> randomData;
+	randomSource.moveData(randomData);
+
+	CondenseBytes(randomData, data);
+
+	return true;
+}
+
+// -------------
+// CondenseBytes
+// -------------
+
+/**
+ * @brief Condenses bytes into a single accumulator event.
+ *
+ * @param randomData const reference to a byte vector to be condensed.
+ * @param data reference to a byte vector to be appended with the event.
+ *
+ * @return void
+ */
+void IsaacRandomPool::CondenseBytes(
+	const std::vector<uint8_t>& randomData,
+	std::vector<uint8_t>& data
+) {
+	// Hash captured data down to a single accumulator event.
+	Shake256 condenser;
+	condenser.Update(randomData.data(), randomData.size());
+
+	data.resize(data.size() + EntropyAccumulator::MAXEVENTSIZE);
+	condenser.Squeeze(
+		data.data() + data.size() - EntropyAccumulator::MAXEVENTSIZE,
+		EntropyAccumulator::MAXEVENTSIZE
+	);
+}
+
 // --------------------
 // GatherEntropyAndSeed
 // --------------------
 
 /**
  * @brief Interacts with entropic sources to collect random bytes to seed
- *        ISAAC generator.
+ *        ISAAC generators of the given pools; seed i is derived with
+ *        index i from the same conditioned pool.
  *
  * @param mulriplier int value increasing entropy mining params as an
  *        exponent of 2.
+ * @param pools const reference to a vector of IsaacRandomPool pointers
+ *        to be seeded.
  *
  * @throw runtime_error if entropy source fails to be accessed.
  *
  * @return true, if entropy minning was successfull (causally seeding).
  */
-bool IsaacRandomPool::GatherEntropyAndSeed(int multiplier) {
+bool IsaacRandomPool::GatherEntropyAndSeed(
+	int multiplier,
+	const std::vector<IsaacRandomPool*>& pools
+) {
+
+	if (pools.empty()) {
+		return false;
+	}
+
+	/* Setup SeedGenerator to generate seeds of length SEEDTERMS.
+	 * Data collected is absorbed into a single SHAKE256 state; each seed is
+	 * squeezed from a copy of that state keyed with the pool's index. The
+	 * entropy estimate is checked over ENTROPYSPLIT splits of the data.
+	 */
+	SeedGenerator seedGenerator(
+		IsaacRandomPool::ENTROPYSPLIT,
+		SeedGenerator::MODE::XOF
+	);
+
+	bool result = pools[0]->GatherEntropy(multiplier, seedGenerator);
+
+	// Generate seed, recording source statistics even if mining failed.
+	SeedGenerator::EntropyReport report = seedGenerator.generateSeed();
+	for (auto it = pools.begin(); it != pools.end(); ++it) {
+		(*it)->_entropyReport = report;
+	}
+
+	if (!result) {
+		// Not enough entropy.
+		return false;
+	}
+
+	std::vector<uint32_t> seeds(pools.size() * IsaacRandomPool::SEEDTERMS);
+
+	// Copy seeds from random bytes loaded to seedGenerator.
+	seedGenerator.copySeeds(
+		seeds.data(),
+		IsaacRandomPool::SEEDTERMS,
+		pools.size()
+	);
+
+	for (size_t i = 0; i < pools.size(); ++i) {
+		pools[i]->SeedISAAC(&seeds[i * IsaacRandomPool::SEEDTERMS]);
+	}
+
+	// Wipe seeds from memory.
+	std::fill(seeds.begin(), seeds.end(), 0);
+
+	return true;
+}
+
+// ---------
+// SeedISAAC
+// ---------
+
+/**
+ * @brief Seeds ISAAC generator and burns initial output.
+ *
+ * @param seed pointer to SEEDTERMS uint32 seed terms.
+ *
+ * @return void
+ */
+void IsaacRandomPool::SeedISAAC(uint32_t* seed) {
+
+	// Seed ISSAC generator with a, b, c internal paramters set to 0.
+	_isaacrng.srand(0,0,0,seed);
+
+	// Generate BURN random bytes to put ISAAC generator in a stable state.
+	for (int i = 0; i < IsaacRandomPool::BURN; ++i) {
+		_isaacrng.rand();
+	}
+}
+
+// -------------
+// GatherEntropy
+// -------------
+
+/**
+ * @brief Interacts with entropic sources to collect random bytes into a
+ *        SeedGenerator.
+ *
+ * @param mulriplier int value increasing entropy mining params as an
+ *        exponent of 2.
+ * @param seedGenerator reference to a SeedGenerator to be loaded with data.
+ *
+ * @throw runtime_error if entropy source fails to be accessed.
+ *
+ * @return true, if entropy minning was successfull.
+ */
+bool IsaacRandomPool::GatherEntropy(
+	int multiplier,
+	SeedGenerator& seedGenerator
+) {
 
 	bool status;
 	bool result;
 
-	/* Setup SeedGenerator to generate a seed of length SEEDTERMS.
-	 * Paramter to the constructor determintes number of splits to data
-	 * collected to generate independent hashes to fill SEEDTERMS i.e.
-	 * 2 splits => 2 hashes of 512 bytes => 32, 32bit terms or 64, 16bit terms
-	 * and so on.
+	/* Mix a snapshot of volatile process and system state first; it costs
+	 * well under a millisecond and is credited conservatively.
+	 */
+	InterfaceSnapshot interfaceSnapshot;
+
+	if (interfaceSnapshot.captureSnapshot()) {
+		seedGenerator.mixFromSource(
+			&interfaceSnapshot,
+			InterfaceSnapshot::SNAPSHOT_CREDIT_BITS,
+			"snapshot"
+		);
+	}
+
+	/* Capture from the CPU rng and from timing jitter if available; each is
+	 * cheap and stands in for one step of OS compensation.
+	 */
+	InterfaceCPURNG interfaceCPURNG;
+	InterfaceJitter interfaceJitter;
+	bool cpuCaptured = false;
+	bool jitterCaptured = false;
+	int sourceCompensation = 0;
+
+	if (interfaceCPURNG.available()) {
+		cpuCaptured = interfaceCPURNG.generateRandomBytes(
+			IsaacRandomPool::NUM_CPU_RANDOM_BYTES
+			* std::pow(2, multiplier)
+		);
+
+		if (cpuCaptured) {
+			sourceCompensation = sourceCompensation + 1;
+		}
+	}
+
+	// Jitter is only needed while the OS would otherwise compensate.
+	if (!(WITH_PORTAUDIO == 1 && WITH_OPENCV == 1)
+		&& interfaceJitter.available()) {
+		// Capture timing jitter, split across all hardware threads.
+		jitterCaptured = interfaceJitter.generateRandomBytes(
+			IsaacRandomPool::NUM_JITTER_BYTES
+			* std::pow(2, multiplier),
+			0
+		);
+
+		if (jitterCaptured) {
+			sourceCompensation = sourceCompensation + 1;
+		}
+	}
+
+	/* Each missing device source is compensated once; the CPU rng covers the
+	 * first step and jitter the next, the OS whatever remains.
 	 */
-	SeedGenerator seedGenerator(IsaacRandomPool::ENTROPYSPLIT);
+	int neededCompensation = (WITH_PORTAUDIO == 1 ? 0 : 1)
+		+ (WITH_OPENCV == 1 ? 0 : 1);
+	bool cpuRequired = cpuCaptured && (neededCompensation > 0);
+	bool jitterRequired = jitterCaptured
+		&& (neededCompensation > (cpuCaptured ? 1 : 0));
+
+	/* Hold the devices for the rest of the capture; accumulator harvests
+	 * skip meanwhile and reopen the devices released here afterwards.
+	 */
+	std::lock_guard<std::mutex> deviceLock(*_deviceMutex);
+	ReleaseHarvestDevices();
 
 	/* Check if access to the microphone is possible.
 	 * If Not check if the camera is accessible.
@@ -382,19 +1089,20 @@ bool IsaacRandomPool::GatherEntropyAndSeed(int multiplier) {
 		    	throw std::runtime_error("Cannot open camera device.");
 		    }
 
-			result = seedGenerator.processFromSource(&interfaceCamera);
+			result = seedGenerator.processFromSource(&interfaceCamera, "camera");
 		} else {
-			entropyCompensation = 1;
+			entropyCompensation = std::max(0, 1 - sourceCompensation);
 		}
 
 		// Set up OS rng to record samples.
 		InterfaceOSRNG interfaceOSRNG;
 
 		// Capture bytes from os randomness, increase num samples as an exponent
-		// of 2 determined by multiplier.
+		// of 2 determined by multiplier; split across all hardware threads.
 		status = interfaceOSRNG.generateRandomBytes(
 			IsaacRandomPool::NUM_OS_RANDOM_BYTES
-			* std::pow(2, multiplier + entropyCompensation)
+			* std::pow(2, multiplier + entropyCompensation),
+			0
 		);
 
 		if(!status) {
@@ -410,8 +1118,11 @@ bool IsaacRandomPool::GatherEntropyAndSeed(int multiplier) {
 	    /* Load data from sources as random bytes to seedGenerator.
 	     * A false result indicates the source failed to gather sufficient entropy.
 	     */
-	    result = result && seedGenerator.processFromSource(&interfaceOSRNG);
-	    result = result && seedGenerator.processFromSource(&interfaceMicrophone);
+	    result = result && seedGenerator.processFromSource(&interfaceOSRNG, "os");
+	    result = result && seedGenerator.processFromSource(
+	    	&interfaceMicrophone,
+	    	"microphone"
+	    );
 
 	    // Check if data is entropic enough.
 	    if (!result) {
@@ -421,7 +1132,7 @@ bool IsaacRandomPool::GatherEntropyAndSeed(int multiplier) {
 	} else if (WITH_OPENCV == 1) {
 
 		// Access more entropy from OS if neccessary.
-		int entropyCompensation = 1;
+		int entropyCompensation = std::max(0, 1 - sourceCompensation);
 
 		// Set up camera to record samples.
 		InterfaceCamera interfaceCamera;
@@ -441,10 +1152,11 @@ bool IsaacRandomPool::GatherEntropyAndSeed(int multiplier) {
 		InterfaceOSRNG interfaceOSRNG;
 
 		// Capture bytes from os randomness, increase num samples as an exponent
-		// of 2 determined by multiplier.
+		// of 2 determined by multiplier; split across all hardware threads.
 		status = interfaceOSRNG.generateRandomBytes(
 			IsaacRandomPool::NUM_OS_RANDOM_BYTES
-			* std::pow(2, multiplier + entropyCompensation)
+			* std::pow(2, multiplier + entropyCompensation),
+			0
 		);
 
 		if(!status) {
@@ -454,8 +1166,8 @@ bool IsaacRandomPool::GatherEntropyAndSeed(int multiplier) {
 	    /* Load data from sources as random bytes to seedGenerator.
 	     * A false result indicates the source failed to gather sufficient entropy.
 	     */
-		result = seedGenerator.processFromSource(&interfaceCamera);
-	    result = result && seedGenerator.processFromSource(&interfaceOSRNG);
+		result = seedGenerator.processFromSource(&interfaceCamera, "camera");
+	    result = result && seedGenerator.processFromSource(&interfaceOSRNG, "os");
 
 	    // Check if data is entropic enough.
 	    if (!result) {
@@ -465,16 +1177,17 @@ bool IsaacRandomPool::GatherEntropyAndSeed(int multiplier) {
 	} else {
 
 		// Access more entropy from OS if neccessary.
-		int entropyCompensation = 2;
+		int entropyCompensation = std::max(0, 2 - sourceCompensation);
 
 		// Set up OS rng to record samples.
 		InterfaceOSRNG interfaceOSRNG;
 
 		// Capture bytes from os randomness, increase num samples as an exponent
-		// of 2 determined by multiplier.
+		// of 2 determined by multiplier; split across all hardware threads.
 		status = interfaceOSRNG.generateRandomBytes(
 			IsaacRandomPool::NUM_OS_RANDOM_BYTES
-			* std::pow(2, multiplier + entropyCompensation)
+			* std::pow(2, multiplier + entropyCompensation),
+			0
 		);
 
 		if(!status) {
@@ -484,7 +1197,7 @@ bool IsaacRandomPool::GatherEntropyAndSeed(int multiplier) {
 	    /* Load data from sources as random bytes to seedGenerator.
 	     * A false result indicates the source failed to gather sufficient entropy.
 	     */
-	    result = seedGenerator.processFromSource(&interfaceOSRNG);
+	    result = seedGenerator.processFromSource(&interfaceOSRNG, "os");
 
 	    // Check if data is entropic enough.
 	    if (!result) {
@@ -493,19 +1206,26 @@ bool IsaacRandomPool::GatherEntropyAndSeed(int multiplier) {
 	    }
 	}
 
-    uint32_t seed[IsaacRandomPool::SEEDTERMS];
-
-    // Generate and copy seed from random bytes loaded to seedGenerator.
-    seedGenerator.generateSeed();
-    seedGenerator.copySeed(seed, IsaacRandomPool::SEEDTERMS);
-
-    // Seed ISSAC generator with a, b, c internal paramters set to 0.
-    _isaacrng.srand(0,0,0,seed);
+	/* Load data from the CPU rng and timing jitter. Only a source that stood
+	 * in for OS compensation must pass; otherwise its failure leaves the seed
+	 * as strong as the device sources already made it.
+	 */
+	if (cpuCaptured) {
+		bool cpuResult = seedGenerator.processFromSource(&interfaceCPURNG, "cpu");
+		if (cpuRequired) {
+			result = result && cpuResult;
+		}
+	}
 
-    // Generate BURN random bytes to put ISAAC generator in a stable state.
-    for (int i = 0; i < IsaacRandomPool::BURN; ++i) {
-        _isaacrng.rand();
-    }
+	if (jitterCaptured) {
+		bool jitterResult = seedGenerator.processFromSource(
+			&interfaceJitter,
+			"jitter"
+		);
+		if (jitterRequired) {
+			result = result && jitterResult;
+		}
+	}
 
     return result;
 }
@@ -32,6 +32,8 @@
 // -----------------
 #include <cassert>
 #include <numeric>
+#include <thread>
+#include <chrono>
 
 // ----------------
 // library includes
@@ -85,7 +87,21 @@ int initializeRNG() {
 
 	// Initialize RNG by generating a new seed and save state to file.
 	try {
-		if (g_PRNG.Initialize(file)) {
+		bool status = g_PRNG.Initialize(file);
+
+		// Print per-source entropy statistics of the mined seed.
+		SeedGenerator::EntropyReport report = g_PRNG.LastEntropyReport();
+		for (
+			auto it = report.sources.begin();
+			it != report.sources.end(); ++it
+		) {
+			std::cerr << "Source " << it->label
+				<< ": bytes " << it->bytesAbsorbed
+				<< ", credited bits " << it->creditedBits
+				<< ", estimator s " << it->estimatorSeconds << std::endl;
+		}
+
+		if (status && report.creditedBits > 0) {
 			std::cerr << "--Passed--" << std::endl;
 			return true;
 		} else {
@@ -98,6 +114,47 @@ int initializeRNG() {
 	}
 }
 
+// ---------
+// reseedRNG
+// ---------
+
+/**
+ * @brief Attempt to reseed an initialized rng from background accumulated
+ *        entropy.
+ *
+ * @return true, if test passed.
+ */
+int reseedRNG() {
+	std::cerr << "**Running test reseedRNG**" << std::endl;
+	std::string file(".test");
+	IsaacRandomPool g_PRNG;
+
+	// Reseed must fail on an uninitialized generator.
+	bool testVal = !g_PRNG.Reseed();
+
+	testVal = testVal
+		&& (g_PRNG.IsInitialized(file) == IsaacRandomPool::STATUS::SUCCESS);
+	testVal = testVal && g_PRNG.StartAccumulator();
+
+	// Wait (bounded) for the accumulator to gather enough entropy.
+	bool reseeded = false;
+	for (int i = 0; i < 600 && testVal && !reseeded; ++i) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+		reseeded = g_PRNG.Reseed();
+	}
+
+	g_PRNG.StopAccumulator();
+	testVal = testVal && reseeded;
+
+	if (!testVal) {
+		std::cerr << "!!Failed reseedRNG test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return testVal;
+}
+
 // -------------
 // loadRNGNoFile
 // -------------
@@ -240,6 +297,157 @@ int loadRNGWrongKey() {
 	return testVal;
 }
 
+// ------------------
+// initializeFromBank
+// ------------------
+
+/**
+ * @brief Attempt to initialize rng from a seed record in an encrypted seed
+ *        bank; the record must be consumed.
+ *
+ * @return true, if test passed.
+ */
+int initializeFromBank() {
+	std::cerr << "**Running test initializeFromBank**" << std::endl;
+	std::string file(".testbankstate");
+	std::string bankDirectory(".testbank");
+	std::vector<uint8_t> key(32,3);
+	std::vector<uint8_t> output(32,0);
+
+	SeedBank seedBank(bankDirectory, key);
+
+	// Deposit a record and check it is listed.
+	std::vector<uint8_t> record(IsaacRandomPool::SEEDTERMS * 4);
+	for (size_t i = 0; i < record.size(); ++i) {
+		record[i] = static_cast<uint8_t>(i * 31 + 7);
+	}
+	bool testVal = seedBank.deposit(record);
+	testVal = testVal && (seedBank.size() == 1);
+
+	// Initialize must consume the banked record.
+	IsaacRandomPool g_PRNG;
+	g_PRNG.SetSeedBank(bankDirectory, key);
+
+	try {
+		testVal = testVal && g_PRNG.Initialize(file);
+		g_PRNG.GenerateBlock(output.data(), output.size());
+	} catch (std::runtime_error& e) {
+		std::cerr << "Caught exception: " << e.what() << std::endl;
+		testVal = false;
+	}
+
+	testVal = testVal && (seedBank.size() == 0);
+
+	// Report marks the banked seed.
+	SeedGenerator::EntropyReport report = g_PRNG.LastEntropyReport();
+	testVal = testVal && (report.sources.size() == 1)
+		&& (report.sources[0].label == "bank")
+		&& (report.bytesAbsorbed == record.size());
+
+	// Empty bank cannot be withdrawn from.
+	testVal = testVal && !seedBank.withdraw(record);
+
+	if (!testVal) {
+		std::cerr << "!!Failed initializeFromBank test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return testVal;
+}
+
+// ----------------
+// initializeShards
+// ----------------
+
+/**
+ * @brief Attempt to initialize several rngs from a single mining pass;
+ *        their outputs must differ.
+ *
+ * @return true, if test passed.
+ */
+int initializeShards() {
+	std::cerr << "**Running test initializeShards**" << std::endl;
+	IsaacRandomPool first;
+	IsaacRandomPool second;
+	std::vector<IsaacRandomPool*> shards = {&first, &second};
+	std::vector<std::string> files = {".testshard0", ".testshard1"};
+	std::vector<uint8_t> firstOutput(32,0);
+	std::vector<uint8_t> secondOutput(32,0);
+
+	bool testVal;
+	try {
+		testVal = IsaacRandomPool::InitializeShards(shards, files);
+		first.GenerateBlock(firstOutput.data(), firstOutput.size());
+		second.GenerateBlock(secondOutput.data(), secondOutput.size());
+	} catch (std::runtime_error& e) {
+		std::cerr << "Caught exception: " << e.what() << std::endl;
+		testVal = false;
+	}
+
+	testVal = testVal && (firstOutput != secondOutput);
+
+	// Both shards share the report of the single mining pass.
+	testVal = testVal && (first.LastEntropyReport().creditedBits > 0);
+	testVal = testVal && (first.LastEntropyReport().bytesAbsorbed
+		== second.LastEntropyReport().bytesAbsorbed);
+
+	if (!testVal) {
+		std::cerr << "!!Failed initializeShards test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return testVal;
+}
+
+// ----------------------------
+// initializeWhileAccumulating
+// ----------------------------
+
+/**
+ * @brief Attempt to initialize rng while the accumulator harvests the
+ *        camera and microphone in the background; Initialize must take
+ *        over the devices, and harvesting resume afterwards.
+ *
+ * @return true, if test passed.
+ */
+int initializeWhileAccumulating() {
+	std::cerr << "**Running test initializeWhileAccumulating**" << std::endl;
+	std::string file(".test");
+	IsaacRandomPool g_PRNG;
+
+	bool testVal = g_PRNG.StartAccumulator();
+
+	// Let the harvesters open the devices.
+	std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+	try {
+		testVal = testVal && g_PRNG.Initialize(file);
+	} catch (std::runtime_error& e) {
+		std::cerr << "Caught exception: " << e.what() << std::endl;
+		testVal = false;
+	}
+
+	// Wait (bounded) for harvesting to gather enough entropy again.
+	bool reseeded = false;
+	for (int i = 0; i < 600 && testVal && !reseeded; ++i) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+		reseeded = g_PRNG.Reseed();
+	}
+
+	g_PRNG.StopAccumulator();
+	testVal = testVal && reseeded;
+
+	if (!testVal) {
+		std::cerr << "!!Failed initializeWhileAccumulating test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return testVal;
+}
+
 int main(){
 	IsaacRandomPool g_PRNG;
 
@@ -249,17 +457,21 @@ int main(){
 	int passed = 0;
 	passed += runUnInitialized();
 	passed += initializeRNG();
+	passed += reseedRNG();
 	passed += loadRNGNoFile();
 	passed += loadRNGFromState();
 	saveEncrypted();
 	passed += loadRNGEncrypted();
 	passed += loadRNGWrongKey();
+	passed += initializeFromBank();
+	passed += initializeShards();
+	passed += initializeWhileAccumulating();
 
 	std::cerr << std::endl;
-	std::cerr << "--Passed " << passed << "/6" << " tests--" << std::endl;
+	std::cerr << "--Passed " << passed << "/10" << " tests--" << std::endl;
 	std::cerr << "Entropy strength: " << g_PRNG.EntropyStrength() << std::endl;
 
 	// Assert passing all tests.
-	assert(passed == 6);
+	assert(passed == 10);
 	return 0;
 }
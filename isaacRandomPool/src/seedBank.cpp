@@ -0,0 +1,295 @@
+/** @file seedBank.cpp
+ *  @brief Definition of the class functions in seedBank.h
+ *
+ *  @author Aashish Sheshadri
+ *  @author Rohit Harchandani
+ *
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2015, 2016, 2017 PayPal
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+// -----------------
+// standard includes
+// -----------------
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+
+#ifdef _WIN32
+	#include <windows.h>
+	#include <direct.h>
+#else
+	#include <dirent.h>
+	#include <sys/stat.h>
+	#include <sys/types.h>
+	#include <unistd.h>
+#endif
+
+// --------------------
+// third party includes
+// --------------------
+#include <osrng.h>
+
+// ----------------
+// library includes
+// ----------------
+#include "seedBank.h"
+#include "shake256.h"
+#include "fileCryptopp.h"
+
+const std::string SeedBank::RECORD_EXTENSION = ".seed";
+
+// -----------
+// Constructor
+// -----------
+
+/**
+ * Constructor
+ * @brief Creates SeedBank object associated with a bank directory.
+ *
+ * @param directory const reference to a string with the bank directory;
+ *        created if it does not exist.
+ * @param key const reference to a byte vector with the bank encryption
+ *        key (AES-GCM key length); records are never stored in clear.
+ */
+SeedBank::SeedBank(
+	const std::string& directory,
+	const std::vector<uint8_t>& key
+):
+	_directory(directory),
+	_key(key) {
+
+	// Create bank directory, accessible to the owner only.
+#ifdef _WIN32
+	_mkdir(_directory.c_str());
+#else
+	mkdir(_directory.c_str(), S_IRWXU);
+#endif
+}
+
+// -------
+// deposit
+// -------
+
+/**
+ * @brief Encrypts and writes a seed record to the bank.
+ *
+ * @param record const reference to a byte vector with the seed record.
+ *
+ * @return true, if the record was deposited.
+ */
+bool SeedBank::deposit(const std::vector<uint8_t>& record) {
+
+	// Records are only stored encrypted.
+	if (_key.size() != FileCryptopp::AESNODE_DEFAULT_KEY_LENGTH_BYTES
+		|| record.empty()) {
+		return false;
+	}
+
+	// Generate a random record name.
+	std::vector<uint8_t> nameBytes(SeedBank::RECORD_NAME_BYTES);
+
+	try {
+		CryptoPP::AutoSeededRandomPool generator;
+		generator.GenerateBlock(nameBytes.data(), nameBytes.size());
+	} catch (...) {
+		std::cerr << "[Failed] OS RNG failed to generate bytes" << std::endl;
+		return false;
+	}
+
+	std::stringstream nameStream;
+	for (auto it = nameBytes.begin(); it != nameBytes.end(); ++it) {
+		nameStream << std::hex << std::setw(2) << std::setfill('0')
+			<< static_cast<int>(*it);
+	}
+	std::string name = nameStream.str();
+
+	/* Write to a temporary file first so that partial records are never
+	 * visible for withdrawal.
+	 */
+	std::string tempFile = _directory + "/.deposit-" + name;
+	std::string recordFile = _directory + "/" + name
+		+ SeedBank::RECORD_EXTENSION;
+
+	FileCryptopp fileEncryptor(tempFile);
+
+	if (!fileEncryptor.writeFile(
+		record.data(),
+		record.size(),
+		recordKey(name)
+	)) {
+		std::remove(tempFile.c_str());
+		return false;
+	}
+
+	// Publish record.
+	if (std::rename(tempFile.c_str(), recordFile.c_str()) != 0) {
+		std::remove(tempFile.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+// --------
+// withdraw
+// --------
+
+/**
+ * @brief Claims, decrypts and deletes one seed record from the bank.
+ *
+ * @param record reference to a byte vector to hold the seed record.
+ *
+ * @return true, if a record was withdrawn; false if the bank is empty.
+ */
+bool SeedBank::withdraw(std::vector<uint8_t>& record) {
+
+	if (_key.size() != FileCryptopp::AESNODE_DEFAULT_KEY_LENGTH_BYTES) {
+		return false;
+	}
+
+	std::vector<std::string> names = listRecords();
+
+	for (auto it = names.begin(); it != names.end(); ++it) {
+		std::string recordFile = _directory + "/" + *it
+			+ SeedBank::RECORD_EXTENSION;
+		std::string claimFile = _directory + "/.claim-" + *it;
+
+		/* Claim record; rename is atomic, so only one process can succeed
+		 * and the record leaves the bank before it is read.
+		 */
+		if (std::rename(recordFile.c_str(), claimFile.c_str()) != 0) {
+			continue; // Claimed by another process.
+		}
+
+		FileCryptopp fileDecryptor(claimFile);
+
+		bool status = fileDecryptor.readFile(record, recordKey(*it));
+
+		// Delete record whether or not it could be decrypted.
+		std::remove(claimFile.c_str());
+
+		if (!status) {
+			std::cerr << "[Seed Bank] Discarded unreadable record" << std::endl;
+			continue;
+		}
+
+		return true;
+	}
+
+	return false;
+}
+
+// ----
+// size
+// ----
+
+/**
+ * @brief Counts records available for withdrawal.
+ *
+ * @return size_t with number of records in the bank.
+ */
+size_t SeedBank::size() {
+	return listRecords().size();
+}
+
+// ---------
+// recordKey
+// ---------
+
+/**
+ * @brief Derives the encryption key of a record from the bank key and
+ *        the record name, so that no two records share a key.
+ *
+ * @param name const reference to a string with the record name.
+ *
+ * @return byte vector with the record key.
+ */
+std::vector<uint8_t> SeedBank::recordKey(const std::string& name) {
+	static const std::string label = "seifrng seed bank record";
+
+	Shake256 kdf;
+	kdf.Update(reinterpret_cast<const uint8_t*>(label.data()), label.size());
+	kdf.Update(_key.data(), _key.size());
+	kdf.Update(reinterpret_cast<const uint8_t*>(name.data()), name.size());
+
+	std::vector<uint8_t> key(FileCryptopp::AESNODE_DEFAULT_KEY_LENGTH_BYTES);
+	kdf.Squeeze(key.data(), key.size());
+
+	return key;
+}
+
+// -----------
+// listRecords
+// -----------
+
+/**
+ * @brief Lists names of records available for withdrawal.
+ *
+ * @return vector of strings with record names (without extension).
+ */
+std::vector<std::string> SeedBank::listRecords() {
+	std::vector<std::string> names;
+	const std::string& extension = SeedBank::RECORD_EXTENSION;
+
+	// Keep entries ending in RECORD_EXTENSION, without the extension.
+	auto addRecord = [&names, &extension] (const std::string& entry) {
+		if (entry.size() > extension.size()
+			&& entry.compare(
+				entry.size() - extension.size(),
+				extension.size(),
+				extension
+			) == 0) {
+			names.push_back(entry.substr(0, entry.size() - extension.size()));
+		}
+	};
+
+#ifdef _WIN32
+	WIN32_FIND_DATAA entry;
+	HANDLE handle = FindFirstFileA((_directory + "/*").c_str(), &entry);
+
+	if (handle == INVALID_HANDLE_VALUE) {
+		return names;
+	}
+
+	do {
+		addRecord(entry.cFileName);
+	} while (FindNextFileA(handle, &entry));
+
+	FindClose(handle);
+#else
+	DIR* dir = opendir(_directory.c_str());
+
+	if (dir == NULL) {
+		return names;
+	}
+
+	while (struct dirent* entry = readdir(dir)) {
+		addRecord(entry->d_name);
+	}
+
+	closedir(dir);
+#endif
+
+	return names;
+}
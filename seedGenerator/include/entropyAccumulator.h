@@ -0,0 +1,288 @@
+/** @file entropyAccumulator.h
+ *  @brief Class header tasked with continuous entropy accumulation over
+ *         multiple pools (Fortuna). Sources feed small events into the pools
+ *         in round-robin order from a background thread; draws reseed from
+ *         pools 0..j on a doubling schedule without a fresh capture.
+ *
+ *  @author Aashish Sheshadri
+ *  @author Rohit Harchandani
+ *
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2015, 2016, 2017 PayPal
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef ENTROPYACCUMULATOR_H
+#define ENTROPYACCUMULATOR_H
+
+// -----------------
+// standard includes
+// -----------------
+#include <vector>
+#include <array>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+// ----------------
+// library includes
+// ----------------
+#include "shake256.h"
+
+/**
+ * @class EntropyAccumulator tasked with accumulating entropic events into
+ *        NUMPOOLS pools and drawing reseed material from them.
+ */
+class EntropyAccumulator {
+public:
+
+	// ---------
+	// constants
+	// ---------
+
+	// Number of entropy pools.
+	static const size_t NUMPOOLS = 32;
+
+	// Max bytes per event; longer harvests are split over multiple events.
+	static const size_t MAXEVENTSIZE = 32;
+
+	// Bytes required in pool 0 before a reseed is performed.
+	static const size_t MINPOOLSIZE = 64;
+
+	// Minimum time in milliseconds between reseeds.
+	static const size_t MINRESEEDINTERVALMS = 100;
+
+	// Bytes of generator key carried between draws.
+	static const size_t KEYSIZE = 64;
+
+	// ---------
+	// Harvester
+	// ---------
+
+	/* Callable appending freshly harvested entropic bytes to its argument;
+	 * returns false if the source failed to produce data.
+	 */
+	typedef std::function<bool(std::vector<uint8_t>&)> Harvester;
+
+	// -----------
+	// Constructor
+	// -----------
+
+	/**
+	 * Constructor
+	 * @brief Creates EntropyAccumulator object with empty pools.
+	 */
+	EntropyAccumulator();
+
+	// ----------
+	// Destructor
+	// ----------
+
+	/**
+	 * Destructor
+	 * @brief Stops background harvesting if running.
+	 */
+	~EntropyAccumulator();
+
+	// ------------
+	// addHarvester
+	// ------------
+
+	/**
+	 * @brief Registers a source to be harvested by the background thread.
+	 *        Must be called before start.
+	 *
+	 * @param harvester Harvester appending entropic bytes.
+	 * @param period size_t number of harvesting intervals between
+	 *        invocations of harvester (default 1, i.e. every interval).
+	 *
+	 * @return int with the source identifier, -1 if harvesting is running.
+	 */
+	int addHarvester(Harvester harvester, size_t period = 1);
+
+	// --------
+	// addEvent
+	// --------
+
+	/**
+	 * @brief Adds entropic bytes from a source to the pools; events are
+	 *        distributed over the pools in round-robin order per source.
+	 *
+	 * @param sourceId uint8_t with the source identifier.
+	 * @param data const pointer to entropic bytes.
+	 * @param length size_t with number of entropic bytes.
+	 *
+	 * @return void
+	 */
+	void addEvent(uint8_t sourceId, const uint8_t* data, size_t length);
+
+	// -----
+	// start
+	// -----
+
+	/**
+	 * @brief Starts harvesting registered sources on a background thread.
+	 *
+	 * @param interval milliseconds between harvests (default 100ms).
+	 *
+	 * @return true, if harvesting was started.
+	 */
+	bool start(
+		std::chrono::milliseconds interval = std::chrono::milliseconds(100)
+	);
+
+	// ----
+	// stop
+	// ----
+
+	/**
+	 * @brief Stops background harvesting and joins the harvesting thread.
+	 *
+	 * @return void
+	 */
+	void stop();
+
+	// ----
+	// draw
+	// ----
+
+	/**
+	 * @brief Reseeds from pools 0..j if pool 0 holds enough data (pool j is
+	 *        used on every 2^j-th reseed) and writes length bytes derived
+	 *        from the reseeded generator key.
+	 *
+	 * @param output pointer to memory to hold length bytes.
+	 * @param length size_t with number of bytes required.
+	 *
+	 * @return true, if output was written; false if no reseed has ever
+	 *         been possible.
+	 */
+	bool draw(uint8_t* output, size_t length);
+
+	// --------
+	// copySeed
+	// --------
+
+	/**
+	 * @brief Draws seed (len terms) into memory pointed to by seed.
+	 *
+	 * @param seed pointer of type T (template type), pointing to memory to
+	 *        store the seed.
+	 * @param len size_t with number of seed terms required.
+	 *
+	 * @return true, if seed was written.
+	 */
+	template <typename T>
+	bool copySeed(T* seed, size_t len);
+
+	// -----------
+	// reseedCount
+	// -----------
+
+	/**
+	 * @brief Returns number of reseeds performed.
+	 *
+	 * @return size_t with the reseed count.
+	 */
+	size_t reseedCount();
+
+private:
+
+	// -------
+	// harvest
+	// -------
+
+	/**
+	 * @brief Background thread loop invoking registered harvesters.
+	 *
+	 * @param interval milliseconds between harvests.
+	 *
+	 * @return void
+	 */
+	void harvest(std::chrono::milliseconds interval);
+
+	// ------
+	// reseed
+	// ------
+
+	/**
+	 * @brief Folds pools 0..j into the generator key. Caller holds _mutex.
+	 *
+	 * @return void
+	 */
+	void reseed();
+
+	// ----
+	// data
+	// ----
+	std::array<Shake256, NUMPOOLS> _pools; // Entropy pools.
+	std::array<size_t, NUMPOOLS> _poolSizes; // Bytes absorbed per pool.
+	std::vector<size_t> _nextPool; // Next pool per source (round-robin).
+	std::vector<std::pair<Harvester, size_t> > _harvesters; // Sources.
+	std::array<uint8_t, KEYSIZE> _key; // Generator key.
+	size_t _reseedCount; // Number of reseeds performed.
+	std::chrono::steady_clock::time_point _lastReseed; // Time of last reseed.
+	std::mutex _mutex; // Guards pools and generator key.
+	std::mutex _runMutex; // Guards harvesting state.
+	std::condition_variable _stopSignal; // Wakes harvesting thread on stop.
+	std::thread _thread; // Harvesting thread.
+	bool _running; // Status of harvesting.
+};
+
+// --------
+// copySeed
+// --------
+
+/**
+ * @brief Draws seed (len terms) into memory pointed to by seed.
+ *
+ * @param seed pointer of type T (template type), pointing to memory to
+ *        store the seed.
+ * @param len size_t with number of seed terms required.
+ *
+ * @return true, if seed was written.
+ */
+template <typename T>
+bool EntropyAccumulator::copySeed(T* seed, size_t len) {
+	size_t numBytes = sizeof(T); // Number of bytes per seed term.
+	std::vector<uint8_t> seedBytes(len * numBytes);
+
+	if (!draw(seedBytes.data(), seedBytes.size())) {
+		return false;
+	}
+
+	// Group bytes into terms.
+	auto it = seedBytes.begin();
+	for (size_t i = 0; i < len; ++i) {
+		seed[i] = 0;
+
+		for (size_t j = 0; j < numBytes; ++j) {
+			seed[i] = (seed[i] << 8) + *it;
+			++it;
+		}
+	}
+
+	return true;
+}
+
+#endif
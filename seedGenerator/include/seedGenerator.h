@@ -36,8 +36,10 @@
 // standard includes
 // -----------------
 #include <iterator>
+#include <algorithm>
 #include <vector>
 #include <array>
+#include <string>
 #include <iostream>
 
 // --------------------
@@ -49,6 +51,7 @@
 // library includes
 // ----------------
 #include "randomSource.h"
+#include "shake256.h"
 
 
 /**
@@ -64,6 +67,45 @@ public:
 	// Threshold on entropy estimate.
 	static constexpr double ENTROPYTHRESHOLD = 0.25;
 
+	// ----
+	// MODE
+	// ----
+
+	// Conditioning modes for entropic data.
+	enum class MODE:int {
+		SPLIT = 0, // numDivs independent SHA3-512 hashes, 64 bytes each.
+		XOF = 1    // Single SHAKE256 state, squeezed to the requested length.
+	};
+
+	// ------------
+	// SourceReport
+	// ------------
+
+	// Statistics of data offered by a single RandomSource.
+	struct SourceReport {
+		std::string label;        // Source label given on processing.
+		bool accepted;            // Data met the entropy thresholds.
+		size_t bytesAbsorbed;     // Bytes hashed into the seed.
+		double bitProbability;    // Avg. bit occurrence from bitEntropy().
+		double bitMinEntropy;     // Min-entropy per byte from bit estimate.
+		double byteMinEntropy;    // Min-entropy per byte from byte counts.
+		double creditedBits;      // Min-entropy credited (conservative).
+		double estimatorSeconds;  // Time spent in entropy estimators.
+		std::vector<bool> splitPassed; // Byte estimate result per split.
+	};
+
+	// -------------
+	// EntropyReport
+	// -------------
+
+	// Statistics of all sources contributing to a seed.
+	struct EntropyReport {
+		std::vector<SourceReport> sources; // Per source, in order offered.
+		size_t bytesAbsorbed; // Total bytes hashed into the seed.
+		double creditedBits;  // Total min-entropy credited.
+		EntropyReport(): bytesAbsorbed(0), creditedBits(0.0) {}
+	};
+
 	// -----------
 	// Constructor
 	// -----------
@@ -72,16 +114,19 @@ public:
 	 * Constructor
 	 * @brief Creates SeedGenerator object and initilizes internal properties.
 	 * @param numDivs int indicating number of independent hashes to compute
-	 *        on data.
+	 *        on data. In XOF mode, number of splits the entropy estimate is
+	 *        checked over; data is absorbed into a single SHAKE256 state.
+	 * @param mode MODE with conditioning mode (default SPLIT).
 	 */
-	SeedGenerator(int numDivs);
+	SeedGenerator(int numDivs, MODE mode = MODE::SPLIT);
 
 	// --------
 	// copySeed
 	// --------
 
 	/**
-	 * @brief Writes seed (len terms) into memory pointed to by seed.
+	 * @brief Writes seed (len terms) into memory pointed to by seed. In XOF
+	 *        mode any number of terms can be written.
 	 *
 	 * @param seed pointer of type T (template type), pointing to memory to
 	 *        store the seed.
@@ -92,19 +137,70 @@ public:
 	template <typename T>
 	void copySeed(T* seed, size_t len);
 
+	// ---------
+	// copySeeds
+	// ---------
+
+	/**
+	 * @brief Writes count domain-separated seeds (len terms each) derived
+	 *        from the same conditioned pool into memory pointed to by seeds,
+	 *        seed i occupying terms [i * len, (i + 1) * len). Each seed is
+	 *        squeezed from a copy of the pool keyed with its index. Only
+	 *        available in XOF mode.
+	 *
+	 * @param seeds pointer of type T (template type), pointing to memory to
+	 *        store count * len terms.
+	 * @param len size_t with number of terms per seed.
+	 * @param count size_t with number of seeds required.
+	 *
+	 * @return void
+	 */
+	template <typename T>
+	void copySeeds(T* seeds, size_t len, size_t count);
+
 	// ----------------
 	// processFromSource
 	// ----------------
 
 	/**
 	 * @brief Computes rolling hash on entropic data from a randomSource if data
-	 *        meets threshold on entropy estimate.
+	 *        meets threshold on entropy estimate. Statistics are recorded in
+	 *        the entropy report.
 	 *
 	 * @param randomSource pointer to a RandomSource.
+	 * @param label const reference to a string naming the source in the
+	 *        entropy report (default empty).
 	 *
 	 * @return true, if data was entropic enough to be processed.
 	 */
-	bool processFromSource(RandomSource* randomSource);
+	bool processFromSource(
+		RandomSource* randomSource,
+		const std::string& label = std::string()
+	);
+
+	// -------------
+	// mixFromSource
+	// -------------
+
+	/**
+	 * @brief Hashes data from a randomSource without the entropy estimators,
+	 *        crediting a fixed number of bits chosen by the caller. Meant for
+	 *        structured state (clocks, counters, addresses) the estimators
+	 *        cannot judge. Statistics are recorded in the entropy report.
+	 *
+	 * @param randomSource pointer to a RandomSource.
+	 * @param creditedBits double with min-entropy to credit, capped at 8
+	 *        bits per byte of data.
+	 * @param label const reference to a string naming the source in the
+	 *        entropy report (default empty).
+	 *
+	 * @return true, if data was available to be processed.
+	 */
+	bool mixFromSource(
+		RandomSource* randomSource,
+		double creditedBits,
+		const std::string& label = std::string()
+	);
 
 	// ------------
 	// generateSeed
@@ -115,9 +211,9 @@ public:
 	 *        data after this invocation, unless seed is copied or resetState
 	 *        is invoked.
 	 *
-	 * @return void
+	 * @return EntropyReport with statistics of sources processed for the seed.
 	 */
-	void generateSeed();
+	EntropyReport generateSeed();
 
 	// ----------
 	// resetState
@@ -159,20 +255,24 @@ private:
 	 *
 	 * @param begin input iterator to the beginning of the byte stream.
 	 * @param end input iterator to the end of the byte stream.
+	 * @param byteCounts reference to an array accumulating byte occurrences.
 	 *
 	 * @return true, if entropy estimate of byte stream is acceptable.
 	 */
 	template <typename II>
-	bool entropy(II begin, II end);
+	bool entropy(II begin, II end, std::array<size_t, 256>& byteCounts);
 
 	// ----
 	// data
 	// ----
 	std::vector<std::array<uint8_t, CryptoPP::SHA3_512::DIGESTSIZE> > _digests;
 	std::vector<CryptoPP::SHA3_512> _hashVec;
+	Shake256 _xof; // Conditioning state in XOF mode.
 	static const double byteBitProbs[];
 	int _numDivs;
+	MODE _mode;
 	bool _seedReady;
+	EntropyReport _report; // Statistics of sources processed for the seed.
 };
 
 // --------
@@ -180,7 +280,8 @@ private:
 // --------
 
 /**
- * @brief Writes seed (len terms) into memory pointed to by seed.
+ * @brief Writes seed (len terms) into memory pointed to by seed. In XOF
+ *        mode any number of terms can be written.
  *
  * @param seed pointer of type T (template type), pointing to memory to
  *        store the seed.
@@ -203,6 +304,24 @@ void SeedGenerator::copySeed(T* seed, size_t len) {
 		return; // Cannot write seed terms of this type.
 	}
 
+	// Squeeze exactly the bytes required for len terms in XOF mode.
+	if (_mode == MODE::XOF) {
+		std::vector<uint8_t> seedBytes(len * numBytes);
+		_xof.Squeeze(seedBytes.data(), seedBytes.size());
+
+		// Group squeezed bytes into terms and write to seed.
+		groupBytes(seedBytes.begin(), seedBytes.end(), seed, numBytes);
+
+		// Wipe squeezed bytes from memory.
+		std::fill(seedBytes.begin(), seedBytes.end(), 0);
+
+		// Reset conditioning state so that a new seed can be generated.
+		_xof.Restart();
+		_report = EntropyReport();
+		_seedReady = false;
+		return;
+	}
+
 	// Seed terms possible per hash.
 	int possibleGroups = (_digests[0]).size() / numBytes;
 
@@ -232,6 +351,75 @@ void SeedGenerator::copySeed(T* seed, size_t len) {
 	}
 
 	// Reset state of _seedReady so that a new seed can be generated.
+	_report = EntropyReport();
+	_seedReady = false;
+}
+
+// ---------
+// copySeeds
+// ---------
+
+/**
+ * @brief Writes count domain-separated seeds (len terms each) derived
+ *        from the same conditioned pool into memory pointed to by seeds,
+ *        seed i occupying terms [i * len, (i + 1) * len). Each seed is
+ *        squeezed from a copy of the pool keyed with its index. Only
+ *        available in XOF mode.
+ *
+ * @param seeds pointer of type T (template type), pointing to memory to
+ *        store count * len terms.
+ * @param len size_t with number of terms per seed.
+ * @param count size_t with number of seeds required.
+ *
+ * @return void
+ */
+template <typename T>
+void SeedGenerator::copySeeds(T* seeds, size_t len, size_t count) {
+
+	// Check if seed is ready and the pool can be keyed i.e. XOF mode.
+	if (!_seedReady || _mode != MODE::XOF) {
+		return;
+	}
+
+	size_t numBytes = sizeof(T); // Number of bytes per seed term.
+
+	// Check if numBytes is a power of 2.
+	if ((numBytes & (numBytes - 1)) != 0) {
+		return; // Cannot write seed terms of this type.
+	}
+
+	// Domain separation label absorbed ahead of the seed index.
+	const char label[] = "seifrng seed index";
+
+	std::vector<uint8_t> seedBytes(len * numBytes);
+	for (size_t index = 0; index < count; ++index) {
+
+		// Copy of the pool; _xof itself has absorbed data but not been padded.
+		Shake256 keyed(_xof);
+		keyed.Update(reinterpret_cast<const uint8_t*>(label), sizeof(label));
+
+		// Absorb index as 8 bytes, big endian.
+		uint8_t indexBytes[8];
+		for (int i = 0; i < 8; ++i) {
+			indexBytes[i] = static_cast<uint8_t>(
+				static_cast<uint64_t>(index) >> (8 * (7 - i)));
+		}
+		keyed.Update(indexBytes, sizeof(indexBytes));
+
+		// Squeeze seed and group bytes into terms.
+		keyed.Squeeze(seedBytes.data(), seedBytes.size());
+		seeds = groupBytes(seedBytes.begin(), seedBytes.end(), seeds, numBytes);
+
+		// Wipe the keyed copy of the pool.
+		keyed.Restart();
+	}
+
+	// Wipe squeezed bytes from memory.
+	std::fill(seedBytes.begin(), seedBytes.end(), 0);
+
+	// Reset conditioning state so that a new seed can be generated.
+	_xof.Restart();
+	_report = EntropyReport();
 	_seedReady = false;
 }
 
@@ -277,21 +465,33 @@ OI SeedGenerator::groupBytes(II begin, II end, OI out, size_t numBytes) {
  *
  * @param begin input iterator to the beginning of the byte stream.
  * @param end input iterator to the end of the byte stream.
+ * @param byteCounts reference to an array accumulating byte occurrences.
  *
  * @return true, if entropy estimate of byte stream is acceptable.
  */
 template <typename II>
-bool SeedGenerator::entropy(II begin, II end) {
-	double byteProbSum = 0.0f; // Reset accumulator of byte stream.
+bool SeedGenerator::entropy(
+	II begin,
+	II end,
+	std::array<size_t, 256>& byteCounts
+) {
+	std::array<size_t, 256> counts; // Byte occurrences in this stream.
+	counts.fill(0);
 	size_t size = end - begin; // Number of bytes for normalization.
 
-	// Loop through byte stream.
+	// Loop through byte stream and count byte occurrences.
 	while (begin != end) {
-		// Access byte bit occurrence probability from cache and accumulate.
-		byteProbSum += SeedGenerator::byteBitProbs[*begin];
+		++counts[static_cast<uint8_t>(*begin)];
 		++begin;
 	}
 
+	// Accumulate byte bit occurrence probabilities from counts.
+	double byteProbSum = 0.0f;
+	for (size_t i = 0; i < counts.size(); ++i) {
+		byteProbSum += counts[i] * SeedGenerator::byteBitProbs[i];
+		byteCounts[i] += counts[i];
+	}
+
 	// Normalize
 	double byteAvgProb = byteProbSum / static_cast<double>(size);
 
@@ -0,0 +1,129 @@
+/** @file shake256.h
+ *  @brief Class header implementing the SHAKE256 extendable output function
+ *         (FIPS 202) over the Keccak-f[1600] permutation. Crypto++ 5.6.5
+ *         provides fixed length SHA3 digests only; SHAKE256 lets the seed
+ *         generator squeeze exactly as many seed bytes as are requested.
+ *
+ *  @author Aashish Sheshadri
+ *  @author Rohit Harchandani
+ *
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2015, 2016, 2017 PayPal
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SHAKE256_H
+#define SHAKE256_H
+
+// -----------------
+// standard includes
+// -----------------
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class Shake256 tasked with absorbing an arbitrary byte stream and
+ *        squeezing an arbitrary length output from it (SHAKE256, FIPS 202).
+ */
+class Shake256 {
+public:
+
+	// ---------
+	// constants
+	// ---------
+
+	// Sponge rate in bytes for a 256 bit security level (1600 - 2*256 bits).
+	static const size_t RATE = 136;
+
+	// -----------
+	// Constructor
+	// -----------
+
+	/**
+	 * Constructor
+	 * @brief Creates Shake256 object with an empty sponge state.
+	 */
+	Shake256();
+
+	// ------
+	// Update
+	// ------
+
+	/**
+	 * @brief Absorbs length bytes into the sponge. Has no effect once
+	 *        squeezing has begun, unless Restart is invoked.
+	 *
+	 * @param input const pointer to the bytes to be absorbed.
+	 * @param length size_t with number of bytes to absorb.
+	 *
+	 * @return void
+	 */
+	void Update(const uint8_t* input, size_t length);
+
+	// -------
+	// Squeeze
+	// -------
+
+	/**
+	 * @brief Pads the absorbed stream (on first invocation) and writes length
+	 *        output bytes. Successive calls continue the output stream.
+	 *
+	 * @param output pointer to memory to hold length bytes.
+	 * @param length size_t with number of bytes to squeeze.
+	 *
+	 * @return void
+	 */
+	void Squeeze(uint8_t* output, size_t length);
+
+	// -------
+	// Restart
+	// -------
+
+	/**
+	 * @brief Resets the sponge to its initial (empty) state.
+	 *
+	 * @return void
+	 */
+	void Restart();
+
+private:
+
+	// -------
+	// permute
+	// -------
+
+	/**
+	 * @brief Applies the Keccak-f[1600] permutation to the sponge state.
+	 *
+	 * @return void
+	 */
+	void permute();
+
+	// ----
+	// data
+	// ----
+	std::array<uint64_t, 25> _state; // Keccak state as 5x5 64bit lanes.
+	size_t _position; // Byte offset within the rate portion of the state.
+	bool _squeezing;  // Status of sponge; absorbing or squeezing.
+};
+
+#endif
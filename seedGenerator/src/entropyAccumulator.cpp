@@ -0,0 +1,316 @@
+/** @file entropyAccumulator.cpp
+ *  @brief Definition of the class functions in entropyAccumulator.h
+ *
+ *  @author Aashish Sheshadri
+ *  @author Rohit Harchandani
+ *
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2015, 2016, 2017 PayPal
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+// ----------------
+// library includes
+// ----------------
+#include "entropyAccumulator.h"
+
+// -----------
+// Constructor
+// -----------
+
+/**
+ * Constructor
+ * @brief Creates EntropyAccumulator object with empty pools.
+ */
+EntropyAccumulator::EntropyAccumulator():
+	_reseedCount(0),
+	_running(false) {
+
+	_poolSizes.fill(0);
+	_key.fill(0);
+}
+
+// ----------
+// Destructor
+// ----------
+
+/**
+ * Destructor
+ * @brief Stops background harvesting if running.
+ */
+EntropyAccumulator::~EntropyAccumulator() {
+	stop();
+}
+
+// ------------
+// addHarvester
+// ------------
+
+/**
+ * @brief Registers a source to be harvested by the background thread.
+ *        Must be called before start.
+ *
+ * @param harvester Harvester appending entropic bytes.
+ * @param period size_t number of harvesting intervals between
+ *        invocations of harvester (default 1, i.e. every interval).
+ *
+ * @return int with the source identifier, -1 if harvesting is running.
+ */
+int EntropyAccumulator::addHarvester(Harvester harvester, size_t period) {
+	std::lock_guard<std::mutex> lock(_runMutex);
+
+	// Sources cannot be added while the harvesting thread reads them.
+	if (_running) {
+		return -1;
+	}
+
+	_harvesters.push_back(std::make_pair(harvester, period ? period : 1));
+
+	return static_cast<int>(_harvesters.size() - 1);
+}
+
+// --------
+// addEvent
+// --------
+
+/**
+ * @brief Adds entropic bytes from a source to the pools; events are
+ *        distributed over the pools in round-robin order per source.
+ *
+ * @param sourceId uint8_t with the source identifier.
+ * @param data const pointer to entropic bytes.
+ * @param length size_t with number of entropic bytes.
+ *
+ * @return void
+ */
+void EntropyAccumulator::addEvent(
+	uint8_t sourceId,
+	const uint8_t* data,
+	size_t length
+) {
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	// Track next pool for a source seen for the first time.
+	if (_nextPool.size() <= sourceId) {
+		_nextPool.resize(sourceId + 1, 0);
+	}
+
+	// Split data into events of at most MAXEVENTSIZE bytes.
+	while (length > 0) {
+		size_t eventSize = (length < EntropyAccumulator::MAXEVENTSIZE)
+			? length : EntropyAccumulator::MAXEVENTSIZE;
+		size_t pool = _nextPool[sourceId];
+
+		// Prefix event with source id and size to separate events.
+		uint8_t header[2] = {sourceId, static_cast<uint8_t>(eventSize)};
+		_pools[pool].Update(header, sizeof(header));
+		_pools[pool].Update(data, eventSize);
+		_poolSizes[pool] += eventSize;
+
+		// Next event from this source goes to the next pool.
+		_nextPool[sourceId] = (pool + 1) % EntropyAccumulator::NUMPOOLS;
+
+		data += eventSize;
+		length -= eventSize;
+	}
+}
+
+// -----
+// start
+// -----
+
+/**
+ * @brief Starts harvesting registered sources on a background thread.
+ *
+ * @param interval milliseconds between harvests (default 100ms).
+ *
+ * @return true, if harvesting was started.
+ */
+bool EntropyAccumulator::start(std::chrono::milliseconds interval) {
+	std::lock_guard<std::mutex> lock(_runMutex);
+
+	// Check if harvesting is already running or there is nothing to harvest.
+	if (_running || _harvesters.empty()) {
+		return false;
+	}
+
+	_running = true;
+	_thread = std::thread(&EntropyAccumulator::harvest, this, interval);
+
+	return true;
+}
+
+// ----
+// stop
+// ----
+
+/**
+ * @brief Stops background harvesting and joins the harvesting thread.
+ *
+ * @return void
+ */
+void EntropyAccumulator::stop() {
+	{
+		std::lock_guard<std::mutex> lock(_runMutex);
+		_running = false;
+	}
+
+	// Wake harvesting thread and wait for it to finish.
+	_stopSignal.notify_all();
+
+	if (_thread.joinable()) {
+		_thread.join();
+	}
+}
+
+// ----
+// draw
+// ----
+
+/**
+ * @brief Reseeds from pools 0..j if pool 0 holds enough data (pool j is
+ *        used on every 2^j-th reseed) and writes length bytes derived
+ *        from the reseeded generator key.
+ *
+ * @param output pointer to memory to hold length bytes.
+ * @param length size_t with number of bytes required.
+ *
+ * @return true, if output was written; false if no reseed has ever
+ *         been possible.
+ */
+bool EntropyAccumulator::draw(uint8_t* output, size_t length) {
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	auto now = std::chrono::steady_clock::now();
+	auto minInterval = std::chrono::milliseconds(
+		static_cast<long>(EntropyAccumulator::MINRESEEDINTERVALMS)
+	);
+
+	// Reseed if pool 0 is full enough and reseeds are not too frequent.
+	if (_poolSizes[0] >= EntropyAccumulator::MINPOOLSIZE
+		&& (_reseedCount == 0 || now - _lastReseed >= minInterval)) {
+		reseed();
+		_lastReseed = now;
+	}
+
+	// Generator key is not yet keyed with entropy.
+	if (_reseedCount == 0) {
+		return false;
+	}
+
+	/* Replace key before producing output so that output does not reveal
+	 * the key used for later draws.
+	 */
+	Shake256 generator;
+	generator.Update(_key.data(), _key.size());
+	generator.Squeeze(_key.data(), _key.size());
+	generator.Squeeze(output, length);
+
+	return true;
+}
+
+// -----------
+// reseedCount
+// -----------
+
+/**
+ * @brief Returns number of reseeds performed.
+ *
+ * @return size_t with the reseed count.
+ */
+size_t EntropyAccumulator::reseedCount() {
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _reseedCount;
+}
+
+// -------
+// harvest
+// -------
+
+/**
+ * @brief Background thread loop invoking registered harvesters.
+ *
+ * @param interval milliseconds between harvests.
+ *
+ * @return void
+ */
+void EntropyAccumulator::harvest(std::chrono::milliseconds interval) {
+	std::vector<uint8_t> data;
+	size_t tick = 0;
+
+	std::unique_lock<std::mutex> lock(_runMutex);
+
+	while (_running) {
+		lock.unlock();
+
+		// Invoke harvesters due on this tick and feed their data as events.
+		for (size_t i = 0; i < _harvesters.size(); ++i) {
+			if (tick % _harvesters[i].second != 0) {
+				continue;
+			}
+
+			data.clear();
+
+			if (_harvesters[i].first(data)) {
+				addEvent(static_cast<uint8_t>(i), data.data(), data.size());
+			}
+		}
+
+		++tick;
+
+		// Sleep until next interval or until stop is requested.
+		lock.lock();
+		_stopSignal.wait_for(lock, interval, [this] () { return !_running; });
+	}
+}
+
+// ------
+// reseed
+// ------
+
+/**
+ * @brief Folds pools 0..j into the generator key. Caller holds _mutex.
+ *
+ * @return void
+ */
+void EntropyAccumulator::reseed() {
+	++_reseedCount;
+
+	Shake256 keyState;
+	keyState.Update(_key.data(), _key.size());
+
+	// Pool j contributes on every 2^j-th reseed.
+	for (size_t j = 0; j < EntropyAccumulator::NUMPOOLS; ++j) {
+		if (j > 0 && (_reseedCount % (size_t(1) << j)) != 0) {
+			break;
+		}
+
+		// Fold pool digest into the key and empty the pool.
+		std::array<uint8_t, EntropyAccumulator::KEYSIZE> digest;
+		_pools[j].Squeeze(digest.data(), digest.size());
+		_pools[j].Restart();
+		_poolSizes[j] = 0;
+
+		keyState.Update(digest.data(), digest.size());
+	}
+
+	keyState.Squeeze(_key.data(), _key.size());
+}
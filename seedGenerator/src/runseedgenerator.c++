@@ -0,0 +1,449 @@
+/** @file runseedgenerator.c++
+ *  @brief Tests for the SeedGenerator and Shake256 classes.
+ *
+ *  @author Aashish Sheshadri
+ *  @author Rohit Harchandani
+ *
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2015, 2016, 2017 PayPal
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+// -----------------
+// standard includes
+// -----------------
+#include <cassert>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include <memory>
+
+// ----------------
+// library includes
+// ----------------
+#include "seedGenerator.h"
+#include "shake256.h"
+#include "entropyAccumulator.h"
+
+// ------------
+// StaticSource
+// ------------
+
+/**
+ * @class StaticSource RandomSource serving pseudo random bytes to exercise
+ *        the seed generator without access to entropic devices. A mask
+ *        other than 0xFF keeps only some bits to serve low entropy bytes.
+ */
+class StaticSource: public RandomSource {
+public:
+
+	StaticSource(size_t numBytes, uint32_t seed, uint8_t mask = 0xFF):
+		_data(numBytes) {
+		std::mt19937 generator(seed);
+		std::generate(_data.begin(), _data.end(), [&generator, mask] () {
+			return static_cast<uint8_t>(generator() & mask);
+		});
+	}
+
+	void appendData(std::vector<uint8_t>& data) {
+		data.insert(data.end(), _data.begin(), _data.end());
+	}
+
+	std::vector<double> bitEntropy() {
+		return std::vector<double>(8, 0.5);
+	}
+
+private:
+	std::vector<uint8_t> _data;
+};
+
+// -----------------
+// shakeKnownAnswer
+// -----------------
+
+/**
+ * @brief Compare SHAKE256 output on the empty string with the FIPS 202
+ *        known answer.
+ *
+ * @return true, if test passed.
+ */
+int shakeKnownAnswer() {
+	std::cerr << "**Running test shakeKnownAnswer**" << std::endl;
+
+	const uint8_t expected[] = {
+		0x46, 0xb9, 0xdd, 0x2b, 0x0b, 0xa8, 0x8d, 0x13,
+		0x23, 0x3b, 0x3f, 0xeb, 0x74, 0x3e, 0xeb, 0x24,
+		0x3f, 0xcd, 0x52, 0xea, 0x62, 0xb8, 0x1b, 0x82,
+		0xb5, 0x0c, 0x27, 0x64, 0x6e, 0xd5, 0x76, 0x2f
+	};
+
+	Shake256 xof;
+	uint8_t output[sizeof(expected)];
+
+	// Squeeze in two parts to check output continuation.
+	xof.Squeeze(output, 5);
+	xof.Squeeze(output + 5, sizeof(expected) - 5);
+
+	bool retVal = std::equal(output, output + sizeof(expected), expected);
+
+	if (!retVal) {
+		std::cerr << "!!Failed shakeKnownAnswer test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return retVal;
+}
+
+// ------------
+// xofSeedValid
+// ------------
+
+/**
+ * @brief Generate a seed longer than 16 SHA3-512 hashes can fill in XOF mode.
+ *
+ * @return true, if test passed.
+ */
+int xofSeedValid() {
+	std::cerr << "**Running test xofSeedValid**" << std::endl;
+
+	SeedGenerator seedGenerator(16, SeedGenerator::MODE::XOF);
+	StaticSource source(1024*1024, 1);
+
+	bool retVal = seedGenerator.processFromSource(&source);
+
+	// 1000 terms do not divide evenly into 64 byte hashes.
+	std::vector<uint32_t> seed(1000, 0);
+	SeedGenerator::EntropyReport report = seedGenerator.generateSeed();
+	seedGenerator.copySeed(seed.data(), seed.size());
+
+	// All data must be reported as absorbed over 16 passing splits.
+	retVal = retVal && (report.sources.size() == 1);
+	retVal = retVal && (report.bytesAbsorbed == 1024*1024);
+	retVal = retVal && (report.sources[0].splitPassed.size() == 16);
+	retVal = retVal && (report.creditedBits > 0);
+
+	// Tail of the seed must have been written.
+	retVal = retVal && (std::count(seed.end() - 16, seed.end(), 0) < 16);
+
+	if (!retVal) {
+		std::cerr << "!!Failed xofSeedValid test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return retVal;
+}
+
+// ------------------
+// xofSeedNotReady
+// ------------------
+
+/**
+ * @brief Attempt to copy a seed before it was generated.
+ *
+ * @return true, if test passed.
+ */
+int xofSeedNotReady() {
+	std::cerr << "**Running test xofSeedNotReady**" << std::endl;
+
+	SeedGenerator seedGenerator(16, SeedGenerator::MODE::XOF);
+	StaticSource source(1024, 2);
+
+	seedGenerator.processFromSource(&source);
+
+	// Attempt to copy a seed without calling generateSeed.
+	std::vector<uint32_t> seed(256, 0);
+	seedGenerator.copySeed(seed.data(), seed.size());
+
+	bool retVal = (std::count(seed.begin(), seed.end(), 0) == 256);
+
+	if (!retVal) {
+		std::cerr << "!!Failed xofSeedNotReady test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return retVal;
+}
+
+// ---------------
+// xofSeedsIndexed
+// ---------------
+
+/**
+ * @brief Derive several seeds from one pool; seeds must be distinct and
+ *        reproducible from the same data.
+ *
+ * @return true, if test passed.
+ */
+int xofSeedsIndexed() {
+	std::cerr << "**Running test xofSeedsIndexed**" << std::endl;
+
+	const size_t len = 256;
+	const size_t count = 4;
+
+	std::vector<uint32_t> seeds(len * count, 0);
+	std::vector<uint32_t> again(len * count, 0);
+
+	// Derive seeds twice from generators fed identical data.
+	SeedGenerator seedGenerator(16, SeedGenerator::MODE::XOF);
+	StaticSource source(1024*1024, 3);
+	bool retVal = seedGenerator.processFromSource(&source);
+	seedGenerator.generateSeed();
+	seedGenerator.copySeeds(seeds.data(), len, count);
+
+	SeedGenerator otherGenerator(16, SeedGenerator::MODE::XOF);
+	retVal = retVal && otherGenerator.processFromSource(&source);
+	otherGenerator.generateSeed();
+	otherGenerator.copySeeds(again.data(), len, count);
+
+	retVal = retVal && (seeds == again);
+
+	// Seeds of different indices must differ.
+	for (size_t i = 0; i < count; ++i) {
+		for (size_t j = i + 1; j < count; ++j) {
+			retVal = retVal && !std::equal(
+				seeds.begin() + i * len,
+				seeds.begin() + (i + 1) * len,
+				seeds.begin() + j * len
+			);
+		}
+	}
+
+	// State is reset; no further seeds can be derived.
+	std::vector<uint32_t> stale(len, 0);
+	seedGenerator.copySeeds(stale.data(), len, 1);
+	retVal = retVal && (std::count(stale.begin(), stale.end(), 0) == len);
+
+	if (!retVal) {
+		std::cerr << "!!Failed xofSeedsIndexed test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return retVal;
+}
+
+// -------------------
+// mixFromSourceCredit
+// -------------------
+
+/**
+ * @brief Mix data with a fixed credit; the credit must be reported as given,
+ *        capped at 8 bits per byte, and later sources must still be processed.
+ *
+ * @return true, if test passed.
+ */
+int mixFromSourceCredit() {
+	std::cerr << "**Running test mixFromSourceCredit**" << std::endl;
+
+	SeedGenerator seedGenerator(16, SeedGenerator::MODE::XOF);
+	StaticSource state(4096, 3);
+	StaticSource tiny(2, 4);
+	StaticSource bulk(1024*1024, 5);
+
+	bool retVal = seedGenerator.mixFromSource(&state, 8.0, "state");
+	retVal = retVal && seedGenerator.mixFromSource(&tiny, 100.0, "tiny");
+	retVal = retVal && seedGenerator.processFromSource(&bulk, "bulk");
+
+	SeedGenerator::EntropyReport report = seedGenerator.generateSeed();
+
+	retVal = retVal && (report.sources.size() == 3);
+	retVal = retVal && (report.bytesAbsorbed == 4096 + 2 + 1024*1024);
+	retVal = retVal && (report.sources[0].creditedBits == 8.0);
+	retVal = retVal && (report.sources[1].creditedBits == 16.0);
+	retVal = retVal && report.sources[2].accepted;
+
+	if (!retVal) {
+		std::cerr << "!!Failed mixFromSourceCredit test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return retVal;
+}
+
+// --------------------
+// rejectedSourceReport
+// --------------------
+
+/**
+ * @brief Offer a low entropy source and an empty source ahead of a good
+ *        one; both must be reported as rejected with nothing credited,
+ *        and the low entropy source with its failed splits.
+ *
+ * @return true, if test passed.
+ */
+int rejectedSourceReport() {
+	std::cerr << "**Running test rejectedSourceReport**" << std::endl;
+
+	SeedGenerator seedGenerator(16, SeedGenerator::MODE::XOF);
+	StaticSource low(1024*1024, 6, 0x01);
+	StaticSource empty(0, 7);
+	StaticSource bulk(1024*1024, 8);
+
+	bool retVal = !seedGenerator.processFromSource(&low, "low");
+	retVal = retVal && !seedGenerator.mixFromSource(&empty, 8.0, "empty");
+	retVal = retVal && seedGenerator.processFromSource(&bulk, "bulk");
+
+	SeedGenerator::EntropyReport report = seedGenerator.generateSeed();
+
+	retVal = retVal && (report.sources.size() == 3);
+
+	// Low entropy bytes fail every split and are not absorbed.
+	const SeedGenerator::SourceReport& lowReport = report.sources[0];
+	retVal = retVal && !lowReport.accepted;
+	retVal = retVal && (lowReport.creditedBits == 0.0);
+	retVal = retVal && (lowReport.bytesAbsorbed == 0);
+	retVal = retVal && (lowReport.splitPassed.size() == 16);
+	retVal = retVal && (std::count(
+		lowReport.splitPassed.begin(),
+		lowReport.splitPassed.end(),
+		false
+	) == 16);
+
+	// Nothing to mix.
+	const SeedGenerator::SourceReport& emptyReport = report.sources[1];
+	retVal = retVal && !emptyReport.accepted;
+	retVal = retVal && (emptyReport.creditedBits == 0.0);
+	retVal = retVal && (emptyReport.bytesAbsorbed == 0);
+
+	// Totals hold the accepted source only.
+	retVal = retVal && report.sources[2].accepted;
+	retVal = retVal && (report.bytesAbsorbed == 1024*1024);
+	retVal = retVal && (report.creditedBits == report.sources[2].creditedBits);
+
+	if (!retVal) {
+		std::cerr << "!!Failed rejectedSourceReport test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return retVal;
+}
+
+// ---------------
+// accumulatorDraw
+// ---------------
+
+/**
+ * @brief Attempt to draw from the accumulator before and after pool 0 holds
+ *        enough events.
+ *
+ * @return true, if test passed.
+ */
+int accumulatorDraw() {
+	std::cerr << "**Running test accumulatorDraw**" << std::endl;
+
+	EntropyAccumulator accumulator;
+	std::vector<uint8_t> output(64, 0);
+
+	// Draw must fail before any entropy was accumulated.
+	bool retVal = !accumulator.draw(output.data(), output.size());
+
+	// Events are spread round-robin; feed pool 0 with MINPOOLSIZE bytes.
+	std::vector<uint8_t> events(
+		EntropyAccumulator::NUMPOOLS * EntropyAccumulator::MINPOOLSIZE, 0
+	);
+	std::mt19937 generator(3);
+	std::generate(events.begin(), events.end(), [&generator] () {
+		return static_cast<uint8_t>(generator());
+	});
+	accumulator.addEvent(0, events.data(), events.size());
+
+	retVal = retVal && accumulator.draw(output.data(), output.size());
+	retVal = retVal && (accumulator.reseedCount() == 1);
+	retVal = retVal && (std::count(output.begin(), output.end(), 0) < 8);
+
+	if (!retVal) {
+		std::cerr << "!!Failed accumulatorDraw test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return retVal;
+}
+
+// ------------------
+// accumulatorHarvest
+// ------------------
+
+/**
+ * @brief Harvest a source on the background thread until a seed can be drawn.
+ *
+ * @return true, if test passed.
+ */
+int accumulatorHarvest() {
+	std::cerr << "**Running test accumulatorHarvest**" << std::endl;
+
+	EntropyAccumulator accumulator;
+	auto source = std::make_shared<StaticSource>(32, 4);
+
+	accumulator.addHarvester([source] (std::vector<uint8_t>& data) {
+		source->appendData(data);
+		return true;
+	});
+
+	bool retVal = accumulator.start(std::chrono::milliseconds(1));
+
+	// Wait (bounded) for pool 0 to fill and draw a seed.
+	uint32_t seed[256];
+	bool drawn = false;
+	for (int i = 0; i < 1000 && !drawn; ++i) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		drawn = accumulator.copySeed(seed, 256);
+	}
+
+	accumulator.stop();
+	retVal = retVal && drawn;
+
+	if (!retVal) {
+		std::cerr << "!!Failed accumulatorHarvest test!!" << std::endl;
+	} else {
+		std::cerr << "--Passed--" << std::endl;
+	}
+
+	return retVal;
+}
+
+int main() {
+	/* Run tests and count passed.
+	 * Order matters.
+	 */
+	int passed = 0;
+	passed += shakeKnownAnswer();
+	passed += xofSeedValid();
+	passed += xofSeedNotReady();
+	passed += xofSeedsIndexed();
+	passed += mixFromSourceCredit();
+	passed += rejectedSourceReport();
+	passed += accumulatorDraw();
+	passed += accumulatorHarvest();
+
+	std::cerr << std::endl;
+	std::cerr << "--Passed " << passed << "/8" << " tests--" << std::endl;
+
+	// Assert passing all tests.
+	assert(passed == 8);
+
+	return 0;
+}
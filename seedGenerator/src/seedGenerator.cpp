@@ -31,6 +31,9 @@
 // standard includes
 // -----------------
 #include <numeric>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 
 // ----------------
 // library includes
@@ -71,12 +74,15 @@ const double SeedGenerator::byteBitProbs[] =
  * Constructor
  * @brief Creates SeedGenerator object and initilizes internal properties.
  * @param numDivs int indicating number of independent hashes to compute
- *        on data.
+ *        on data. In XOF mode, number of splits the entropy estimate is
+ *        checked over; data is absorbed into a single SHAKE256 state.
+ * @param mode MODE with conditioning mode (default SPLIT).
  */
-SeedGenerator::SeedGenerator(int numDivs):
+SeedGenerator::SeedGenerator(int numDivs, MODE mode):
 	_numDivs(numDivs),
-	_hashVec(numDivs),
-	_digests(numDivs),
+	_mode(mode),
+	_hashVec(mode == MODE::SPLIT ? numDivs : 0),
+	_digests(mode == MODE::SPLIT ? numDivs : 0),
 	_seedReady(false) {
 
 }
@@ -87,64 +93,225 @@ SeedGenerator::SeedGenerator(int numDivs):
 
 /**
  * @brief Computes rolling hash on entropic data from a randomSource if data
- *        meets threshold on entropy estimate.
+ *        meets threshold on entropy estimate. Statistics are recorded in
+ *        the entropy report.
  *
  * @param randomSource pointer to a RandomSource.
+ * @param label const reference to a string naming the source in the
+ *        entropy report (default empty).
  *
  * @return true, if data was entropic enough to be processed.
  */
-bool SeedGenerator::processFromSource(RandomSource* randomSource) {
+bool SeedGenerator::processFromSource(
+	RandomSource* randomSource,
+	const std::string& label
+) {
 
 	// Check if seed can already been computed.
 	if (_seedReady) {
 		return false; // Cannot process data until seed is flushed or reset.
 	}
 
+	SourceReport sourceReport;
+	sourceReport.label = label;
+	sourceReport.accepted = false;
+	sourceReport.bytesAbsorbed = 0;
+	sourceReport.bitMinEntropy = 0.0;
+	sourceReport.byteMinEntropy = 0.0;
+	sourceReport.creditedBits = 0.0;
+
+	auto estimatorStart = std::chrono::steady_clock::now();
+
 	// Compute avg. bit occurrence in a sample from randomSource.
 	std::vector<double> sampleAvgVec = randomSource->bitEntropy();
 	double sum = std::accumulate(sampleAvgVec.begin(),sampleAvgVec.end(),0.0f);
 	double avgSampleEntropy = sum/static_cast<double>(sampleAvgVec.size());
 
+	/* Min-entropy per sample from bit occurrence probabilities (bits taken as
+	 * independent), scaled to a byte.
+	 */
+	for (auto it = sampleAvgVec.begin(); it != sampleAvgVec.end(); ++it) {
+		double maxProb = std::max(*it, 1.0 - *it);
+
+		if (maxProb > 0.0 && maxProb < 1.0) {
+			sourceReport.bitMinEntropy -= std::log2(maxProb);
+		}
+	}
+
+	if (!sampleAvgVec.empty()) {
+		sourceReport.bitMinEntropy *= 8.0 / sampleAvgVec.size();
+	}
+
+	sourceReport.bitProbability = avgSampleEntropy;
+	sourceReport.estimatorSeconds = std::chrono::duration<double>(
+		std::chrono::steady_clock::now() - estimatorStart
+	).count();
+
 	// Check if estimate meets threshold.
 	if (avgSampleEntropy < SeedGenerator::ENTROPYTHRESHOLD) {
 		// Data not good enough.
 		std::cerr << "[Entropy Error] Sample entropy estimate low" << std::endl;
+		_report.sources.push_back(sourceReport);
 		return false;
 	}
 
-	// Load bytes from randomsource into randomData.
+	// Take over bytes from randomsource into randomData without a copy.
 	std::vector<uint8_t> randomData;
-	randomSource->appendData(randomData);
+	randomSource->moveData(randomData);
 
 	// Split random bytes into _numDivs to compute _numDivs hashes.
 	auto it = randomData.data();
 	int stepSize = randomData.size() / _numDivs;
 	int excess = randomData.size() % _numDivs;
 
+	std::array<size_t, 256> byteCounts; // Byte occurrences over all batches.
+	byteCounts.fill(0);
+	bool passed = true;
+
 	// Loop through batches of data.
-	for (int i = 0; i < (_numDivs - 1); ++i) {
+	for (int i = 0; i < _numDivs; ++i) {
+		int batchSize = (i == _numDivs - 1) ? stepSize + excess : stepSize;
+
 		/* Compute avg. bit occurrence in a byte for this batch and check if
 		 * it meets the threshold.
 		 */
-		if (!entropy(it, it + stepSize)) {
-			// Data not good enough
-			std::cerr << "[Error] Byte entropy estimate low" << std::endl;
-			return false;
-		}
+		estimatorStart = std::chrono::steady_clock::now();
+		bool batchPassed = entropy(it, it + batchSize, byteCounts);
+		sourceReport.estimatorSeconds += std::chrono::duration<double>(
+			std::chrono::steady_clock::now() - estimatorStart
+		).count();
+
+		sourceReport.splitPassed.push_back(batchPassed);
+		passed = passed && batchPassed;
 
 		// Compute rolling hash for this batch.
-		_hashVec[i].Update(it, stepSize);
+		if (passed && _mode == MODE::SPLIT) {
+			_hashVec[i].Update(it, batchSize);
+			sourceReport.bytesAbsorbed += batchSize;
+		}
 
-		it = it + stepSize;
+		it = it + batchSize;
 	}
 
-	// Final batch
-	if (!entropy(it, it + stepSize + excess)) {
+	if (!passed) {
 		// Data not good enough
 		std::cerr << "[Error] Byte entropy estimate low" << std::endl;
+		_report.bytesAbsorbed += sourceReport.bytesAbsorbed; // Partial batches.
+		_report.sources.push_back(sourceReport);
 		return false;
 	}
-	_hashVec[_numDivs-1].Update(it, stepSize + excess);
+
+	if (_mode == MODE::XOF) {
+		// Absorb all batches into the XOF in a single pass.
+		_xof.Update(randomData.data(), randomData.size());
+		sourceReport.bytesAbsorbed = randomData.size();
+	}
+
+	// Min-entropy per byte from the most common byte value.
+	size_t maxCount = *std::max_element(byteCounts.begin(), byteCounts.end());
+
+	if (maxCount > 0) {
+		sourceReport.byteMinEntropy = -std::log2(
+			static_cast<double>(maxCount) / randomData.size()
+		);
+	}
+
+	// Credit the lower of the two estimates.
+	sourceReport.accepted = true;
+	sourceReport.creditedBits = sourceReport.bytesAbsorbed * std::min(
+		sourceReport.bitMinEntropy,
+		sourceReport.byteMinEntropy
+	);
+
+	_report.bytesAbsorbed += sourceReport.bytesAbsorbed;
+	_report.creditedBits += sourceReport.creditedBits;
+	_report.sources.push_back(sourceReport);
+
+	return true;
+}
+
+// -------------
+// mixFromSource
+// -------------
+
+/**
+ * @brief Hashes data from a randomSource without the entropy estimators,
+ *        crediting a fixed number of bits chosen by the caller. Meant for
+ *        structured state (clocks, counters, addresses) the estimators
+ *        cannot judge. Statistics are recorded in the entropy report.
+ *
+ * @param randomSource pointer to a RandomSource.
+ * @param creditedBits double with min-entropy to credit, capped at 8
+ *        bits per byte of data.
+ * @param label const reference to a string naming the source in the
+ *        entropy report (default empty).
+ *
+ * @return true, if data was available to be processed.
+ */
+bool SeedGenerator::mixFromSource(
+	RandomSource* randomSource,
+	double creditedBits,
+	const std::string& label
+) {
+
+	// Check if seed can already been computed.
+	if (_seedReady) {
+		return false; // Cannot process data until seed is flushed or reset.
+	}
+
+	SourceReport sourceReport;
+	sourceReport.label = label;
+	sourceReport.accepted = false;
+	sourceReport.bytesAbsorbed = 0;
+	sourceReport.bitMinEntropy = 0.0;
+	sourceReport.byteMinEntropy = 0.0;
+	sourceReport.creditedBits = 0.0;
+	sourceReport.estimatorSeconds = 0.0;
+
+	// Avg. bit occurrence is recorded for the report only.
+	std::vector<double> sampleAvgVec = randomSource->bitEntropy();
+	double sum = std::accumulate(sampleAvgVec.begin(),sampleAvgVec.end(),0.0f);
+	sourceReport.bitProbability = sampleAvgVec.empty()
+		? 0.0
+		: sum / static_cast<double>(sampleAvgVec.size());
+
+	// Take over bytes from randomsource into randomData without a copy.
+	std::vector<uint8_t> randomData;
+	randomSource->moveData(randomData);
+
+	if (randomData.empty()) {
+		std::cerr << "[Error] No data to mix" << std::endl;
+		_report.sources.push_back(sourceReport);
+		return false;
+	}
+
+	if (_mode == MODE::XOF) {
+		// Absorb all bytes into the XOF in a single pass.
+		_xof.Update(randomData.data(), randomData.size());
+	} else {
+		// Split random bytes into _numDivs rolling hashes.
+		auto it = randomData.data();
+		int stepSize = randomData.size() / _numDivs;
+		int excess = randomData.size() % _numDivs;
+
+		for (int i = 0; i < _numDivs; ++i) {
+			int batchSize = (i == _numDivs - 1) ? stepSize + excess : stepSize;
+			_hashVec[i].Update(it, batchSize);
+			it = it + batchSize;
+		}
+	}
+
+	// Credit the caller's estimate, never more than the data can hold.
+	sourceReport.accepted = true;
+	sourceReport.bytesAbsorbed = randomData.size();
+	sourceReport.creditedBits = std::max(0.0, std::min(
+		creditedBits,
+		8.0 * randomData.size()
+	));
+
+	_report.bytesAbsorbed += sourceReport.bytesAbsorbed;
+	_report.creditedBits += sourceReport.creditedBits;
+	_report.sources.push_back(sourceReport);
 
 	return true;
 }
@@ -158,17 +325,17 @@ bool SeedGenerator::processFromSource(RandomSource* randomSource) {
  *        data after this invocation, unless seed is copied or resetState
  *        is invoked.
  *
- * @return void
+ * @return EntropyReport with statistics of sources processed for the seed.
  */
-void SeedGenerator::generateSeed() {
+SeedGenerator::EntropyReport SeedGenerator::generateSeed() {
 
 	// Check if seed bytes have already been generated.
 	if (_seedReady) {
-		return; // Seed bytes available.
+		return _report; // Seed bytes available.
 	}
 
 	/* Loop through rolling hashes to generate final hashes and load them into
-	 * _digests.
+	 * _digests. In XOF mode seed bytes are squeezed on copySeed.
 	 */
 	auto itD = _digests.begin();
 
@@ -181,6 +348,8 @@ void SeedGenerator::generateSeed() {
 	}
 
 	_seedReady = true;
+
+	return _report;
 }
 
 // ----------
@@ -197,6 +366,10 @@ void SeedGenerator::resetState() {
 	if (_seedReady) {
 		// Discard seed.
 		_seedReady = false;
+
+		// Discard conditioning state and statistics.
+		_xof.Restart();
+		_report = EntropyReport();
 	}
 }
 
@@ -0,0 +1,236 @@
+/** @file shake256.cpp
+ *  @brief Definition of the class functions in shake256.h
+ *
+ *  @author Aashish Sheshadri
+ *  @author Rohit Harchandani
+ *
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2015, 2016, 2017 PayPal
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+// ----------------
+// library includes
+// ----------------
+#include "shake256.h"
+
+namespace {
+
+// Keccak-f[1600] round constants.
+const uint64_t ROUNDCONSTANTS[24] = {
+	0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808AULL,
+	0x8000000080008000ULL, 0x000000000000808BULL, 0x0000000080000001ULL,
+	0x8000000080008081ULL, 0x8000000000008009ULL, 0x000000000000008AULL,
+	0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000AULL,
+	0x000000008000808BULL, 0x800000000000008BULL, 0x8000000000008089ULL,
+	0x8000000000008003ULL, 0x8000000000008002ULL, 0x8000000000000080ULL,
+	0x000000000000800AULL, 0x800000008000000AULL, 0x8000000080008081ULL,
+	0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL
+};
+
+// Rotation offsets (rho) in the order lanes are visited by pi.
+const unsigned ROTATIONS[24] = {
+	1, 3, 6, 10, 15, 21, 28, 36, 45, 55, 2, 14,
+	27, 41, 56, 8, 25, 43, 62, 18, 39, 61, 20, 44
+};
+
+// Lane visiting order (pi).
+const unsigned PILANES[24] = {
+	10, 7, 11, 17, 18, 3, 5, 16, 8, 21, 24, 4,
+	15, 23, 19, 13, 12, 2, 20, 14, 22, 9, 6, 1
+};
+
+inline uint64_t rotl(uint64_t val, unsigned shift) {
+	return (val << shift) | (val >> (64 - shift));
+}
+
+}
+
+// -----------
+// Constructor
+// -----------
+
+/**
+ * Constructor
+ * @brief Creates Shake256 object with an empty sponge state.
+ */
+Shake256::Shake256() {
+	Restart();
+}
+
+// ------
+// Update
+// ------
+
+/**
+ * @brief Absorbs length bytes into the sponge. Has no effect once
+ *        squeezing has begun, unless Restart is invoked.
+ *
+ * @param input const pointer to the bytes to be absorbed.
+ * @param length size_t with number of bytes to absorb.
+ *
+ * @return void
+ */
+void Shake256::Update(const uint8_t* input, size_t length) {
+
+	// Cannot absorb once output has been squeezed.
+	if (_squeezing) {
+		return;
+	}
+
+	// Absorb full lanes directly when aligned to a lane boundary.
+	while (length > 0) {
+		if ((_position % 8) == 0 && length >= 8 && _position + 8 <= RATE) {
+			uint64_t lane = 0;
+
+			// Load lane as little endian.
+			for (int i = 7; i >= 0; --i) {
+				lane = (lane << 8) | input[i];
+			}
+
+			_state[_position / 8] ^= lane;
+			_position += 8;
+			input += 8;
+			length -= 8;
+		} else {
+			// XOR single byte into its lane.
+			_state[_position / 8] ^=
+				static_cast<uint64_t>(*input) << (8 * (_position % 8));
+			++_position;
+			++input;
+			--length;
+		}
+
+		// Permute once the rate portion is full.
+		if (_position == RATE) {
+			permute();
+			_position = 0;
+		}
+	}
+}
+
+// -------
+// Squeeze
+// -------
+
+/**
+ * @brief Pads the absorbed stream (on first invocation) and writes length
+ *        output bytes. Successive calls continue the output stream.
+ *
+ * @param output pointer to memory to hold length bytes.
+ * @param length size_t with number of bytes to squeeze.
+ *
+ * @return void
+ */
+void Shake256::Squeeze(uint8_t* output, size_t length) {
+
+	// Pad absorbed stream with SHAKE domain bits and switch to squeezing.
+	if (!_squeezing) {
+		_state[_position / 8] ^= uint64_t(0x1F) << (8 * (_position % 8));
+		_state[(RATE - 1) / 8] ^= uint64_t(0x80) << (8 * ((RATE - 1) % 8));
+		permute();
+		_position = 0;
+		_squeezing = true;
+	}
+
+	// Read output bytes from the rate portion, permuting as it is exhausted.
+	while (length > 0) {
+		if (_position == RATE) {
+			permute();
+			_position = 0;
+		}
+
+		*output = static_cast<uint8_t>(
+			_state[_position / 8] >> (8 * (_position % 8))
+		);
+		++_position;
+		++output;
+		--length;
+	}
+}
+
+// -------
+// Restart
+// -------
+
+/**
+ * @brief Resets the sponge to its initial (empty) state.
+ *
+ * @return void
+ */
+void Shake256::Restart() {
+	_state.fill(0);
+	_position = 0;
+	_squeezing = false;
+}
+
+// -------
+// permute
+// -------
+
+/**
+ * @brief Applies the Keccak-f[1600] permutation to the sponge state.
+ *
+ * @return void
+ */
+void Shake256::permute() {
+	uint64_t c[5];
+
+	for (int round = 0; round < 24; ++round) {
+
+		// Theta
+		for (int x = 0; x < 5; ++x) {
+			c[x] = _state[x] ^ _state[x + 5] ^ _state[x + 10]
+				^ _state[x + 15] ^ _state[x + 20];
+		}
+
+		for (int x = 0; x < 5; ++x) {
+			uint64_t d = c[(x + 4) % 5] ^ rotl(c[(x + 1) % 5], 1);
+
+			for (int y = 0; y < 25; y += 5) {
+				_state[y + x] ^= d;
+			}
+		}
+
+		// Rho and pi
+		uint64_t current = _state[1];
+
+		for (int i = 0; i < 24; ++i) {
+			uint64_t temp = _state[PILANES[i]];
+			_state[PILANES[i]] = rotl(current, ROTATIONS[i]);
+			current = temp;
+		}
+
+		// Chi
+		for (int y = 0; y < 25; y += 5) {
+			for (int x = 0; x < 5; ++x) {
+				c[x] = _state[y + x];
+			}
+
+			for (int x = 0; x < 5; ++x) {
+				_state[y + x] = c[x] ^ ((~c[(x + 1) % 5]) & c[(x + 2) % 5]);
+			}
+		}
+
+		// Iota
+		_state[0] ^= ROUNDCONSTANTS[round];
+	}
+}